@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/handler.hpp>
+
+#include <asio/co_spawn.hpp>
+#include <asio/detached.hpp>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#include <asio/use_awaitable.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<std::size_t> allocations{0u};
+
+void* operator new(std::size_t n)
+{
+    allocations++;
+    if (auto p = std::malloc(n))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept { std::free(p); }
+void operator delete(void * p, std::size_t) noexcept { std::free(p); }
+
+constexpr std::size_t iterations = 1'000'000u;
+
+struct result
+{
+    const char * name;
+    std::chrono::nanoseconds duration;
+    std::size_t allocations;
+
+    void print() const
+    {
+        std::printf("%-24s %8.2f ns/op %8.3f allocations/op\n", name,
+                    static_cast<double>(duration.count()) / iterations,
+                    static_cast<double>(allocations) / iterations);
+    }
+};
+
+// construct, move & invoke a handler_type from a lambda, as an async_read_some would.
+result bench_lambda(asio::io_context & ctx)
+{
+    std::size_t total = 0u;
+    const auto before = allocations.load();
+    const auto start  = std::chrono::steady_clock::now();
+    for (std::size_t i = 0u; i < iterations; i++)
+    {
+        pio::read_handler h{[&total](std::error_code, std::size_t n) { total += n; }, ctx.get_executor()};
+        auto h2 = std::move(h);
+        h2(std::error_code{}, 1u);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return {"lambda", end - start, allocations.load() - before};
+}
+
+// construct & move a handler_type from a use_awaitable completion handler.
+asio::awaitable<void> awaitable_loop(result & res)
+{
+    auto exec = co_await asio::this_coro::executor;
+    for (std::size_t i = 0u; i < iterations; i++)
+        co_await asio::async_initiate<const asio::use_awaitable_t<>&, void(std::error_code, std::size_t)>(
+            [&](auto handler)
+            {
+                const auto before = allocations.load();
+                const auto start  = std::chrono::steady_clock::now();
+                pio::read_handler h{std::move(handler), exec};
+                auto h2 = std::move(h);
+                res.duration += std::chrono::steady_clock::now() - start;
+                res.allocations += allocations.load() - before;
+                asio::post(exec, [h = std::move(h2)]() mutable { h(std::error_code{}, 1u); });
+            }, asio::use_awaitable);
+}
+
+int main(int argc, char * argv[])
+{
+    asio::io_context ctx;
+
+    const auto lambda = bench_lambda(ctx);
+    lambda.print();
+
+    result awaitable{"use_awaitable", {}, 0u};
+    asio::co_spawn(ctx, awaitable_loop(awaitable), asio::detached);
+    ctx.run();
+    awaitable.print();
+
+    return (lambda.allocations == 0u && awaitable.allocations == 0u) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
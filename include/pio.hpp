@@ -9,26 +9,44 @@
 #define PIO_HPP
 
 
+#include <pio/append_log.hpp>
 #include <pio/basic_waitable_timer.hpp>
 #include <pio/buffer.hpp>
+#include <pio/buffer_pool.hpp>
+#include <pio/cached_random_access_device.hpp>
+#include <pio/coalescing_write_stream.hpp>
+#include <pio/completion_condition.hpp>
 #include <pio/concepts.hpp>
 #include <pio/connect_pipe.hpp>
+#include <pio/copy_file.hpp>
 #include <pio/defer.hpp>
+#include <pio/direct_io.hpp>
 #include <pio/dispatch.hpp>
 #include <pio/handler.hpp>
 #include <pio/high_resolution_timer.hpp>
+#include <pio/mapped_file.hpp>
+#include <pio/open_file.hpp>
+#include <pio/parallel_transfer.hpp>
 #include <pio/post.hpp>
+#include <pio/prefetching_read_stream.hpp>
 #include <pio/random_access_file.hpp>
 #include <pio/read.hpp>
 #include <pio/read_at.hpp>
 #include <pio/readable_pipe.hpp>
+#include <pio/recycling_allocator.hpp>
+#include <pio/registered_buffer_pool.hpp>
+#include <pio/ring_buffer.hpp>
+#include <pio/segmented_buffer.hpp>
 #include <pio/serial_port.hpp>
+#include <pio/shared_buffer.hpp>
 #include <pio/signal_set.hpp>
+#include <pio/splice.hpp>
 #include <pio/steady_timer.hpp>
 #include <pio/stream_file.hpp>
 #include <pio/system_timer.hpp>
 #include <pio/writable_pipe.hpp>
 #include <pio/write.hpp>
 #include <pio/write_at.hpp>
+#include <pio/write_queue.hpp>
 
 #endif //PIO_HPP
@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_APPEND_LOG_HPP
+#define PIO_APPEND_LOG_HPP
+
+#include <pio/random_access_file.hpp>
+
+#include <asio/async_result.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <span>
+
+namespace pio
+{
+
+namespace detail
+{
+struct append_log_state;
+}
+
+/// An append-only log with group commit on top of a `random_access_file`.
+/**
+ * Every `async_append` reserves its offset atomically and writes its record right away, i.e. in parallel with
+ * the other appends. It completes with the record's offset once the record is durable.
+ *
+ * Syncs are done with `async_data_sync` and never overlap: a single sync covers all records whose writes completed
+ * while the previous sync was in flight, so the number of syncs doesn't grow with the number of appends.
+ * A record is only reported durable once everything before it is, too.
+ *
+ * A failed write or sync is sticky: all pending and later appends complete with the error.
+ *
+ * `async_append` is thread-safe: the file operations are all initiated on a strand of the file's executor.
+ * The file must not be used otherwise while appends are pending and the log must outlive all appends.
+ */
+struct append_log
+{
+    /// Append to `file` starting at `offset`, usually the size of the file.
+    explicit append_log(random_access_file & file, std::uint64_t offset = 0u);
+    ~append_log();
+
+    append_log(const append_log &) = delete;
+    append_log& operator=(const append_log &) = delete;
+
+    using executor_type = asio::any_io_executor;
+    executor_type get_executor();
+
+    /// The end of the log, including the records in flight.
+    std::uint64_t size() const;
+    /// The end of the log known to be durable.
+    std::uint64_t durable_size() const;
+    /// The number of syncs issued so far.
+    std::uint64_t syncs() const;
+
+    /// Append a record. The buffer needs to stay valid until the operation completes.
+    template<typename CompletionToken>
+    ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, std::uint64_t))
+    async_append(const_buffer buffer, CompletionToken && token)
+    {
+        return asio::async_initiate<CompletionToken, void(std::error_code, std::uint64_t)>(
+                [this](auto handler, const_buffer buffer)
+                {
+                    this->async_append_impl(std::span<const const_buffer>(&buffer, 1u),
+                                            handler_type<void(std::error_code, std::uint64_t)>(std::move(handler), this->get_executor()));
+                }, token, buffer);
+    }
+
+    /// Append a record gathered from multiple buffers. The buffers' data needs to stay valid until the operation completes.
+    template<typename CompletionToken>
+    ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, std::uint64_t))
+    async_append(std::span<const const_buffer> buffers, CompletionToken && token)
+    {
+        return asio::async_initiate<CompletionToken, void(std::error_code, std::uint64_t)>(
+                [this](auto handler, std::span<const const_buffer> buffers)
+                {
+                    this->async_append_impl(buffers,
+                                            handler_type<void(std::error_code, std::uint64_t)>(std::move(handler), this->get_executor()));
+                }, token, buffers);
+    }
+
+  private:
+    // copies the buffer descriptors, not the data.
+    void async_append_impl(std::span<const const_buffer> buffers, handler_type<void(std::error_code, std::uint64_t)> && h);
+
+    std::unique_ptr<detail::append_log_state> state_;
+};
+
+}
+
+#endif //PIO_APPEND_LOG_HPP
@@ -9,7 +9,16 @@
 #define PIO_BUFFER_HPP
 
 #include <asio/buffer.hpp>
+#include <asio/error.hpp>
+#include <asio/detail/throw_error.hpp>
 #include <cassert>
+#include <cstddef>
+#include <new>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 
 namespace pio
@@ -21,100 +30,247 @@ using asio::const_buffer;
 using asio::buffer_sequence_begin;
 using asio::buffer_sequence_end;
 
+/// Copy from `source` to `target`, returns the bytes copied, i.e. the smaller size.
+/**
+ * Large copies pick a kernel for the CPU at runtime: `rep movsb` for mid-sized ones if the CPU has fast string moves,
+ * and non-temporal AVX2 or AVX-512 stores for copies too large to benefit from the cache; everything else uses `memcpy`.
+ * The sequence overloads copy across buffer boundaries, e.g. from or to the `data()` & `prepare()` of a `segmented_buffer`.
+ */
 std::size_t buffer_copy(const mutable_buffer & target, const const_buffer & source) noexcept;
+std::size_t buffer_copy(const mutable_buffer & target, std::span<const const_buffer> source) noexcept;
+std::size_t buffer_copy(std::span<const mutable_buffer> target, const const_buffer & source) noexcept;
+std::size_t buffer_copy(std::span<const mutable_buffer> target, std::span<const const_buffer> source) noexcept;
 
 namespace detail
 {
-struct dynamic_buffer
+
+// used by the default implementations of the vectored operations.
+template<typename Buffer>
+Buffer first_non_empty(std::span<const Buffer> buffers)
 {
-    typedef const_buffer const_buffers_type;
-    typedef mutable_buffer mutable_buffers_type;
+    for (const auto & b : buffers)
+        if (b.size() > 0u)
+            return b;
+    return Buffer{};
+}
 
-    virtual std::size_t size() const noexcept = 0;
-    virtual std::size_t max_size() const noexcept = 0;
-    virtual std::size_t capacity() const noexcept = 0;
+// the operations of a type-erased dynamic buffer, one static instance per type.
+struct dynamic_buffer_vtable
+{
+    std::size_t (*size)    (const void * p) noexcept;
+    std::size_t (*max_size)(const void * p) noexcept;
+    std::size_t (*capacity)(const void * p) noexcept;
 
 #if !defined(ASIO_NO_DYNAMIC_BUFFER_V1)
-    virtual const_buffers_type data() const noexcept = 0;
+    const_buffer (*cdata)(const void * p) noexcept;
 #endif
-
-    virtual mutable_buffers_type data(std::size_t pos, std::size_t n) noexcept = 0;
-    virtual   const_buffers_type data(std::size_t pos, std::size_t n) const noexcept = 0;
+    mutable_buffer (*mdata_at)(      void * p, std::size_t pos, std::size_t n) noexcept;
+      const_buffer (*cdata_at)(const void * p, std::size_t pos, std::size_t n) noexcept;
 
 #if !defined(ASIO_NO_DYNAMIC_BUFFER_V1)
-    virtual mutable_buffers_type prepare(std::size_t n) = 0;
-    virtual void commit(std::size_t n) = 0;
+    mutable_buffer (*prepare)(void * p, std::size_t n);
+    void (*commit)(void * p, std::size_t n);
 #endif
-    virtual void grow(std::size_t n) = 0;
-    virtual void shrink(std::size_t n) = 0;
-    virtual void consume(std::size_t n) = 0;
+    void (*grow)   (void * p, std::size_t n);
+    void (*shrink) (void * p, std::size_t n);
+    void (*consume)(void * p, std::size_t n);
+
+    // copy or move into uninitialized storage & destroy.
+    void (*copy)(void * storage, const void * p);
+    void (*move)(void * storage, void * p) noexcept;
+    void (*destroy)(void * storage) noexcept;
 };
 
+/**
+ * Dynamic buffers whose object fits into this many bytes are stored inside the `pio::dynamic_buffer` itself,
+ * larger ones are allocated. The default fits asio's string & vector buffers.
+ */
+#if !defined(PIO_DYNAMIC_BUFFER_SIZE)
+#define PIO_DYNAMIC_BUFFER_SIZE (4 * sizeof(void*))
+#endif
+
 template<typename Impl>
-struct dynamic_buffer_impl final : dynamic_buffer
+constexpr bool dynamic_buffer_stores_inline =
+           sizeof(Impl) <= PIO_DYNAMIC_BUFFER_SIZE
+        && alignof(Impl) <= alignof(std::max_align_t)
+        && std::is_nothrow_move_constructible_v<Impl>;
+
+// the storage holds either the Impl itself or a pointer to it.
+template<typename Impl>
+Impl & dynamic_buffer_get(void * storage) noexcept
 {
-    typedef const_buffer const_buffers_type;
-    typedef mutable_buffer mutable_buffers_type;
-    std::size_t     size() const noexcept override {return impl_.size();}
-    std::size_t max_size() const noexcept override {return impl_.max_size();}
-    std::size_t capacity() const noexcept override {return impl_.capacity();}
+    if constexpr (dynamic_buffer_stores_inline<Impl>)
+        return *static_cast<Impl*>(storage);
+    else
+        return **static_cast<Impl**>(storage);
+}
 
+template<typename Impl>
+const Impl & dynamic_buffer_get(const void * storage) noexcept
+{
+    return dynamic_buffer_get<Impl>(const_cast<void*>(storage));
+}
+
+template<typename Impl>
+void dynamic_buffer_construct(void * storage, Impl && impl)
+{
+    using impl_type = std::decay_t<Impl>;
+    if constexpr (dynamic_buffer_stores_inline<impl_type>)
+        new (storage) impl_type(std::forward<Impl>(impl));
+    else
+        *static_cast<impl_type**>(storage) = new impl_type(std::forward<Impl>(impl));
+}
+
+template<typename Impl>
+constexpr dynamic_buffer_vtable dynamic_buffer_vtable_for = {
+    +[](const void * p) noexcept -> std::size_t {return dynamic_buffer_get<Impl>(p).size();},
+    +[](const void * p) noexcept -> std::size_t {return dynamic_buffer_get<Impl>(p).max_size();},
+    +[](const void * p) noexcept -> std::size_t {return dynamic_buffer_get<Impl>(p).capacity();},
 #if !defined(ASIO_NO_DYNAMIC_BUFFER_V1)
-    const_buffers_type data() const noexcept override  {return impl_.data();};
+    +[](const void * p) noexcept -> const_buffer
+    {
+        auto & impl = dynamic_buffer_get<Impl>(p);
+        if constexpr (requires {impl.data();})
+            return impl.data();
+        else
+            return impl.data(0u, impl.size());
+    },
 #endif
-    mutable_buffers_type data(std::size_t pos, std::size_t n)     noexcept override {return impl_.data(pos, n);}
-    const_buffers_type data(std::size_t pos, std::size_t n) const noexcept override {return impl_.data(pos, n);}
-
+    +[](void * p, std::size_t pos, std::size_t n) noexcept -> mutable_buffer {return dynamic_buffer_get<Impl>(p).data(pos, n);},
+    +[](const void * p, std::size_t pos, std::size_t n) noexcept -> const_buffer {return dynamic_buffer_get<Impl>(p).data(pos, n);},
 #if !defined(ASIO_NO_DYNAMIC_BUFFER_V1)
-    mutable_buffers_type prepare(std::size_t n) override { return impl_.prepare(n);}
-    void commit(std::size_t n) override { impl_.commit(n);}
+    // buffers that only implement v2 can't be used with the v1 operations.
+    +[](void * p, std::size_t n) -> mutable_buffer
+    {
+        auto & impl = dynamic_buffer_get<Impl>(p);
+        if constexpr (requires {impl.prepare(n);})
+            return impl.prepare(n);
+        else
+            asio::detail::throw_error(asio::error::operation_not_supported, "prepare");
+        return {};
+    },
+    +[](void * p, std::size_t n)
+    {
+        auto & impl = dynamic_buffer_get<Impl>(p);
+        if constexpr (requires {impl.commit(n);})
+            impl.commit(n);
+        else
+            asio::detail::throw_error(asio::error::operation_not_supported, "commit");
+    },
 #endif
-    void grow(std::size_t n)    override { impl_.grow(n); }
-    void shrink(std::size_t n)  override { impl_.shrink(n); }
-    void consume(std::size_t n) override { impl_.consume(n); }
-
-    Impl impl_;
-    dynamic_buffer_impl(Impl impl) : impl_(std::move(impl)) {}
+    +[](void * p, std::size_t n) {dynamic_buffer_get<Impl>(p).grow(n);},
+    +[](void * p, std::size_t n) {dynamic_buffer_get<Impl>(p).shrink(n);},
+    +[](void * p, std::size_t n) {dynamic_buffer_get<Impl>(p).consume(n);},
+    +[](void * storage, const void * p) {dynamic_buffer_construct(storage, dynamic_buffer_get<Impl>(p));},
+    +[](void * storage, void * p) noexcept
+    {
+        if constexpr (dynamic_buffer_stores_inline<Impl>)
+            new (storage) Impl(std::move(dynamic_buffer_get<Impl>(p)));
+        else // hand over the pointer
+            *static_cast<Impl**>(storage) = *static_cast<Impl**>(p);
+    },
+    +[](void * storage) noexcept
+    {
+        if constexpr (dynamic_buffer_stores_inline<Impl>)
+            static_cast<Impl*>(storage)->~Impl();
+        else
+            delete *static_cast<Impl**>(storage);
+    }
 };
 
 }
 
-
+/// A type-erased dynamic buffer (v2), that wraps asio's string & vector buffers or any user-defined one.
+/**
+ * The wrapped buffer is stored inline if it fits into `PIO_DYNAMIC_BUFFER_SIZE`, so constructing & copying
+ * doesn't allocate. A user-defined buffer needs to be copyable and its `data(pos, n)` convertible to a single buffer.
+ * If it only implements the v2 interface, `prepare` & `commit` throw `asio::error::operation_not_supported`.
+ *
+ * Like the buffers it wraps it's a handle, i.e. copies refer to the same underlying storage.
+ */
 struct dynamic_buffer
 {
     template<typename ... Args>
+        requires requires (Args && ... args) { asio::dynamic_buffer(std::forward<Args>(args)...); }
     dynamic_buffer(Args && ... args)
-        : impl_(std::make_shared<
-                detail::dynamic_buffer_impl<
-                    decltype(asio::dynamic_buffer(std::forward<Args>(args)...))
-                    >>(
-                asio::dynamic_buffer(std::forward<Args>(args)...)))
+        : dynamic_buffer(asio::dynamic_buffer(std::forward<Args>(args)...))
+    {
+    }
+
+    template<typename DynamicBuffer>
+        requires (!std::is_same_v<std::decay_t<DynamicBuffer>, dynamic_buffer>
+                  && asio::is_dynamic_buffer_v2<std::decay_t<DynamicBuffer>>::value
+                  && std::is_copy_constructible_v<std::decay_t<DynamicBuffer>>)
+    dynamic_buffer(DynamicBuffer && impl)
+        : vtable_(&detail::dynamic_buffer_vtable_for<std::decay_t<DynamicBuffer>>)
+    {
+        detail::dynamic_buffer_construct(storage_, std::forward<DynamicBuffer>(impl));
+    }
+
+    dynamic_buffer(const dynamic_buffer & lhs) : vtable_(lhs.vtable_)
+    {
+        vtable_->copy(storage_, lhs.storage_);
+    }
+
+    // the moved-from buffer is left empty.
+    dynamic_buffer(dynamic_buffer && lhs) noexcept : vtable_(std::exchange(lhs.vtable_, nullptr))
+    {
+        if (vtable_)
+        {
+            vtable_->move(storage_, lhs.storage_);
+            vtable_->destroy(lhs.storage_);
+        }
+    }
+
+    dynamic_buffer& operator=(const dynamic_buffer & lhs)
+    {
+        if (this != &lhs)
+        {
+            dynamic_buffer tmp{lhs};
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    dynamic_buffer& operator=(dynamic_buffer && lhs) noexcept
+    {
+        if (this != &lhs)
+        {
+            this->~dynamic_buffer();
+            new (this) dynamic_buffer(std::move(lhs));
+        }
+        return *this;
+    }
+
+    ~dynamic_buffer()
     {
+        if (vtable_)
+            vtable_->destroy(storage_);
     }
 
     typedef const_buffer const_buffers_type;
     typedef mutable_buffer mutable_buffers_type;
 
-    std::size_t     size() const noexcept {assert(impl_); return impl_->size();}
-    std::size_t max_size() const noexcept {assert(impl_); return impl_->max_size();}
-    std::size_t capacity() const noexcept {assert(impl_); return impl_->capacity();}
+    std::size_t     size() const noexcept {assert(vtable_); return vtable_->size(storage_);}
+    std::size_t max_size() const noexcept {assert(vtable_); return vtable_->max_size(storage_);}
+    std::size_t capacity() const noexcept {assert(vtable_); return vtable_->capacity(storage_);}
 
 #if !defined(ASIO_NO_DYNAMIC_BUFFER_V1)
-    const_buffers_type data() const noexcept {assert(impl_); return impl_->data();};
+    const_buffers_type data() const noexcept {assert(vtable_); return vtable_->cdata(storage_);};
 #endif
-    mutable_buffers_type data(std::size_t pos, std::size_t n)       noexcept {assert(impl_); return impl_->data(pos, n);}
-      const_buffers_type data(std::size_t pos, std::size_t n) const noexcept {assert(impl_); return impl_->data(pos, n);}
+    mutable_buffers_type data(std::size_t pos, std::size_t n)       noexcept {assert(vtable_); return vtable_->mdata_at(storage_, pos, n);}
+      const_buffers_type data(std::size_t pos, std::size_t n) const noexcept {assert(vtable_); return vtable_->cdata_at(storage_, pos, n);}
 
 #if !defined(ASIO_NO_DYNAMIC_BUFFER_V1)
-    mutable_buffers_type prepare(std::size_t n) { assert(impl_); return impl_->prepare(n);}
-    void commit(std::size_t n) { assert(impl_); impl_->commit(n);}
+    mutable_buffers_type prepare(std::size_t n) { assert(vtable_); return vtable_->prepare(storage_, n);}
+    void commit(std::size_t n) { assert(vtable_); vtable_->commit(storage_, n);}
 #endif
-    void grow(std::size_t n)    { assert(impl_); impl_->grow(n); }
-    void shrink(std::size_t n)  { assert(impl_); impl_->shrink(n); }
-    void consume(std::size_t n) { assert(impl_); impl_->consume(n); }
+    void grow(std::size_t n)    { assert(vtable_); vtable_->grow(storage_, n); }
+    void shrink(std::size_t n)  { assert(vtable_); vtable_->shrink(storage_, n); }
+    void consume(std::size_t n) { assert(vtable_); vtable_->consume(storage_, n); }
 private:
-    // can be optimized, it's trivial and just a string and 2 size_t
-    std::shared_ptr<detail::dynamic_buffer> impl_;
+    const detail::dynamic_buffer_vtable * vtable_;
+    alignas(std::max_align_t) unsigned char storage_[PIO_DYNAMIC_BUFFER_SIZE];
 };
 
 extern template dynamic_buffer::dynamic_buffer(std::string &);
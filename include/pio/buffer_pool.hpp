@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_BUFFER_POOL_HPP
+#define PIO_BUFFER_POOL_HPP
+
+#include <pio/buffer.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace pio
+{
+
+struct buffer_pool;
+
+/// A block leased from a `buffer_pool` holding the data of a read, returned to the pool on destruction.
+struct leased_buffer
+{
+    leased_buffer() noexcept = default;
+    leased_buffer(leased_buffer && lhs) noexcept;
+    leased_buffer& operator=(leased_buffer && lhs) noexcept;
+    ~leased_buffer();
+
+    /// The data that was read.
+    const_buffer data() const noexcept {return const_buffer(block_, size_);}
+    operator const_buffer() const noexcept {return data();}
+
+    std::size_t size() const noexcept {return size_;}
+    std::size_t capacity() const noexcept;
+    bool empty() const noexcept {return size_ == 0u;}
+
+    /// The writable area of the block, used by the read operations.
+    mutable_buffer prepare() const noexcept {return mutable_buffer(block_, capacity());}
+    void commit(std::size_t n) noexcept {size_ = n;}
+
+    /// Check if the lease holds a block.
+    explicit operator bool() const noexcept {return pool_ != nullptr;}
+
+    /// Give the block back to the pool early.
+    void release() noexcept;
+
+  private:
+    friend struct buffer_pool;
+    leased_buffer(buffer_pool * pool, unsigned char * block) noexcept : pool_(pool), block_(block) {}
+
+    buffer_pool * pool_ = nullptr;
+    unsigned char * block_ = nullptr;
+    std::size_t size_ = 0u;
+};
+
+/// A pool of equally sized read buffers shared by many streams.
+/**
+ * A read without a buffer (`async_read_some(pool, token)`) leases a block only once data is available
+ * where the stream supports waiting for readiness (pipes & serial ports), so that idle streams don't hold memory.
+ * The memory in use then scales with the data in flight, not the number of open streams.
+ *
+ * The pool is thread-safe and must outlive all leased buffers.
+ *
+ * With an `alignment`, e.g. the `io_alignment::memory` of a file opened for direct I/O,
+ * every block is aligned to it and the block size is rounded up to a multiple of it.
+ */
+struct buffer_pool
+{
+    buffer_pool(std::size_t block_size, std::size_t block_count, std::size_t alignment = alignof(std::max_align_t));
+
+    buffer_pool(const buffer_pool & ) = delete;
+    buffer_pool& operator=(const buffer_pool & ) = delete;
+    ~buffer_pool();
+
+    std::size_t block_size() const noexcept {return block_size_;}
+    std::size_t alignment() const noexcept {return alignment_;}
+    std::size_t block_count() const noexcept {return block_count_;}
+    /// The number of blocks that are not leased.
+    std::size_t available() const;
+
+    /// Lease a block, returns an empty `leased_buffer` if the pool is exhausted.
+    leased_buffer try_acquire();
+
+  private:
+    friend struct leased_buffer;
+    void deallocate_(unsigned char * block) noexcept;
+
+    struct slab_deleter
+    {
+        std::size_t alignment;
+        void operator()(unsigned char * p) const noexcept;
+    };
+
+    std::size_t alignment_;
+    std::size_t block_size_;
+    std::size_t block_count_;
+    std::unique_ptr<unsigned char[], slab_deleter> slab_;
+
+    mutable std::mutex mutex_;
+    std::vector<unsigned char*> free_;
+};
+
+}
+
+#endif //PIO_BUFFER_POOL_HPP
@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_CACHED_RANDOM_ACCESS_DEVICE_HPP
+#define PIO_CACHED_RANDOM_ACCESS_DEVICE_HPP
+
+#include <pio/concepts.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace pio
+{
+
+namespace detail
+{
+struct block_cache_state;
+}
+
+/// A read device that keeps the blocks read from the next layer in a memory-bounded cache.
+/**
+ * The cache is split into `shards` with a lock each, so reads from multiple threads don't contend.
+ * Every shard evicts on its own, with either
+ *  - `eviction::clock`, a second chance ring, or
+ *  - `eviction::s3_fifo`, a small probationary FIFO, a main FIFO & a ghost queue of recently evicted blocks,
+ *    which keeps one-hit wonders of a scan from pushing out the hot blocks.
+ *
+ * A read is served from a single block, i.e. it's short at block boundaries, so use `read_at`
+ * for more. Concurrent misses on the same block are coalesced into a single read of the next layer.
+ *
+ * The cache assumes the data doesn't change underneath it, call `invalidate` if it does.
+ * Reading is thread-safe if initiating reads on the next layer is, & the cache must outlive all reads.
+ */
+struct cached_random_access_device final : concepts::implements<concepts::async_random_access_read_device>
+{
+    enum class eviction
+    {
+        clock,
+        s3_fifo
+    };
+
+    struct options
+    {
+        std::size_t block_size = 64u * 1024u;
+        /// The bytes of all cached blocks, reads in flight not included. At least one block is cached.
+        std::size_t capacity = 64u * 1024u * 1024u;
+        /// Clamped to the number of blocks that fit into `capacity`.
+        std::size_t shards = 16u;
+        eviction policy = eviction::s3_fifo;
+        /// The alignment of the blocks, e.g. `random_access_file::alignment().memory` for direct I/O.
+        /// The block size then also needs to be a multiple of the offset alignment.
+        std::size_t alignment = alignof(std::max_align_t);
+    };
+
+    /// Statistics of all shards. They're counted relaxed, so they're only exact while no reads are in flight.
+    struct statistics
+    {
+        std::uint64_t hits = 0u;
+        std::uint64_t misses = 0u;
+        /// Misses that waited for the read of another one.
+        std::uint64_t coalesced = 0u;
+        std::uint64_t evictions = 0u;
+        /// The bytes currently cached.
+        std::size_t size = 0u;
+    };
+
+    explicit cached_random_access_device(concepts::async_random_access_read_device & next);
+    cached_random_access_device(concepts::async_random_access_read_device & next, options opts);
+    ~cached_random_access_device();
+
+    cached_random_access_device(const cached_random_access_device &) = delete;
+    cached_random_access_device& operator=(const cached_random_access_device &) = delete;
+
+    executor_type get_executor() override;
+
+    statistics stats() const;
+    void reset_stats();
+
+    /// Drop all cached blocks. Reads in flight still fill the cache when they complete.
+    void invalidate();
+
+  private:
+    void async_read_some_at_impl(std::uint64_t offset, mutable_buffer buffer, handler_type<void(std::error_code, std::size_t)> && h) override;
+
+    std::unique_ptr<detail::block_cache_state> state_;
+};
+
+}
+
+#endif //PIO_CACHED_RANDOM_ACCESS_DEVICE_HPP
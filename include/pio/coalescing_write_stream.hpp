@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_COALESCING_WRITE_STREAM_HPP
+#define PIO_COALESCING_WRITE_STREAM_HPP
+
+#include <pio/concepts.hpp>
+
+#include <asio/async_result.hpp>
+
+#include <chrono>
+#include <cstddef>
+
+namespace pio
+{
+
+namespace detail
+{
+struct coalescing_state;
+}
+
+/// A write stream that collects small writes in a buffer and writes them to the next layer in one go.
+/**
+ * Writes are copied into an append buffer of `capacity` bytes, which gets written to the next layer when
+ *  - it is full,
+ *  - `delay` passed since the first byte was buffered, or
+ *  - `async_flush` is called.
+ *
+ * While a flush is in flight the writes go into a second buffer, so writers only wait if both are full.
+ * A write of at least `capacity` bytes isn't copied, but gathered into the flush of the buffered data.
+ *
+ * With `completion::on_enqueue` a write completes once its data is buffered,
+ * with `completion::on_flush` once it was written to the next layer. An error of a flush is reported
+ * by every following operation.
+ *
+ * Like the other io objects it is not thread-safe, the flushes & timer complete on the executor of the next layer.
+ * Data that wasn't flushed when the stream is destroyed is dropped & the writes & flushes waiting for it
+ * complete with `asio::error::operation_aborted`. Those waiting for a flush in flight complete once it's done.
+ */
+struct coalescing_write_stream final : concepts::implements<concepts::async_write_stream>
+{
+    enum class completion
+    {
+        on_enqueue,
+        on_flush
+    };
+
+    struct options
+    {
+        std::size_t capacity = 64u * 1024u;
+        /// Zero disables the timer, i.e. only full buffers & explicit flushes get written.
+        std::chrono::steady_clock::duration delay = std::chrono::milliseconds(1);
+        completion complete = completion::on_enqueue;
+    };
+
+    explicit coalescing_write_stream(concepts::async_write_stream & next);
+    coalescing_write_stream(concepts::async_write_stream & next, options opts);
+
+    coalescing_write_stream(coalescing_write_stream && lhs) noexcept;
+    coalescing_write_stream& operator=(coalescing_write_stream && lhs) noexcept;
+    ~coalescing_write_stream();
+
+    executor_type get_executor() override;
+
+    /// The number of bytes buffered, but not yet written to the next layer.
+    std::size_t buffered() const;
+
+    /// Write everything buffered so far to the next layer.
+    template<typename CompletionToken>
+    ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code))
+    async_flush(CompletionToken && token)
+    {
+        return asio::async_initiate<CompletionToken, void(std::error_code)>(
+                [this](auto handler)
+                {
+                    this->async_flush_impl(handler_type<void(std::error_code)>(std::move(handler), this->get_executor()));
+                }, token);
+    }
+
+  private:
+    void async_write_some_impl(const_buffer buffer, handler_type<void(std::error_code, std::size_t)> && h) override;
+    void async_write_some_impl(std::span<const const_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h) override;
+    void async_flush_impl(handler_type<void(std::error_code)> && h);
+
+    void destroy_() noexcept;
+    detail::coalescing_state * state_;
+};
+
+}
+
+#endif //PIO_COALESCING_WRITE_STREAM_HPP
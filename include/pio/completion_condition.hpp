@@ -0,0 +1,250 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_COMPLETION_CONDITION_HPP
+#define PIO_COMPLETION_CONDITION_HPP
+
+#include <asio/completion_condition.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+/// The size of the inline storage of a `completion_condition`.
+/**
+ * The default fits a lambda capturing e.g. a `std::string` or a `std::shared_ptr` and a few scalars.
+ * Define it before including any pio header to change it.
+ */
+#if !defined(PIO_COMPLETION_CONDITION_BUFFER_SIZE)
+#define PIO_COMPLETION_CONDITION_BUFFER_SIZE (6 * sizeof(void*))
+#endif
+
+namespace pio
+{
+
+/// A type-erased completion condition for the composed read & write operations.
+/**
+ * transfer_all, transfer_at_least and transfer_exactly are evaluated directly, i.e. without
+ * an allocation or an indirect call.
+ * Any other callable with the signature `std::size_t(const std::error_code&, std::size_t)` is supported.
+ * It's stored inline if it fits into `PIO_COMPLETION_CONDITION_BUFFER_SIZE` bytes, is aligned to at most a pointer
+ * and is nothrow move constructible. Otherwise it's allocated with `new` and every copy allocates, too.
+ */
+struct completion_condition
+{
+    /// The maximum amount of bytes the built-in conditions request for one intermediate operation, same as asio.
+    constexpr static std::size_t default_max_transfer_size = 65536u;
+
+    /// Transfer all data, same as `transfer_all()`.
+    completion_condition() noexcept = default;
+    completion_condition(asio::detail::transfer_all_t) noexcept {}
+
+    template<typename Func>
+        requires (!std::is_same_v<std::decay_t<Func>, completion_condition>
+               && !std::is_same_v<std::decay_t<Func>, asio::detail::transfer_all_t>
+               && std::is_invocable_r_v<std::size_t, std::decay_t<Func>&, const std::error_code&, std::size_t>)
+    completion_condition(Func && func) : kind_(kind::custom)
+    {
+        using func_t = std::decay_t<Func>;
+        if constexpr (stores_inline<func_t>)
+        {
+            new (storage_) func_t(std::forward<Func>(func));
+            vtable_ = &inline_vtable<func_t>;
+        }
+        else
+        {
+            new (storage_) func_t*(new func_t(std::forward<Func>(func)));
+            vtable_ = &heap_vtable<func_t>;
+        }
+    }
+
+    completion_condition(const completion_condition & lhs)
+        : kind_(lhs.kind_), size_(lhs.size_), vtable_(lhs.vtable_)
+    {
+        if (vtable_ && vtable_->copy)
+            vtable_->copy(lhs.storage_, storage_);
+        else
+            std::memcpy(storage_, lhs.storage_, sizeof(storage_));
+    }
+
+    completion_condition(completion_condition && lhs) noexcept
+        : kind_(std::exchange(lhs.kind_, kind::all)), size_(lhs.size_), vtable_(std::exchange(lhs.vtable_, nullptr))
+    {
+        relocate(lhs.storage_);
+    }
+
+    completion_condition& operator=(const completion_condition & lhs)
+    {
+        if (this != &lhs)
+        {
+            completion_condition tmp{lhs};
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    completion_condition& operator=(completion_condition && lhs) noexcept
+    {
+        if (this != &lhs)
+        {
+            reset();
+            kind_   = std::exchange(lhs.kind_, kind::all);
+            size_   = lhs.size_;
+            vtable_ = std::exchange(lhs.vtable_, nullptr);
+            relocate(lhs.storage_);
+        }
+        return *this;
+    }
+
+    ~completion_condition()
+    {
+        reset();
+    }
+
+    /// Returns the maximum number of bytes for the next intermediate operation, 0 if the operation is complete.
+    std::size_t operator()(const std::error_code & ec, std::size_t total_transferred) const
+    {
+        switch (kind_)
+        {
+            case kind::all:
+                return !ec ? default_max_transfer_size : 0u;
+            case kind::at_least:
+                return (!ec && total_transferred < size_) ? default_max_transfer_size : 0u;
+            case kind::exactly:
+                return (!ec && total_transferred < size_)
+                        ? (std::min)(size_ - total_transferred, default_max_transfer_size) : 0u;
+            default:
+                return vtable_->invoke(storage_, ec, total_transferred);
+        }
+    }
+
+    friend inline completion_condition transfer_at_least(std::size_t minimum) noexcept;
+    friend inline completion_condition transfer_exactly(std::size_t size) noexcept;
+
+  private:
+    enum class kind : unsigned char {all, at_least, exactly, custom};
+
+    completion_condition(kind k, std::size_t size) noexcept : kind_(k), size_(size) {}
+
+    struct vtable
+    {
+        std::size_t (*invoke)(void * storage, const std::error_code & ec, std::size_t total_transferred);
+        // null means the storage can be memcpy'd, resp. needs no destruction
+        void (*copy)(const void * from, void * to);
+        // move-constructs into to & destroys from.
+        void (*move)(void * from, void * to) noexcept;
+        void (*destroy)(void * storage);
+    };
+
+    template<typename Func>
+    constexpr static bool stores_inline = sizeof(Func) <= PIO_COMPLETION_CONDITION_BUFFER_SIZE
+                                       && alignof(Func) <= alignof(void*)
+                                       && std::is_nothrow_move_constructible_v<Func>;
+
+    template<typename Func>
+    static std::size_t invoke_inline(void * storage, const std::error_code & ec, std::size_t total_transferred)
+    {
+        return (*static_cast<Func*>(storage))(ec, total_transferred);
+    }
+
+    template<typename Func>
+    static void copy_inline(const void * from, void * to)
+    {
+        new (to) Func(*static_cast<const Func*>(from));
+    }
+
+    template<typename Func>
+    static void move_inline(void * from, void * to) noexcept
+    {
+        auto & f = *static_cast<Func*>(from);
+        new (to) Func(std::move(f));
+        f.~Func();
+    }
+
+    template<typename Func>
+    static void destroy_inline(void * storage)
+    {
+        static_cast<Func*>(storage)->~Func();
+    }
+
+    template<typename Func>
+    static std::size_t invoke_heap(void * storage, const std::error_code & ec, std::size_t total_transferred)
+    {
+        return (**static_cast<Func**>(storage))(ec, total_transferred);
+    }
+
+    template<typename Func>
+    static void copy_heap(const void * from, void * to)
+    {
+        new (to) Func*(new Func(**static_cast<Func* const*>(from)));
+    }
+
+    template<typename Func>
+    static void destroy_heap(void * storage)
+    {
+        delete *static_cast<Func**>(storage);
+    }
+
+    template<typename Func>
+    constexpr static vtable inline_vtable =
+            std::is_trivially_copyable_v<Func>
+            ? vtable{&invoke_inline<Func>, nullptr, nullptr, nullptr}
+            : vtable{&invoke_inline<Func>, &copy_inline<Func>, &move_inline<Func>, &destroy_inline<Func>};
+
+    // the pointer is moved with memcpy.
+    template<typename Func>
+    constexpr static vtable heap_vtable{&invoke_heap<Func>, &copy_heap<Func>, nullptr, &destroy_heap<Func>};
+
+    // take over the storage of a moved-from condition, whose vtable was already taken.
+    void relocate(void * from) noexcept
+    {
+        if (vtable_ && vtable_->move)
+            vtable_->move(from, storage_);
+        else
+            std::memcpy(storage_, from, sizeof(storage_));
+    }
+
+    void reset() noexcept
+    {
+        if (vtable_ && vtable_->destroy)
+            vtable_->destroy(storage_);
+        vtable_ = nullptr;
+        kind_ = kind::all;
+    }
+
+    kind kind_ = kind::all;
+    std::size_t size_ = 0u;
+    const vtable * vtable_ = nullptr;
+    alignas(void*) mutable unsigned char storage_[PIO_COMPLETION_CONDITION_BUFFER_SIZE];
+};
+
+using completion_condition_t = completion_condition;
+
+/// Transfer until the buffer is full or an error occurred.
+inline completion_condition transfer_all() noexcept
+{
+    return completion_condition{};
+}
+
+/// Transfer until at least `minimum` bytes were transferred or an error occurred.
+inline completion_condition transfer_at_least(std::size_t minimum) noexcept
+{
+    return completion_condition{completion_condition::kind::at_least, minimum};
+}
+
+/// Transfer until exactly `size` bytes were transferred or an error occurred.
+inline completion_condition transfer_exactly(std::size_t size) noexcept
+{
+    return completion_condition{completion_condition::kind::exactly, size};
+}
+
+}
+
+#endif //PIO_COMPLETION_CONDITION_HPP
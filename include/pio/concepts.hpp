@@ -11,11 +11,21 @@
 #include "asio/any_io_executor.hpp"
 #include "asio/buffer.hpp"
 
+#include "pio/buffer.hpp"
+#include "pio/buffer_pool.hpp"
 #include "pio/handler.hpp"
 
+#include <span>
+
 namespace pio::concepts
 {
 
+// Every operation is started on its own through the virtual *_impl functions, there's no API to batch submissions.
+// With io_uring, asio doesn't enter the kernel per operation: the SQEs queued while a handler runs are submitted
+// together by one io_uring_enter afterwards, and the ring itself isn't exposed to submit an explicit batch.
+// Pipes & serial ports are reactor based, so there's nothing to batch for them.
+// To get many operations into one submission, start them from the same handler.
+
 struct closable
 {
     virtual void close() = 0;
@@ -53,7 +63,46 @@ struct async_read_stream : virtual execution_context
                 token, buffer);
     }
 
+    /// Scatter read. The buffers need to stay valid until the operation completes.
+    template<typename CompletionHandler>
+    ASIO_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(std::error_code, std::size_t))
+    async_read_some(std::span<const asio::mutable_buffer> buffers, CompletionHandler && token)
+    {
+        return asio::async_initiate<CompletionHandler, void(std::error_code, std::size_t)>(
+                [this](auto handler, std::span<const asio::mutable_buffer> buffers)
+                {
+                    this->async_read_some_impl(buffers,
+                                               handler_type<void(std::error_code, std::size_t)>(std::move(handler), this->get_executor()));
+                },
+                token, buffers);
+    }
+
     virtual void async_read_some_impl(const asio::mutable_buffer &buffer, handler_type<void(std::error_code, std::size_t)> && h) = 0;
+    // the default reads into the first non-empty buffer only.
+    virtual void async_read_some_impl(std::span<const asio::mutable_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h)
+    {
+        this->async_read_some_impl(detail::first_non_empty(buffers), std::move(h));
+    }
+
+    /// Read without a buffer, the data gets delivered in a block leased from the pool.
+    /**
+     * Completes with `asio::error::no_buffer_space` if the pool is exhausted when the block is needed.
+     */
+    template<typename CompletionHandler>
+    ASIO_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(std::error_code, leased_buffer))
+    async_read_some(buffer_pool & pool, CompletionHandler && token)
+    {
+        return asio::async_initiate<CompletionHandler, void(std::error_code, leased_buffer)>(
+                [this](auto handler, buffer_pool * pool)
+                {
+                    this->async_read_some_impl(*pool,
+                                               handler_type<void(std::error_code, leased_buffer)>(std::move(handler), this->get_executor()));
+                },
+                token, &pool);
+    }
+
+    // the default leases the block right away, streams that can wait for readiness only lease once data is available.
+    virtual void async_read_some_impl(buffer_pool & pool, handler_type<void(std::error_code, leased_buffer)> && h);
 };
 
 struct async_write_stream : virtual execution_context
@@ -71,14 +120,37 @@ struct async_write_stream : virtual execution_context
                 token, buffer);
     }
 
+    /// Gather write. The buffers need to stay valid until the operation completes.
+    template<typename CompletionHandler>
+    ASIO_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(std::error_code, std::size_t))
+    async_write_some(std::span<const asio::const_buffer> buffers, CompletionHandler && token)
+    {
+        return asio::async_initiate<CompletionHandler, void(std::error_code, std::size_t)>(
+                [this](auto handler, std::span<const asio::const_buffer> buffers)
+                {
+                    this->async_write_some_impl(buffers,
+                                                handler_type<void(std::error_code, std::size_t)>(std::move(handler), this->get_executor()));
+                },
+                token, buffers);
+    }
+
     virtual void async_write_some_impl(asio::const_buffer buffer,
                                        handler_type<void(std::error_code, std::size_t)> && h) = 0;
+    // the default writes the first non-empty buffer only.
+    virtual void async_write_some_impl(std::span<const asio::const_buffer> buffers,
+                                       handler_type<void(std::error_code, std::size_t)> && h)
+    {
+        this->async_write_some_impl(detail::first_non_empty(buffers), std::move(h));
+    }
 };
 
 struct sync_read_stream
 {
     virtual std::size_t read_some(const asio::mutable_buffer &buffer) = 0;
     virtual std::size_t read_some(const asio::mutable_buffer &buffer, std::error_code & ec) = 0;
+    // scatter read, the default reads into the first non-empty buffer only.
+    virtual std::size_t read_some(std::span<const asio::mutable_buffer> buffers) {return this->read_some(detail::first_non_empty(buffers));}
+    virtual std::size_t read_some(std::span<const asio::mutable_buffer> buffers, std::error_code & ec) {return this->read_some(detail::first_non_empty(buffers), ec);}
     virtual ~sync_read_stream() = default;
 
 };
@@ -89,6 +161,9 @@ struct sync_write_stream
 {
     virtual std::size_t write_some(const asio::const_buffer & buffer) = 0;
     virtual std::size_t write_some(const asio::const_buffer & buffer, std::error_code & ec) = 0;
+    // gather write, the default writes the first non-empty buffer only.
+    virtual std::size_t write_some(std::span<const asio::const_buffer> buffers) {return this->write_some(detail::first_non_empty(buffers));}
+    virtual std::size_t write_some(std::span<const asio::const_buffer> buffers, std::error_code & ec) {return this->write_some(detail::first_non_empty(buffers), ec);}
     virtual ~sync_write_stream() = default;
 };
 
@@ -133,8 +208,28 @@ struct async_random_access_read_device : virtual execution_context
                 token, offset, buffer);
     }
 
+    /// Scatter read. The buffers need to stay valid until the operation completes.
+    template<typename CompletionHandler>
+    ASIO_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(std::error_code, std::size_t))
+    async_read_some_at(std::uint64_t offset, std::span<const asio::mutable_buffer> buffers, CompletionHandler && token)
+    {
+        return asio::async_initiate<CompletionHandler, void(std::error_code, std::size_t)>(
+                [this](auto handler, std::uint64_t offset, std::span<const asio::mutable_buffer> buffers)
+                {
+                    this->async_read_some_at_impl(offset, buffers,
+                                                  handler_type<void(std::error_code, std::size_t)>(std::move(handler), this->get_executor()));
+                },
+                token, offset, buffers);
+    }
+
     virtual void async_read_some_at_impl(std::uint64_t offset, asio::mutable_buffer buffer,
                                          handler_type<void(std::error_code, std::size_t)> && h) = 0;
+    // the default reads into the first non-empty buffer only.
+    virtual void async_read_some_at_impl(std::uint64_t offset, std::span<const asio::mutable_buffer> buffers,
+                                         handler_type<void(std::error_code, std::size_t)> && h)
+    {
+        this->async_read_some_at_impl(offset, detail::first_non_empty(buffers), std::move(h));
+    }
 };
 
 struct async_random_access_write_device : virtual execution_context
@@ -152,14 +247,96 @@ struct async_random_access_write_device : virtual execution_context
                 token, offset, buffer);
     }
 
+    /// Gather write. The buffers need to stay valid until the operation completes.
+    template<typename CompletionHandler>
+    ASIO_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(std::error_code, std::size_t))
+    async_write_some_at(std::uint64_t offset, std::span<const asio::const_buffer> buffers, CompletionHandler && token)
+    {
+        return asio::async_initiate<CompletionHandler, void(std::error_code, std::size_t)>(
+                [this](auto handler, std::uint64_t offset, std::span<const asio::const_buffer> buffers)
+                {
+                    this->async_write_some_at_impl(offset, buffers,
+                                                   handler_type<void(std::error_code, std::size_t)>(std::move(handler), this->get_executor()));
+                },
+                token, offset, buffers);
+    }
+
     virtual void async_write_some_at_impl(std::uint64_t offset, asio::const_buffer buffer,
                                           handler_type<void(std::error_code, std::size_t)> && h) = 0;
+    // the default writes the first non-empty buffer only.
+    virtual void async_write_some_at_impl(std::uint64_t offset, std::span<const asio::const_buffer> buffers,
+                                          handler_type<void(std::error_code, std::size_t)> && h)
+    {
+        this->async_write_some_at_impl(offset, detail::first_non_empty(buffers), std::move(h));
+    }
+};
+
+/// A file whose written data can be flushed to stable storage without blocking the executor.
+struct async_syncable_device : virtual execution_context
+{
+    /// Flush data & metadata, like `fsync`.
+    template<typename CompletionHandler>
+    ASIO_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(std::error_code))
+    async_sync(CompletionHandler && token)
+    {
+        return asio::async_initiate<CompletionHandler, void(std::error_code)>(
+                [this](auto handler)
+                {
+                    this->async_sync_impl(handler_type<void(std::error_code)>(std::move(handler), this->get_executor()));
+                },
+                token);
+    }
+
+    /// Flush the data & the metadata needed to read it back, like `fdatasync`.
+    template<typename CompletionHandler>
+    ASIO_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(std::error_code))
+    async_data_sync(CompletionHandler && token)
+    {
+        return asio::async_initiate<CompletionHandler, void(std::error_code)>(
+                [this](auto handler)
+                {
+                    this->async_data_sync_impl(handler_type<void(std::error_code)>(std::move(handler), this->get_executor()));
+                },
+                token);
+    }
+
+    /// Write back the data in `[offset, offset + length)` & wait for it, like `sync_file_range`. A length of zero means up to the end of the file.
+    /**
+     * This is not a durability guarantee: it neither flushes metadata, not even the one needed to read newly
+     * allocated blocks, nor the volatile write cache of the drive. Use it to bound the amount of dirty data,
+     * e.g. ahead of an `async_data_sync`, and `async_data_sync` or `async_sync` when the data must survive a crash.
+     *
+     * Where there's no ranged write-back the whole file is synced.
+     */
+    template<typename CompletionHandler>
+    ASIO_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(std::error_code))
+    async_sync_range(std::uint64_t offset, std::uint64_t length, CompletionHandler && token)
+    {
+        return asio::async_initiate<CompletionHandler, void(std::error_code)>(
+                [this](auto handler, std::uint64_t offset, std::uint64_t length)
+                {
+                    this->async_sync_range_impl(offset, length,
+                                                handler_type<void(std::error_code)>(std::move(handler), this->get_executor()));
+                },
+                token, offset, length);
+    }
+
+    virtual void async_sync_impl(handler_type<void(std::error_code)> && h) = 0;
+    virtual void async_data_sync_impl(handler_type<void(std::error_code)> && h) = 0;
+    // the default syncs the data of the whole file.
+    virtual void async_sync_range_impl(std::uint64_t offset, std::uint64_t length, handler_type<void(std::error_code)> && h)
+    {
+        this->async_data_sync_impl(std::move(h));
+    }
 };
 
 struct sync_random_access_read_device
 {
     virtual std::size_t read_some_at(std::uint64_t offset, const asio::mutable_buffer & buffer) = 0;
     virtual std::size_t read_some_at(std::uint64_t offset, const asio::mutable_buffer & buffer, std::error_code & ec) = 0;
+    // scatter read, the default reads into the first non-empty buffer only.
+    virtual std::size_t read_some_at(std::uint64_t offset, std::span<const asio::mutable_buffer> buffers) {return this->read_some_at(offset, detail::first_non_empty(buffers));}
+    virtual std::size_t read_some_at(std::uint64_t offset, std::span<const asio::mutable_buffer> buffers, std::error_code & ec) {return this->read_some_at(offset, detail::first_non_empty(buffers), ec);}
     virtual ~sync_random_access_read_device() = default;
 };
 
@@ -169,6 +346,9 @@ struct sync_random_access_write_device
 {
     virtual std::size_t write_some_at(std::uint64_t offset, const asio::const_buffer &buffer) = 0;
     virtual std::size_t write_some_at(std::uint64_t offset, const asio::const_buffer &buffer, std::error_code & ec) = 0;
+    // gather write, the default writes the first non-empty buffer only.
+    virtual std::size_t write_some_at(std::uint64_t offset, std::span<const asio::const_buffer> buffers) {return this->write_some_at(offset, detail::first_non_empty(buffers));}
+    virtual std::size_t write_some_at(std::uint64_t offset, std::span<const asio::const_buffer> buffers, std::error_code & ec) {return this->write_some_at(offset, detail::first_non_empty(buffers), ec);}
     virtual ~sync_random_access_write_device() = default;
 };
 
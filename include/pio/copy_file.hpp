@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_COPY_FILE_HPP
+#define PIO_COPY_FILE_HPP
+
+#include <pio/handler.hpp>
+#include <pio/random_access_file.hpp>
+
+#include <asio/async_result.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace pio
+{
+
+/// Tuning of `async_copy_file`.
+struct copy_file_options
+{
+    /// Try to share the extents with `FICLONERANGE` first, if the filesystem supports reflinks.
+    bool reflink = true;
+    /// The bytes copied by a single `copy_file_range` call, i.e. how long a thread of the blocking pool is occupied at most.
+    /// Zero disables the in-kernel copy.
+    std::size_t kernel_chunk_size = 16u * 1024u * 1024u;
+    /// The buffer size of the fallback through user space.
+    std::size_t chunk_size = 1024u * 1024u;
+    /// The number of chunks of the fallback that are read or written at the same time.
+    std::size_t queue_depth = 4u;
+    /// Invoked with the bytes copied so far after every chunk. Invocations are serialized.
+    std::function<void(std::uint64_t)> progress;
+};
+
+namespace detail
+{
+
+void async_copy_file_impl(random_access_file & src, random_access_file & dst,
+                          std::uint64_t offset_in, std::uint64_t offset_out, std::uint64_t len,
+                          copy_file_options && options,
+                          handler_type<void(std::error_code, std::uint64_t)> && h);
+
+}
+
+/// Asynchronously copy `len` bytes from `src` at `offset_in` to `dst` at `offset_out`.
+/**
+ * The copy is tried as a reflink (`FICLONERANGE`) first, then done in-kernel with `copy_file_range(2)`
+ * in chunks of `kernel_chunk_size`. If the kernel can't copy between the two files (e.g. across filesystems),
+ * it falls back to reading & writing `queue_depth` chunks concurrently through the files' own async operations.
+ * The reflink & the `copy_file_range` calls are blocking, so they run on a thread pool internal to pio.
+ *
+ * Completes with the number of bytes copied, and `asio::error::eof` if `src` ended early.
+ * On error the count is the prefix of the range that is known to be copied,
+ * chunks copied concurrently after the first failed one aren't included.
+ *
+ * Cancellation is checked between chunks, chunks already in flight are completed first.
+ * The copy then completes with `asio::error::operation_aborted` and the bytes copied so far.
+ */
+template<typename CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, std::uint64_t))
+async_copy_file(random_access_file & src, random_access_file & dst,
+                std::uint64_t offset_in, std::uint64_t offset_out, std::uint64_t len,
+                copy_file_options options, CompletionToken && token)
+{
+    return asio::async_initiate<CompletionToken, void(std::error_code, std::uint64_t)>(
+            [&src, &dst](auto handler, std::uint64_t offset_in, std::uint64_t offset_out, std::uint64_t len,
+                         copy_file_options options)
+            {
+                detail::async_copy_file_impl(src, dst, offset_in, offset_out, len, std::move(options),
+                                             handler_type<void(std::error_code, std::uint64_t)>(std::move(handler), src.get_executor()));
+            }, token, offset_in, offset_out, len, std::move(options));
+}
+
+template<typename CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, std::uint64_t))
+async_copy_file(random_access_file & src, random_access_file & dst,
+                std::uint64_t offset_in, std::uint64_t offset_out, std::uint64_t len,
+                CompletionToken && token)
+{
+    return async_copy_file(src, dst, offset_in, offset_out, len, copy_file_options{},
+                           std::forward<CompletionToken>(token));
+}
+
+}
+
+#endif //PIO_COPY_FILE_HPP
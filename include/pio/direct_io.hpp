@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_DIRECT_IO_HPP
+#define PIO_DIRECT_IO_HPP
+
+#include <pio/buffer.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <system_error>
+
+namespace pio
+{
+
+/// Tag to open a file for direct I/O, i.e. bypassing the page cache with `O_DIRECT`.
+struct direct_io_t
+{
+    explicit direct_io_t() = default;
+};
+
+constexpr direct_io_t direct_io{};
+
+/// The alignment required for the reads & writes of a file. Buffered files don't require any.
+struct io_alignment
+{
+    /// The alignment of the buffer addresses.
+    std::size_t memory = 1u;
+    /// The alignment of the file offsets and the buffer sizes, i.e. the logical block size.
+    std::size_t offset = 1u;
+
+    bool required() const noexcept {return memory > 1u || offset > 1u;}
+
+    /// Check if a transfer at `position` meets the requirements.
+    bool check(std::uint64_t position, const void * data, std::size_t size) const noexcept
+    {
+        return (reinterpret_cast<std::uintptr_t>(data) % memory) == 0u
+            && (position % offset) == 0u
+            && (size % offset) == 0u;
+    }
+    bool check(std::uint64_t position, const const_buffer & buffer) const noexcept
+    {
+        return check(position, buffer.data(), buffer.size());
+    }
+    /// Every buffer of a vectored transfer needs to be aligned.
+    bool check(std::uint64_t position, std::span<const const_buffer> buffers) const noexcept;
+    bool check(std::uint64_t position, std::span<const mutable_buffer> buffers) const noexcept;
+};
+
+/// Query the alignment direct I/O requires for an open descriptor.
+/**
+ * Uses `statx` with `STATX_DIOALIGN` where available, the logical sector size (`BLKSSZGET`) for block devices
+ * and otherwise assumes 4 KiB, which satisfies all common devices.
+ */
+io_alignment query_direct_io_alignment(int fd, std::error_code & ec);
+
+/// An allocator returning memory aligned to a runtime alignment, e.g. the `io_alignment::memory` of a file.
+template<typename T>
+struct aligned_allocator
+{
+    using value_type = T;
+
+    explicit aligned_allocator(std::size_t alignment = alignof(T)) noexcept
+        : alignment_(alignment < alignof(T) ? alignof(T) : alignment) {}
+    template<typename U>
+    aligned_allocator(const aligned_allocator<U> & other) noexcept
+        : alignment_(other.alignment() < alignof(T) ? alignof(T) : other.alignment()) {}
+
+    std::size_t alignment() const noexcept {return alignment_;}
+
+    T * allocate(std::size_t n)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignment_}));
+    }
+
+    void deallocate(T * p, std::size_t)
+    {
+        ::operator delete(p, std::align_val_t{alignment_});
+    }
+
+    template<typename U>
+    bool operator==(const aligned_allocator<U> & other) const noexcept { return alignment_ == other.alignment(); }
+    template<typename U>
+    bool operator!=(const aligned_allocator<U> & other) const noexcept { return alignment_ != other.alignment(); }
+
+  private:
+    std::size_t alignment_;
+};
+
+}
+
+#endif //PIO_DIRECT_IO_HPP
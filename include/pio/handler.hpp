@@ -12,13 +12,32 @@
 #include <asio/associated_allocator.hpp>
 #include <asio/associated_cancellation_slot.hpp>
 #include <asio/associated_executor.hpp>
+#include <pio/recycling_allocator.hpp>
+#include <cassert>
+#include <cstddef>
 #include <memory_resource>
+#include <type_traits>
+#include <utility>
 
 namespace pio
 {
 
+namespace detail
+{
+
+// a memory resource that can copy itself, so that the copy can outlive the handler the original is stored in.
+struct copyable_resource : std::pmr::memory_resource
+{
+    // copies into storage if it fits, otherwise allocates the copy with the resource itself.
+    virtual copyable_resource * copy_to(void * storage, std::size_t size) const = 0;
+    // destroys a copy created by copy_to.
+    virtual void release(void * storage) noexcept = 0;
+};
+
+}
+
 template<typename Allocator>
-struct allocator_adaptor final : std::pmr::memory_resource
+struct allocator_adaptor final : detail::copyable_resource
 {
     allocator_adaptor(Allocator allocator) : allocator(allocator) {}
 
@@ -26,6 +45,29 @@ struct allocator_adaptor final : std::pmr::memory_resource
     using traits = std::allocator_traits<allocator_type>;
     allocator_type allocator;
 
+    using self_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<allocator_adaptor>;
+    using self_traits = std::allocator_traits<self_allocator_type>;
+
+    detail::copyable_resource * copy_to(void * storage, std::size_t size) const override
+    {
+        if (sizeof(allocator_adaptor) <= size && alignof(allocator_adaptor) <= alignof(std::max_align_t))
+            return new (storage) allocator_adaptor(allocator);
+
+        self_allocator_type alloc{allocator};
+        auto p = self_traits::allocate(alloc, 1);
+        return new (p) allocator_adaptor(allocator);
+    }
+
+    void release(void * storage) noexcept override
+    {
+        if (this == storage)
+            return this->~allocator_adaptor();
+
+        self_allocator_type alloc{allocator};
+        this->~allocator_adaptor();
+        self_traits::deallocate(alloc, this, 1);
+    }
+
     void*
     do_allocate(size_t bytes, size_t alignment) override
     {
@@ -51,11 +93,67 @@ struct allocator_adaptor final : std::pmr::memory_resource
     }
 };
 
-template<typename Signature>
+/// The size of the inline storage of a `handler_allocator`.
+/**
+ * Custom allocators whose adaptor fits into this many bytes are copied without an allocation.
+ */
+#if !defined(PIO_HANDLER_ALLOCATOR_SIZE)
+#define PIO_HANDLER_ALLOCATOR_SIZE (4 * sizeof(void*))
+#endif
+
+/// A copy of the allocator of a `handler_type`, that stays valid when the handler is moved or invoked.
+/**
+ * A composed operation that keeps state on the heap, e.g. shared by several intermediate operations,
+ * allocates and deallocates it with a `handler_allocator` obtained before moving the handler into it.
+ * Copying it copies the underlying allocator.
+ */
+struct handler_allocator
+{
+    /// Refer to a resource that outlives the handler, e.g. the recycling or the default resource.
+    explicit handler_allocator(std::pmr::memory_resource * resource) noexcept : resource_(resource) {}
+    /// Copy the resource wrapping a custom allocator.
+    explicit handler_allocator(const detail::copyable_resource & custom)
+        : owned_(custom.copy_to(storage_, sizeof(storage_))), resource_(owned_)
+    {
+    }
+
+    handler_allocator(const handler_allocator & lhs)
+        : owned_(lhs.owned_ ? lhs.owned_->copy_to(storage_, sizeof(storage_)) : nullptr),
+          resource_(owned_ ? owned_ : lhs.resource_)
+    {
+    }
+    handler_allocator& operator=(const handler_allocator &) = delete;
+
+    ~handler_allocator()
+    {
+        if (owned_)
+            owned_->release(storage_);
+    }
+
+    std::pmr::memory_resource * resource() const noexcept {return resource_;}
+    operator std::pmr::polymorphic_allocator<void>() const noexcept {return resource_;}
+
+  private:
+    detail::copyable_resource * owned_ = nullptr;
+    std::pmr::memory_resource * resource_;
+    alignas(std::max_align_t) unsigned char storage_[PIO_HANDLER_ALLOCATOR_SIZE];
+};
+
+/// The size of the inline storage of a `handler_type`.
+/**
+ * Handlers whose type-erased implementation fits into this many bytes are stored
+ * inside the `handler_type` itself and don't need an allocation.
+ * Define it before including any pio header to change the default.
+ */
+#if !defined(PIO_HANDLER_BUFFER_SIZE)
+#define PIO_HANDLER_BUFFER_SIZE (16 * sizeof(void*))
+#endif
+
+template<typename Signature, std::size_t BufferSize = PIO_HANDLER_BUFFER_SIZE>
 struct handler_type;
 
-template<typename ... Args>
-struct handler_type<void(Args...)>
+template<std::size_t BufferSize, typename ... Args>
+struct handler_type<void(Args...), BufferSize>
 {
     struct base
     {
@@ -63,6 +161,7 @@ struct handler_type<void(Args...)>
 
         using allocator_type = std::pmr::polymorphic_allocator<void>;
         virtual allocator_type get_allocator() const = 0;
+        virtual handler_allocator get_handler_allocator() const = 0;
 
         using executor_type = asio::any_io_executor;
         virtual executor_type get_executor() const = 0;
@@ -70,24 +169,49 @@ struct handler_type<void(Args...)>
         using cancellation_slot_type = asio::cancellation_slot;
         virtual cancellation_slot_type get_cancellation_slot() const = 0;
 
+        // moves the implementation into storage if it's stored inline, otherwise just hands over the pointer.
+        virtual base * move_to(void * storage) noexcept = 0;
         virtual void destroy() = 0;
         ~base() = default;
     };
 
+    template<class Handler>
+    struct impl;
+
+    /// Whether a Handler will be stored inline, i.e. without allocating.
+    template<typename Handler>
+    constexpr static bool stores_inline =
+               sizeof(impl<std::decay_t<Handler>>) <= BufferSize
+            && alignof(impl<std::decay_t<Handler>>) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible_v<std::decay_t<Handler>>;
+
     template<class Handler>
     struct impl : base
     {
-        using allocator_type_actual = asio::associated_allocator_t<Handler>;
+        // handlers without an associated allocator use the thread-local recycling allocator.
+        using allocator_type_actual = asio::associated_allocator_t<Handler, recycling_allocator<void>>;
 
         using allocator_type = std::pmr::polymorphic_allocator<void>;
         allocator_type get_allocator() const override
         {
-            if (std::is_same<allocator_type_actual, std::allocator<void>>::value)
+            if constexpr (std::is_same<allocator_type_actual, recycling_allocator<void>>::value)
+                return allocator_type(recycling_resource());
+            else if constexpr (std::is_same<allocator_type_actual, std::allocator<void>>::value)
                 return allocator_type {};
             else
                 return allocator_type(&alloc);
         }
 
+        handler_allocator get_handler_allocator() const override
+        {
+            if constexpr (std::is_same<allocator_type_actual, recycling_allocator<void>>::value)
+                return handler_allocator(recycling_resource());
+            else if constexpr (std::is_same<allocator_type_actual, std::allocator<void>>::value)
+                return handler_allocator(std::pmr::get_default_resource());
+            else
+                return handler_allocator(alloc);
+        }
+
         using executor_type = asio::any_io_executor;
         executor_type get_executor() const override
         {
@@ -102,7 +226,7 @@ struct handler_type<void(Args...)>
 
         Handler handler;
         asio::any_io_executor default_executor;
-        mutable allocator_adaptor<allocator_type_actual> alloc{asio::get_associated_allocator(handler)};
+        mutable allocator_adaptor<allocator_type_actual> alloc{asio::get_associated_allocator(handler, recycling_allocator<void>{})};
 
         template<typename Handler_>
         impl(Handler_ && h, asio::any_io_executor exec)
@@ -118,6 +242,7 @@ struct handler_type<void(Args...)>
         {
         }
 
+        impl(impl && ) noexcept = default;
 
         virtual void invoke(Args... args)
         {
@@ -126,16 +251,40 @@ struct handler_type<void(Args...)>
             std::move(h)(std::move(args)...);
         }
 
+        base * move_to(void * storage) noexcept override
+        {
+            if constexpr (stores_inline<Handler>)
+            {
+                auto p = new (storage) impl(std::move(*this));
+                this->~impl();
+                return p;
+            }
+            else
+                return this;
+        }
+
         void destroy()
         {
-            auto alloc  = typename std::allocator_traits< allocator_type_actual >
-                                    ::template rebind_alloc< impl>(this->alloc.get_allocator());
-            using traits = std::allocator_traits< decltype(alloc) >;
-            this->~impl();
-            traits::deallocate(alloc, this, 1);
+            if constexpr (stores_inline<Handler>)
+                this->~impl();
+            else
+            {
+                auto alloc  = typename std::allocator_traits< allocator_type_actual >
+                                        ::template rebind_alloc< impl>(this->alloc.get_allocator());
+                using traits = std::allocator_traits< decltype(alloc) >;
+                this->~impl();
+                traits::deallocate(alloc, this, 1);
+            }
         }
     };
 
+    /// The associated allocator of the handler.
+    /**
+     * A custom allocator, e.g. one bound with `asio::bind_allocator`, is wrapped in a resource stored
+     * next to the handler. If the handler is stored inline, that resource moves with the `handler_type`,
+     * i.e. the returned allocator must not be used after this `handler_type` was moved or invoked.
+     * Use `get_handler_allocator` for memory that needs to outlive that.
+     */
     using allocator_type = std::pmr::polymorphic_allocator<void>;
     allocator_type get_allocator() const
     {
@@ -143,6 +292,13 @@ struct handler_type<void(Args...)>
         return impl_->get_allocator();
     }
 
+    /// A copy of the associated allocator, that stays valid after the handler was moved or invoked.
+    handler_allocator get_handler_allocator() const
+    {
+        assert(impl_);
+        return impl_->get_handler_allocator();
+    }
+
     using executor_type = asio::any_io_executor;
     executor_type get_executor() const
     {
@@ -161,53 +317,79 @@ struct handler_type<void(Args...)>
     void operator()(Args ... args)
     {
         assert(impl_);
-        impl_.release()->invoke(std::move(args)...);
+        std::exchange(impl_, nullptr)->invoke(std::move(args)...);
     }
 
-    struct deleter_t
+    template<typename Handler>
+    handler_type(Handler && handler, asio::any_io_executor exec)
+            : impl_(make(std::forward<Handler>(handler), std::move(exec)))
+    {}
+
+    handler_type(handler_type && lhs) noexcept
+        : impl_(lhs.impl_ ? std::exchange(lhs.impl_, nullptr)->move_to(&storage_) : nullptr)
     {
-        virtual void operator()(base * b)
+    }
+
+    handler_type& operator=(handler_type && lhs) noexcept
+    {
+        if (this != &lhs)
         {
-            if (b)
-                b->destroy();
+            reset();
+            if (lhs.impl_)
+                impl_ = std::exchange(lhs.impl_, nullptr)->move_to(&storage_);
         }
-    };
+        return *this;
+    }
 
-    std::unique_ptr<base, deleter_t> impl_;
+    ~handler_type()
+    {
+        reset();
+    }
 
+    /// Check if the handler_type holds a handler that hasn't been invoked yet.
+    explicit operator bool() const noexcept {return impl_ != nullptr;}
+
+  private:
+    void reset()
+    {
+        if (impl_)
+            std::exchange(impl_, nullptr)->destroy();
+    }
 
     template<typename Handler>
-    static std::unique_ptr<base, deleter_t> make(Handler && handler,
-                                                 asio::any_io_executor exec)
+    base * make(Handler && handler, asio::any_io_executor exec)
     {
-        auto halloc = asio::get_associated_allocator(handler);
         using impl_t = impl<std::decay_t<Handler>>;
-        auto alloc  = typename std::allocator_traits< decltype(halloc) >:: template rebind_alloc< impl_t >(halloc);
-        using traits = std::allocator_traits< decltype(alloc) >;
-        auto pmem   = traits::allocate(alloc, 1);
-        struct dealloc
+        if constexpr (stores_inline<Handler>)
+            return new (&storage_) impl_t(std::forward<Handler>(handler), std::move(exec));
+        else
         {
-            ~dealloc()
+            auto halloc = asio::get_associated_allocator(handler, recycling_allocator<void>{});
+            auto alloc  = typename std::allocator_traits< decltype(halloc) >:: template rebind_alloc< impl_t >(halloc);
+            using traits = std::allocator_traits< decltype(alloc) >;
+            auto pmem   = traits::allocate(alloc, 1);
+            struct dealloc
             {
+                ~dealloc()
+                {
 #if defined(__cpp_lib_uncaught_exceptions)
-                if (std::uncaught_exceptions() > 0)
+                    if (std::uncaught_exceptions() > 0)
 #else
                     if (std::uncaught_exception())
 #endif
-                    traits::deallocate(alloc_, pmem_, 1);
-            }
-            decltype(alloc) alloc_;
-            decltype(pmem) pmem_;
-        };
-
-        dealloc dc{halloc, pmem};
-        return std::unique_ptr<base, deleter_t>(new (pmem) impl_t(std::move(handler), std::move(exec)), deleter_t{});
+                        traits::deallocate(alloc_, pmem_, 1);
+                }
+                decltype(alloc) alloc_;
+                decltype(pmem) pmem_;
+            };
+
+            dealloc dc{alloc, pmem};
+            return new (pmem) impl_t(std::forward<Handler>(handler), std::move(exec));
+        }
     }
 
-    template<typename Handler>
-    handler_type(Handler && handler, asio::any_io_executor exec)
-            : impl_(make(std::forward<Handler>(handler), std::move(exec)))
-    {}
+    base * impl_ = nullptr;
+    alignas(std::max_align_t) unsigned char storage_[BufferSize];
 };
 
 using wait_handler = handler_type<void(std::error_code)>;
@@ -0,0 +1,119 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_MAPPED_FILE_HPP
+#define PIO_MAPPED_FILE_HPP
+
+#include <pio/buffer.hpp>
+#include <pio/concepts.hpp>
+
+#include <cstdint>
+#include <string>
+
+#if !defined(ASIO_WINDOWS)
+
+namespace pio
+{
+
+/// A read-only file mapped into memory, serving reads with `memcpy` instead of a syscall each.
+/**
+ * It implements the same read concepts as `random_access_file`, so code written against them can switch backends.
+ * Additionally `view` gives zero-copy access to the mapped data.
+ *
+ * The async reads copy right away and post the completion, i.e. a page fault blocks the initiating thread.
+ * Use `advise(advice::willneed)` to have the kernel read ahead.
+ *
+ * The mapping doesn't follow the file's size, call `remap` after it grew.
+ * Remapping invalidates all views and must not run concurrently with reads.
+ * Truncating the file while it's mapped makes reads of the lost range fault with `SIGBUS`.
+ */
+struct mapped_file final :
+        concepts::implements<
+                concepts::sync_random_access_read_device,
+                concepts::async_random_access_read_device,
+                concepts::closable>
+{
+    typedef asio::any_io_executor executor_type;
+    typedef int native_handle_type;
+
+    /// Access pattern hints, passed to `madvise(2)`.
+    enum class advice
+    {
+        normal,
+        sequential,
+        random,
+        willneed,
+        dontneed
+    };
+
+    explicit mapped_file(const executor_type& ex);
+    mapped_file(const executor_type& ex, const char* path);
+    mapped_file(const executor_type& ex, const std::string& path);
+    /// Takes ownership of the descriptor and maps the file.
+    mapped_file(const executor_type& ex, const native_handle_type& native_file);
+
+    mapped_file(mapped_file&& other) noexcept;
+    mapped_file& operator=(mapped_file&& other) noexcept;
+    ~mapped_file();
+
+                      void open(const char* path);
+    ASIO_SYNC_OP_VOID open(const char* path, asio::error_code& ec);
+                      void open(const std::string& path);
+    ASIO_SYNC_OP_VOID open(const std::string& path, asio::error_code& ec);
+
+                      void assign(const native_handle_type& native_file);
+    ASIO_SYNC_OP_VOID assign(const native_handle_type& native_file, asio::error_code& ec);
+
+    std::size_t read_some_at(std::uint64_t offset, const mutable_buffer & buffer) override;
+    std::size_t read_some_at(std::uint64_t offset, const mutable_buffer & buffer, asio::error_code& ec) override;
+    std::size_t read_some_at(std::uint64_t offset, std::span<const mutable_buffer> buffers) override;
+    std::size_t read_some_at(std::uint64_t offset, std::span<const mutable_buffer> buffers, asio::error_code& ec) override;
+
+    /// The mapped data from `offset`, up to `n` bytes. Empty past the end.
+    const_buffer view(std::uint64_t offset, std::size_t n) const noexcept;
+    /// All of the mapped data.
+    const_buffer data() const noexcept {return const_buffer(data_, static_cast<std::size_t>(size_));}
+    /// The size of the mapping, i.e. of the file when it was mapped last.
+    std::uint64_t size() const noexcept {return size_;}
+
+                      void advise(advice a);
+    ASIO_SYNC_OP_VOID advise(advice a, asio::error_code& ec);
+    /// Give a hint for a range of the file only.
+                      void advise(advice a, std::uint64_t offset, std::uint64_t length);
+    ASIO_SYNC_OP_VOID advise(advice a, std::uint64_t offset, std::uint64_t length, asio::error_code& ec);
+
+    /// Adjust the mapping to the current size of the file, returns the new size.
+    std::uint64_t remap();
+    std::uint64_t remap(asio::error_code& ec);
+
+    executor_type get_executor();
+
+    bool is_open() const override;
+    void close() override;
+    ASIO_SYNC_OP_VOID close(asio::error_code& ec) override;
+
+    native_handle_type native_handle();
+    /// Unmap the file and release ownership of the descriptor.
+    native_handle_type release();
+
+  private:
+    void async_read_some_at_impl(std::uint64_t offset, mutable_buffer buffer, handler_type<void(std::error_code, std::size_t)> && h) override;
+    void async_read_some_at_impl(std::uint64_t offset, std::span<const mutable_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h) override;
+
+    void unmap_() noexcept;
+
+    executor_type executor_;
+    native_handle_type fd_ = -1;
+    unsigned char * data_ = nullptr;
+    std::uint64_t size_ = 0u;
+};
+
+}
+
+#endif
+
+#endif //PIO_MAPPED_FILE_HPP
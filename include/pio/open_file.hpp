@@ -0,0 +1,175 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_OPEN_FILE_HPP
+#define PIO_OPEN_FILE_HPP
+
+#include <pio/direct_io.hpp>
+#include <pio/handler.hpp>
+#include <pio/random_access_file.hpp>
+#include <pio/stream_file.hpp>
+
+#include <asio/async_result.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#if !defined(ASIO_WINDOWS)
+
+namespace pio
+{
+
+/// The result of `async_stat`.
+struct file_status
+{
+    std::filesystem::file_type type = std::filesystem::file_type::none;
+    std::filesystem::perms permissions = std::filesystem::perms::unknown;
+    std::uint64_t size = 0u;
+    /// The bytes actually allocated on disk, less than `size` for sparse files.
+    std::uint64_t allocated = 0u;
+    /// The preferred size of an I/O.
+    std::size_t block_size = 0u;
+    std::chrono::system_clock::time_point last_write_time;
+};
+
+namespace detail
+{
+
+void async_open_stream_file_impl(const asio::any_io_executor & ex, std::string && path, asio::file_base::flags open_flags,
+                                 handler_type<void(std::error_code, stream_file)> && h);
+void async_open_random_access_file_impl(const asio::any_io_executor & ex, std::string && path, asio::file_base::flags open_flags,
+                                        bool direct, handler_type<void(std::error_code, random_access_file)> && h);
+void async_stat_impl(std::string && path, handler_type<void(std::error_code, file_status)> && h);
+void async_stat_impl(int fd, handler_type<void(std::error_code, file_status)> && h);
+// fails with `ec` or `bad_descriptor` if the file couldn't be released.
+void async_close_impl(int fd, std::error_code ec, handler_type<void(std::error_code)> && h);
+
+}
+
+/// Open a file on a helper thread, so a slow filesystem doesn't stall the executor.
+/**
+ * Completes with the opened file, or a closed one & the error. The file uses `ex`, which is also the default executor
+ * of the completion.
+ */
+template<typename CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, stream_file))
+async_open_stream_file(const asio::any_io_executor & ex, std::string path, asio::file_base::flags open_flags,
+                       CompletionToken && token)
+{
+    return asio::async_initiate<CompletionToken, void(std::error_code, stream_file)>(
+            [ex](auto handler, std::string path, asio::file_base::flags open_flags)
+            {
+                detail::async_open_stream_file_impl(ex, std::move(path), open_flags,
+                                                    handler_type<void(std::error_code, stream_file)>(std::move(handler), ex));
+            }, token, std::move(path), open_flags);
+}
+
+/// Open a file on a helper thread, so a slow filesystem doesn't stall the executor.
+template<typename CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, random_access_file))
+async_open_random_access_file(const asio::any_io_executor & ex, std::string path, asio::file_base::flags open_flags,
+                              CompletionToken && token)
+{
+    return asio::async_initiate<CompletionToken, void(std::error_code, random_access_file)>(
+            [ex](auto handler, std::string path, asio::file_base::flags open_flags)
+            {
+                detail::async_open_random_access_file_impl(ex, std::move(path), open_flags, false,
+                                                           handler_type<void(std::error_code, random_access_file)>(std::move(handler), ex));
+            }, token, std::move(path), open_flags);
+}
+
+/// Open a file for direct I/O on a helper thread.
+template<typename CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, random_access_file))
+async_open_random_access_file(const asio::any_io_executor & ex, std::string path, asio::file_base::flags open_flags,
+                              direct_io_t, CompletionToken && token)
+{
+    return asio::async_initiate<CompletionToken, void(std::error_code, random_access_file)>(
+            [ex](auto handler, std::string path, asio::file_base::flags open_flags)
+            {
+                detail::async_open_random_access_file_impl(ex, std::move(path), open_flags, true,
+                                                           handler_type<void(std::error_code, random_access_file)>(std::move(handler), ex));
+            }, token, std::move(path), open_flags);
+}
+
+/// Query the status of the file at `path` on a helper thread. Symlinks are followed.
+template<typename CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, file_status))
+async_stat(const asio::any_io_executor & ex, std::string path, CompletionToken && token)
+{
+    return asio::async_initiate<CompletionToken, void(std::error_code, file_status)>(
+            [ex](auto handler, std::string path)
+            {
+                detail::async_stat_impl(std::move(path), handler_type<void(std::error_code, file_status)>(std::move(handler), ex));
+            }, token, std::move(path));
+}
+
+/// Query the status of an open file on a helper thread. The file needs to stay open until it completes.
+template<typename CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, file_status))
+async_stat(random_access_file & file, CompletionToken && token)
+{
+    return asio::async_initiate<CompletionToken, void(std::error_code, file_status)>(
+            [&file](auto handler)
+            {
+                detail::async_stat_impl(file.native_handle(),
+                                        handler_type<void(std::error_code, file_status)>(std::move(handler), file.get_executor()));
+            }, token);
+}
+
+template<typename CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, file_status))
+async_stat(stream_file & file, CompletionToken && token)
+{
+    return asio::async_initiate<CompletionToken, void(std::error_code, file_status)>(
+            [&file](auto handler)
+            {
+                detail::async_stat_impl(file.native_handle(),
+                                        handler_type<void(std::error_code, file_status)>(std::move(handler), file.get_executor()));
+            }, token);
+}
+
+/// Close the file on a helper thread, e.g. because closing flushes data to a network filesystem.
+/**
+ * The file is released right away, i.e. it's closed when the initiating function returns and
+ * all its outstanding operations complete with `asio::error::operation_aborted`.
+ */
+template<typename CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code))
+async_close(random_access_file & file, CompletionToken && token)
+{
+    return asio::async_initiate<CompletionToken, void(std::error_code)>(
+            [&file](auto handler)
+            {
+                auto exec = file.get_executor();
+                std::error_code ec;
+                const int fd = file.is_open() ? file.release(ec) : -1;
+                detail::async_close_impl(fd, ec, handler_type<void(std::error_code)>(std::move(handler), exec));
+            }, token);
+}
+
+template<typename CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code))
+async_close(stream_file & file, CompletionToken && token)
+{
+    return asio::async_initiate<CompletionToken, void(std::error_code)>(
+            [&file](auto handler)
+            {
+                auto exec = file.get_executor();
+                std::error_code ec;
+                const int fd = file.is_open() ? file.release(ec) : -1;
+                detail::async_close_impl(fd, ec, handler_type<void(std::error_code)>(std::move(handler), exec));
+            }, token);
+}
+
+}
+
+#endif
+
+#endif //PIO_OPEN_FILE_HPP
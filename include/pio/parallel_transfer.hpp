@@ -0,0 +1,103 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_PARALLEL_TRANSFER_HPP
+#define PIO_PARALLEL_TRANSFER_HPP
+
+#include <pio/concepts.hpp>
+#include <pio/handler.hpp>
+
+#include <asio/async_result.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pio
+{
+
+/// Tuning of `async_parallel_read_at` & `async_parallel_write_at`.
+struct parallel_transfer_options
+{
+    /// The bytes of a single read or write. Needs to meet the device's alignment for direct I/O.
+    std::size_t chunk_size = 1024u * 1024u;
+    /// The number of chunks in flight at once.
+    std::size_t depth = 16u;
+};
+
+namespace detail
+{
+
+void async_parallel_read_at_impl(concepts::async_random_access_read_device & d, std::uint64_t offset,
+                                 mutable_buffer buffer, parallel_transfer_options options,
+                                 handler_type<void(std::error_code, std::size_t)> && h);
+
+void async_parallel_write_at_impl(concepts::async_random_access_write_device & d, std::uint64_t offset,
+                                  const_buffer buffer, parallel_transfer_options options,
+                                  handler_type<void(std::error_code, std::size_t)> && h);
+
+}
+
+/// Read the whole buffer, with up to `depth` reads of `chunk_size` bytes in flight at once.
+/**
+ * Unlike `async_read_at`, which waits for every read before starting the next, this keeps the device's queue filled.
+ * After an error no new chunks are started & the operation completes once the ones in flight did.
+ *
+ * Completes with the bytes transferred up to the first gap, i.e. the data in `[0, n)` is valid.
+ * The error is the one of the chunk at that gap, e.g. `asio::error::eof` if the device is shorter.
+ *
+ * Cancellation stops starting new chunks and completes with `asio::error::operation_aborted`.
+ */
+template<typename CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, std::size_t))
+async_parallel_read_at(concepts::async_random_access_read_device & d, std::uint64_t offset, mutable_buffer buffer,
+                       parallel_transfer_options options, CompletionToken && token)
+{
+    return asio::async_initiate<CompletionToken, void(std::error_code, std::size_t)>(
+            [&d](auto handler, std::uint64_t offset, mutable_buffer buffer, parallel_transfer_options options)
+            {
+                detail::async_parallel_read_at_impl(d, offset, buffer, options,
+                                                    handler_type<void(std::error_code, std::size_t)>(std::move(handler), d.get_executor()));
+            }, token, offset, buffer, options);
+}
+
+template<typename CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, std::size_t))
+async_parallel_read_at(concepts::async_random_access_read_device & d, std::uint64_t offset, mutable_buffer buffer,
+                       CompletionToken && token)
+{
+    return async_parallel_read_at(d, offset, buffer, parallel_transfer_options{}, std::forward<CompletionToken>(token));
+}
+
+/// Write the whole buffer, with up to `depth` writes of `chunk_size` bytes in flight at once.
+/**
+ * The chunks may reach the device in any order. Completes like `async_parallel_read_at`,
+ * i.e. with the bytes written up to the first gap.
+ */
+template<typename CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, std::size_t))
+async_parallel_write_at(concepts::async_random_access_write_device & d, std::uint64_t offset, const_buffer buffer,
+                        parallel_transfer_options options, CompletionToken && token)
+{
+    return asio::async_initiate<CompletionToken, void(std::error_code, std::size_t)>(
+            [&d](auto handler, std::uint64_t offset, const_buffer buffer, parallel_transfer_options options)
+            {
+                detail::async_parallel_write_at_impl(d, offset, buffer, options,
+                                                     handler_type<void(std::error_code, std::size_t)>(std::move(handler), d.get_executor()));
+            }, token, offset, buffer, options);
+}
+
+template<typename CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, std::size_t))
+async_parallel_write_at(concepts::async_random_access_write_device & d, std::uint64_t offset, const_buffer buffer,
+                        CompletionToken && token)
+{
+    return async_parallel_write_at(d, offset, buffer, parallel_transfer_options{}, std::forward<CompletionToken>(token));
+}
+
+}
+
+#endif //PIO_PARALLEL_TRANSFER_HPP
@@ -0,0 +1,72 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_PREFETCHING_READ_STREAM_HPP
+#define PIO_PREFETCHING_READ_STREAM_HPP
+
+#include <pio/concepts.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pio
+{
+
+namespace detail
+{
+struct prefetch_state;
+}
+
+/// A sequential read stream over a random access device, that keeps reads in flight ahead of the consumer.
+/**
+ * The device is read in blocks of `block_size` from a ring of up to `max_depth` blocks,
+ * and `async_read_some` is served from blocks already fetched.
+ *
+ * The window starts at `min_depth` blocks. It doubles whenever the consumer has to wait for data,
+ * and shrinks by one block whenever the whole window was fetched before the consumer got to it.
+ *
+ * The reads need positions to be in flight concurrently, so the stream reads a random access device
+ * (e.g. a `random_access_file` opened on the same path as a `stream_file`) from `offset` on.
+ *
+ * Like the other io objects it is not thread-safe, the prefetches complete on the executor of the device.
+ * Only one `async_read_some` may be outstanding at a time, it completes with `asio::error::operation_aborted`
+ * if the stream is destroyed first. Prefetches still in flight at destruction are left to complete on their own.
+ */
+struct prefetching_read_stream final : concepts::implements<concepts::async_read_stream>
+{
+    struct options
+    {
+        std::size_t block_size = 128u * 1024u;
+        std::size_t min_depth = 2u;
+        std::size_t max_depth = 16u;
+    };
+
+    explicit prefetching_read_stream(concepts::async_random_access_read_device & device, std::uint64_t offset = 0u);
+    prefetching_read_stream(concepts::async_random_access_read_device & device, std::uint64_t offset, options opts);
+
+    prefetching_read_stream(prefetching_read_stream && lhs) noexcept;
+    prefetching_read_stream& operator=(prefetching_read_stream && lhs) noexcept;
+    ~prefetching_read_stream();
+
+    executor_type get_executor() override;
+
+    /// The position in the device of the next byte delivered to the consumer.
+    std::uint64_t position() const;
+    /// The current number of blocks fetched ahead.
+    std::size_t depth() const;
+
+  private:
+    void async_read_some_impl(const mutable_buffer & buffer, handler_type<void(std::error_code, std::size_t)> && h) override;
+    void async_read_some_impl(std::span<const mutable_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h) override;
+
+    void destroy_() noexcept;
+    detail::prefetch_state * state_;
+};
+
+}
+
+#endif //PIO_PREFETCHING_READ_STREAM_HPP
@@ -11,6 +11,7 @@
 #include <asio/random_access_file.hpp>
 #include <pio/buffer.hpp>
 #include <pio/concepts.hpp>
+#include <pio/direct_io.hpp>
 
 namespace pio 
 {
@@ -21,6 +22,7 @@ struct random_access_file final :
                 concepts::sync_random_access_write_device,
                 concepts::async_random_access_read_device,
                 concepts::async_random_access_write_device,
+                concepts::async_syncable_device,
                 concepts::cancellable,
                 concepts::closable>,
         asio::file_base
@@ -61,6 +63,17 @@ struct random_access_file final :
     : random_access_file(context.get_executor(), path, open_flags)
     {}
 
+  /// Open the file for direct I/O, bypassing the page cache.
+  /**
+   * All reads & writes then need to meet `alignment()`, misaligned ones fail with `asio::error::invalid_argument`
+   * before reaching the kernel. Use an `aligned_allocator` or a `buffer_pool` with that alignment for the buffers.
+   *
+   * The read of the last block is short if the file size isn't aligned. A misaligned read at or past the end
+   * fails with `asio::error::eof` instead, so `read_at` & `async_read_at` end with eof after that short read.
+   */
+  random_access_file(const executor_type& ex, const char* path, file_base::flags open_flags, direct_io_t);
+  random_access_file(const executor_type& ex, const std::string& path, file_base::flags open_flags, direct_io_t);
+
   random_access_file(const executor_type& ex, const native_handle_type& native_file);
 
   template <typename ExecutionContext>
@@ -78,10 +91,14 @@ struct random_access_file final :
 
   std::size_t write_some_at(std::uint64_t offset, const const_buffer & buffers) override;
   std::size_t write_some_at(std::uint64_t offset, const const_buffer & buffers, asio::error_code& ec) override;
+  std::size_t write_some_at(std::uint64_t offset, std::span<const const_buffer> buffers) override;
+  std::size_t write_some_at(std::uint64_t offset, std::span<const const_buffer> buffers, asio::error_code& ec) override;
 
 
   std::size_t read_some_at(std::uint64_t offset, const mutable_buffer & buffers) override;
   std::size_t read_some_at(std::uint64_t offset, const mutable_buffer & buffers, asio::error_code& ec) override;
+  std::size_t read_some_at(std::uint64_t offset, std::span<const mutable_buffer> buffers) override;
+  std::size_t read_some_at(std::uint64_t offset, std::span<const mutable_buffer> buffers, asio::error_code& ec) override;
 
   executor_type get_executor();
 
@@ -97,13 +114,25 @@ struct random_access_file final :
 
   native_handle_type native_handle();
 
+  /// The alignment required by reads & writes, if the file was opened for direct I/O.
+  io_alignment alignment() const {return alignment_;}
+
   native_handle_type release();
   native_handle_type release(asio::error_code & ec);
 private:
 
   void async_read_some_at_impl (std::uint64_t offset, mutable_buffer buffer, handler_type<void(std::error_code, std::size_t)> && h) override;
   void async_write_some_at_impl(std::uint64_t offset,   const_buffer buffer, handler_type<void(std::error_code, std::size_t)> && h) override;
+  void async_read_some_at_impl (std::uint64_t offset, std::span<const mutable_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h) override;
+  void async_write_some_at_impl(std::uint64_t offset, std::span<const   const_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h) override;
+  // run on a helper thread pool, the file needs to stay open until they complete.
+  void async_sync_impl(handler_type<void(std::error_code)> && h) override;
+  void async_data_sync_impl(handler_type<void(std::error_code)> && h) override;
+  void async_sync_range_impl(std::uint64_t offset, std::uint64_t length, handler_type<void(std::error_code)> && h) override;
+  void update_alignment_();
+
   asio::random_access_file impl_;
+  io_alignment alignment_;
 };
     
 }
@@ -10,14 +10,13 @@
 
 #include <pio/concepts.hpp>
 #include <pio/buffer.hpp>
+#include <pio/completion_condition.hpp>
+#include <pio/segmented_buffer.hpp>
 #include <asio/streambuf.hpp>
-#include <functional>
 
 namespace pio
 {
 
-using completion_condition_t = std::function<std::size_t(const asio::error_code &error, std::size_t bytes_transferred)>;
-
 
 std::size_t read(concepts::sync_read_stream& s, const asio::mutable_buffer& buffers);
 std::size_t read(concepts::sync_read_stream& s, const asio::mutable_buffer& buffers, asio::error_code& ec);
@@ -26,6 +25,12 @@ std::size_t read(concepts::sync_read_stream& s, const asio::mutable_buffer& buff
 std::size_t read(concepts::sync_read_stream& s, const asio::mutable_buffer& buffers, completion_condition_t completion_condition);
 std::size_t read(concepts::sync_read_stream& s, const asio::mutable_buffer& buffers, completion_condition_t completion_condition, asio::error_code& ec);
 
+std::size_t read(concepts::sync_read_stream& s, std::span<const asio::mutable_buffer> buffers);
+std::size_t read(concepts::sync_read_stream& s, std::span<const asio::mutable_buffer> buffers, asio::error_code& ec);
+
+std::size_t read(concepts::sync_read_stream& s, std::span<const asio::mutable_buffer> buffers, completion_condition_t completion_condition);
+std::size_t read(concepts::sync_read_stream& s, std::span<const asio::mutable_buffer> buffers, completion_condition_t completion_condition, asio::error_code& ec);
+
 std::size_t read(concepts::sync_read_stream& s, dynamic_buffer buffers);
 std::size_t read(concepts::sync_read_stream& s, dynamic_buffer buffers, asio::error_code& ec);
 
@@ -39,15 +44,25 @@ std::size_t read(concepts::sync_read_stream& s, asio::streambuf & buffers, asio:
 std::size_t read(concepts::sync_read_stream& s, asio::streambuf & buffers, completion_condition_t completion_condition);
 std::size_t read(concepts::sync_read_stream& s, asio::streambuf & buffers, completion_condition_t completion_condition, asio::error_code& ec);
 
+std::size_t read(concepts::sync_read_stream& s, segmented_buffer & buffers);
+std::size_t read(concepts::sync_read_stream& s, segmented_buffer & buffers, asio::error_code& ec);
+
+std::size_t read(concepts::sync_read_stream& s, segmented_buffer & buffers, completion_condition_t completion_condition);
+std::size_t read(concepts::sync_read_stream& s, segmented_buffer & buffers, completion_condition_t completion_condition, asio::error_code& ec);
+
 namespace detail
 {
 
     void async_read_impl(concepts::async_read_stream& s, const asio::mutable_buffer& buffers,                                              handler_type<void(asio::error_code, std::size_t)> && h);
     void async_read_impl(concepts::async_read_stream& s, const asio::mutable_buffer& buffers, completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h);
+    void async_read_impl(concepts::async_read_stream& s, std::span<const asio::mutable_buffer> buffers,                                              handler_type<void(asio::error_code, std::size_t)> && h);
+    void async_read_impl(concepts::async_read_stream& s, std::span<const asio::mutable_buffer> buffers, completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h);
     void async_read_impl(concepts::async_read_stream& s, pio::dynamic_buffer buffers,                                              handler_type<void(asio::error_code, std::size_t)> && h);
     void async_read_impl(concepts::async_read_stream& s, pio::dynamic_buffer buffers, completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h);
     void async_read_impl(concepts::async_read_stream& s, asio::streambuf &buffer,                                              handler_type<void(asio::error_code, std::size_t)> && h);
     void async_read_impl(concepts::async_read_stream& s, asio::streambuf &buffer, completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h);
+    void async_read_impl(concepts::async_read_stream& s, segmented_buffer &buffer,                                              handler_type<void(asio::error_code, std::size_t)> && h);
+    void async_read_impl(concepts::async_read_stream& s, segmented_buffer &buffer, completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h);
 
 }
 
@@ -69,7 +84,7 @@ ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
                                                     declval<detail::initiate_async_read<concepts::async_read_stream> >(),
                                                     token, buffers, transfer_all())))
 {
-    return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+    return asio::async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
             [](auto handler, concepts::async_read_stream& d, const asio::mutable_buffer& buffers)
             {
                 detail::async_read_impl(d, buffers, handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
@@ -91,7 +106,7 @@ ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
                                                     token, buffers,
                                                     ASIO_MOVE_CAST(completion_condition_t)(completion_condition))))
 {
-    return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+    return asio::async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
             [](auto handler,
                concepts::async_read_stream& d,
                const asio::mutable_buffer& buffers, completion_condition_t completion_condition)
@@ -100,6 +115,43 @@ ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
             }, token, s, buffers, std::move(completion_condition));
 }
 
+template <
+        ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
+                                          std::size_t)) WriteToken
+        ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(
+                typename concepts::async_read_stream::executor_type)>
+ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(WriteToken,
+                                    void (asio::error_code, std::size_t))
+async_read(concepts::async_read_stream& s, std::span<const asio::mutable_buffer> buffers,
+            ASIO_MOVE_ARG(WriteToken) token
+            ASIO_DEFAULT_COMPLETION_TOKEN(
+                    typename concepts::async_read_stream::executor_type))
+{
+    return asio::async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+            [](auto handler, concepts::async_read_stream& d, std::span<const asio::mutable_buffer> buffers)
+            {
+                detail::async_read_impl(d, buffers, handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
+            }, token, s, buffers);
+}
+
+template <
+        ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
+                                          std::size_t)) WriteToken>
+ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(WriteToken,
+                                    void (asio::error_code, std::size_t))
+async_read(concepts::async_read_stream& s, std::span<const asio::mutable_buffer> buffers,
+            completion_condition_t completion_condition,
+            ASIO_MOVE_ARG(WriteToken) token)
+{
+    return asio::async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+            [](auto handler,
+               concepts::async_read_stream& d,
+               std::span<const asio::mutable_buffer> buffers, completion_condition_t completion_condition)
+            {
+                detail::async_read_impl(d, buffers, std::move(completion_condition), handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
+            }, token, s, buffers, std::move(completion_condition));
+}
+
 template <
         ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
                                           std::size_t)) WriteToken
@@ -119,7 +171,7 @@ ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
                                                     token, std::declval<dynamic_buffer>(),
                                                     transfer_all())))
 {
-    return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+    return asio::async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
             [](auto handler,
                concepts::async_read_stream& d, dynamic_buffer buffers)
             {
@@ -143,7 +195,7 @@ ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
                                                     token, std::declval<dynamic_buffer>(),
                                                     ASIO_MOVE_CAST(completion_condition_t)(completion_condition))))
 {
-    return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+    return asio::async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
             [](auto handler,
                concepts::async_read_stream& d,
                dynamic_buffer buffers, completion_condition_t completion_condition)
@@ -167,7 +219,7 @@ ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
                                             async_read(s, basic_streambuf_ref<Allocator>(b),
                                                         ASIO_MOVE_CAST(WriteToken)(token))))
 {
-    return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+    return asio::async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
             [](auto handler,
                concepts::async_read_stream& d, asio::streambuf& b)
             {
@@ -189,7 +241,7 @@ ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
                                                         ASIO_MOVE_CAST(completion_condition_t)(completion_condition),
                                                         ASIO_MOVE_CAST(WriteToken)(token))))
 {
-    return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+    return asio::async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
             [](auto handler,
                concepts::async_read_stream& d,
                asio::streambuf& b, completion_condition_t completion_condition)
@@ -198,6 +250,36 @@ ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
             }, token, s, b, std::move(completion_condition));
 }
 
+template <ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code, std::size_t)) CompletionToken
+            ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(typename concepts::async_read_stream::executor_type)>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void (asio::error_code, std::size_t))
+async_read(concepts::async_read_stream& s, segmented_buffer& b,
+           ASIO_MOVE_ARG(CompletionToken) token
+             ASIO_DEFAULT_COMPLETION_TOKEN(typename concepts::async_read_stream::executor_type))
+{
+    return asio::async_initiate<CompletionToken, void (asio::error_code, std::size_t)>(
+            [](auto handler,
+               concepts::async_read_stream& d, segmented_buffer& b)
+            {
+                detail::async_read_impl(d, b, handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
+            }, token, s, b);
+}
+
+template <ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code, std::size_t)) CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void (asio::error_code, std::size_t))
+async_read(concepts::async_read_stream& s, segmented_buffer& b,
+           completion_condition_t completion_condition,
+           ASIO_MOVE_ARG(CompletionToken) token)
+{
+    return asio::async_initiate<CompletionToken, void (asio::error_code, std::size_t)>(
+            [](auto handler,
+               concepts::async_read_stream& d,
+               segmented_buffer& b, completion_condition_t completion_condition)
+            {
+                detail::async_read_impl(d, b, std::move(completion_condition), handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
+            }, token, s, b, std::move(completion_condition));
+}
+
 }
 
 #endif //PIO_READ_HPP
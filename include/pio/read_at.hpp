@@ -10,14 +10,12 @@
 
 #include <pio/concepts.hpp>
 #include <pio/buffer.hpp>
+#include <pio/completion_condition.hpp>
 #include <asio/streambuf.hpp>
-#include <functional>
 
 namespace pio
 {
 
-using completion_condition_t = std::function<std::size_t(const asio::error_code &error, std::size_t bytes_transferred)>;
-
 
 std::size_t read_at(concepts::sync_random_access_read_device& d,
                      uint64_t offset, const mutable_buffer & buffers);
@@ -32,6 +30,20 @@ std::size_t read_at(concepts::sync_random_access_read_device& d,
 std::size_t read_at(concepts::sync_random_access_read_device& d,
                      uint64_t offset, const mutable_buffer & buffers,
                      completion_condition_t completion_condition, asio::error_code& ec);
+std::size_t read_at(concepts::sync_random_access_read_device& d,
+                     uint64_t offset, std::span<const mutable_buffer> buffers);
+std::size_t read_at(concepts::sync_random_access_read_device& d,
+                     uint64_t offset, std::span<const mutable_buffer> buffers,
+                     asio::error_code& ec);
+
+std::size_t read_at(concepts::sync_random_access_read_device& d,
+                     uint64_t offset, std::span<const mutable_buffer> buffers,
+                     completion_condition_t completion_condition);
+
+std::size_t read_at(concepts::sync_random_access_read_device& d,
+                     uint64_t offset, std::span<const mutable_buffer> buffers,
+                     completion_condition_t completion_condition, asio::error_code& ec);
+
 std::size_t read_at(concepts::sync_random_access_read_device& d,
                      uint64_t offset, asio::streambuf& b);
 
@@ -57,6 +69,15 @@ void async_read_at_impl(
         const mutable_buffer & buffers, completion_condition_t completion_condition,
         handler_type<void(asio::error_code, std::size_t)> && h);
 
+void async_read_at_impl(
+        concepts::async_random_access_read_device& d, uint64_t offset,
+        std::span<const mutable_buffer> buffers, handler_type<void(asio::error_code, std::size_t)> && h);
+
+void async_read_at_impl(
+        concepts::async_random_access_read_device& d, uint64_t offset,
+        std::span<const mutable_buffer> buffers, completion_condition_t completion_condition,
+        handler_type<void(asio::error_code, std::size_t)> && h);
+
 
 void async_read_at_impl(
         concepts::async_random_access_read_device& d, uint64_t offset,
@@ -90,7 +111,7 @@ async_read_at(concepts::async_random_access_read_device& d, uint64_t offset,
     return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
             [](auto handler,
                concepts::async_random_access_read_device& d, uint64_t offset,
-               asio::streambuf& b, const mutable_buffer & buffers)
+               const mutable_buffer & buffers)
             {
                 detail::async_read_at_impl(d, offset, std::move(buffers), handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
             }, token,
@@ -119,7 +140,7 @@ async_read_at(concepts::async_random_access_read_device& d, uint64_t offset,
     return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
             [](auto handler,
                concepts::async_random_access_read_device& d, uint64_t offset,
-               asio::streambuf& b, const mutable_buffer & buffers,
+               const mutable_buffer & buffers,
                completion_condition_t completion_condition)
             {
                 detail::async_read_at_impl(d, offset, std::move(buffers),
@@ -129,6 +150,54 @@ async_read_at(concepts::async_random_access_read_device& d, uint64_t offset,
 }
 
 
+template <ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
+      std::size_t)) WriteToken
+        ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(
+          typename concepts::async_random_access_read_device::executor_type)>
+ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(WriteToken,
+    void (asio::error_code, std::size_t))
+async_read_at(concepts::async_random_access_read_device& d, uint64_t offset,
+    std::span<const mutable_buffer> buffers,
+    ASIO_MOVE_ARG(WriteToken) token
+      ASIO_DEFAULT_COMPLETION_TOKEN(
+        typename concepts::async_random_access_read_device::executor_type))
+{
+    return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+            [](auto handler,
+               concepts::async_random_access_read_device& d, uint64_t offset,
+               std::span<const mutable_buffer> buffers)
+            {
+                detail::async_read_at_impl(d, offset, buffers, handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
+            }, token,
+            d, offset, buffers);
+}
+
+template <ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
+      std::size_t)) WriteToken
+        ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(
+          typename concepts::async_random_access_read_device::executor_type)>
+ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(WriteToken,
+    void (asio::error_code, std::size_t))
+async_read_at(concepts::async_random_access_read_device& d, uint64_t offset,
+    std::span<const mutable_buffer> buffers,
+    completion_condition_t completion_condition,
+    ASIO_MOVE_ARG(WriteToken) token
+      ASIO_DEFAULT_COMPLETION_TOKEN(
+        typename concepts::async_random_access_read_device::executor_type))
+{
+    return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+            [](auto handler,
+               concepts::async_random_access_read_device& d, uint64_t offset,
+               std::span<const mutable_buffer> buffers,
+               completion_condition_t completion_condition)
+            {
+                detail::async_read_at_impl(d, offset, buffers,
+                                            std::move(completion_condition), handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
+            }, token,
+            d, offset, buffers, std::move(completion_condition));
+}
+
+
 template <ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
       std::size_t)) WriteToken
         ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(
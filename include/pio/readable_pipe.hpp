@@ -9,6 +9,10 @@
 #define PIO_READABLE_PIPE_HPP
 
 #include <asio/readable_pipe.hpp>
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+#include <asio/posix/stream_descriptor.hpp>
+#include <memory>
+#endif
 #include <pio/buffer.hpp>
 #include <pio/concepts.hpp>
 
@@ -54,6 +58,8 @@ struct readable_pipe final :
 
   std::size_t read_some(const mutable_buffer & buffers) override;
   std::size_t read_some(const mutable_buffer & buffers, asio::error_code& ec) override;
+  std::size_t read_some(std::span<const mutable_buffer> buffers) override;
+  std::size_t read_some(std::span<const mutable_buffer> buffers, asio::error_code& ec) override;
   executor_type get_executor();
 
   bool is_open() const override;
@@ -76,7 +82,15 @@ struct readable_pipe final :
   native_handle_type release(asio::error_code & ec);
 private:
   void async_read_some_impl(const asio::mutable_buffer &buffer, handler_type<void(std::error_code, std::size_t)> && h) override;
+  void async_read_some_impl(std::span<const asio::mutable_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h) override;
   asio::readable_pipe impl_;
+  void reset_waiter_();
+  void cancel_waiter_();
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+  // waits for readiness before leasing a block from the pool.
+  void async_read_some_impl(buffer_pool & pool, handler_type<void(std::error_code, leased_buffer)> && h) override;
+  std::shared_ptr<asio::posix::stream_descriptor> waiter_;
+#endif
 };
 
 }
@@ -0,0 +1,56 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_RECYCLING_ALLOCATOR_HPP
+#define PIO_RECYCLING_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace pio
+{
+
+/// A memory resource that caches freed blocks per thread.
+/**
+ * Blocks are grouped into power-of-two size classes from 64 bytes up to 8 KiB,
+ * and each thread keeps a small number of blocks per class.
+ * Larger or over-aligned requests go directly to the global allocator.
+ *
+ * The returned resource is shared by all threads and never destroyed,
+ * so memory can be freed on a different thread than the one allocating it.
+ */
+std::pmr::memory_resource * recycling_resource() noexcept;
+
+/// A stateless allocator using the recycling_resource().
+template<typename T>
+struct recycling_allocator
+{
+    using value_type = T;
+
+    recycling_allocator() noexcept = default;
+    template<typename U>
+    recycling_allocator(const recycling_allocator<U> &) noexcept {}
+
+    T * allocate(std::size_t n)
+    {
+        return static_cast<T*>(recycling_resource()->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T * p, std::size_t n)
+    {
+        recycling_resource()->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    template<typename U>
+    bool operator==(const recycling_allocator<U> &) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const recycling_allocator<U> &) const noexcept { return false; }
+};
+
+}
+
+#endif //PIO_RECYCLING_ALLOCATOR_HPP
@@ -0,0 +1,156 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_REGISTERED_BUFFER_POOL_HPP
+#define PIO_REGISTERED_BUFFER_POOL_HPP
+
+#include <asio/any_io_executor.hpp>
+#include <asio/registered_buffer.hpp>
+#include <asio/buffer_registration.hpp>
+#include <pio/buffer.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace pio
+{
+
+struct registered_buffer_pool;
+
+namespace detail
+{
+struct registered_buffer_registry;
+}
+
+/// A block leased from a `registered_buffer_pool`, returned to the pool on destruction.
+/**
+ * It converts to `mutable_buffer`, so it can be passed to any operation. The file objects detect
+ * that a buffer (or any part of it) lies in a registered block and use the fixed-buffer operations
+ * (`IORING_OP_READ_FIXED`/`IORING_OP_WRITE_FIXED`), which skip pinning the pages on every submission.
+ */
+struct registered_buffer
+{
+    registered_buffer() noexcept = default;
+    registered_buffer(registered_buffer && lhs) noexcept;
+    registered_buffer& operator=(registered_buffer && lhs) noexcept;
+    ~registered_buffer();
+
+    void * data() const noexcept {return buffer_.data();}
+    std::size_t size() const noexcept {return buffer_.size();}
+
+    mutable_buffer buffer() const noexcept {return buffer_;}
+    operator mutable_buffer() const noexcept {return buffer_;}
+    operator const_buffer() const noexcept {return buffer_;}
+
+    /// The asio representation, carrying the registration id.
+    asio::mutable_registered_buffer registered() const;
+
+    /// Check if the lease holds a block.
+    explicit operator bool() const noexcept {return pool_ != nullptr;}
+
+    /// Give the block back to the pool early.
+    void release() noexcept;
+
+  private:
+    friend struct registered_buffer_pool;
+    registered_buffer(registered_buffer_pool * pool, std::size_t index, mutable_buffer buffer) noexcept
+        : pool_(pool), index_(index), buffer_(buffer) {}
+
+    registered_buffer_pool * pool_ = nullptr;
+    std::size_t index_ = 0u;
+    mutable_buffer buffer_;
+};
+
+/// A slab of memory registered with the io_uring instance of an execution context.
+/**
+ * The slab is split into `block_count` blocks of `block_size` bytes. It is registered as few fixed buffers
+ * of whole blocks, each up to the 1 GiB io_uring accepts, so the block count isn't limited by the number of buffers
+ * the kernel accepts (`UIO_MAXIOV`). A range of the slab spanning two of those uses the regular operations.
+ * Only one set of buffers can be registered with an io_uring instance at a time,
+ * so there should be at most one pool per execution context.
+ *
+ * Without io_uring support the pool still hands out buffers, they're just used with the regular operations.
+ */
+struct registered_buffer_pool
+{
+    using executor_type = asio::any_io_executor;
+
+    /// The block size is rounded up to a multiple of 4 KiB, the slab is page aligned.
+    /// Throws `asio::error::invalid_argument` if either is zero, a block is larger than 1 GiB or the slab size overflows.
+    registered_buffer_pool(const executor_type & exec, std::size_t block_size, std::size_t block_count);
+
+    template <typename ExecutionContext>
+    registered_buffer_pool(ExecutionContext& context, std::size_t block_size, std::size_t block_count,
+      typename asio::constraint<
+        asio::is_convertible<ExecutionContext&, asio::execution_context&>::value,
+        asio::defaulted_constraint
+      >::type = asio::defaulted_constraint())
+    : registered_buffer_pool(context.get_executor(), block_size, block_count)
+    {
+    }
+
+    registered_buffer_pool(const registered_buffer_pool & ) = delete;
+    registered_buffer_pool& operator=(const registered_buffer_pool & ) = delete;
+    /// All leased buffers must be returned before the pool is destroyed.
+    /// Operations on other threads that look up a registration wait for the pool to be unregistered.
+    ~registered_buffer_pool();
+
+    executor_type get_executor() const {return executor_;}
+
+    std::size_t block_size() const noexcept {return block_size_;}
+    std::size_t block_count() const noexcept {return block_count_;}
+    /// The number of blocks that are not leased.
+    std::size_t available() const;
+
+    /// Lease a block, returns an empty `registered_buffer` if the pool is exhausted.
+    registered_buffer allocate();
+
+    /// Check if the memory lies in the slab of this pool.
+    bool owns(const void * data, std::size_t size) const noexcept;
+
+    /// Get the registered buffer for a range inside the slab, if it lies in it.
+    std::optional<asio::mutable_registered_buffer> find(const void * data, std::size_t size) const;
+
+  private:
+    friend struct registered_buffer;
+    friend struct detail::registered_buffer_registry;
+    void deallocate_(std::size_t index) noexcept;
+
+    executor_type executor_;
+    asio::execution_context & context_;
+    std::size_t block_size_;
+    std::size_t block_count_;
+    // the blocks per registered buffer.
+    std::size_t registration_blocks_;
+    struct slab_deleter
+    {
+        void operator()(unsigned char * p) const noexcept;
+    };
+    std::unique_ptr<unsigned char[], slab_deleter> slab_;
+    asio::buffer_registration<std::vector<mutable_buffer>> registration_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::size_t> free_;
+};
+
+namespace detail
+{
+
+// look up the pool registered with the context of exec owning the memory, used by the file objects.
+std::optional<asio::mutable_registered_buffer> find_registered_buffer(const asio::any_io_executor & exec,
+                                                                      const mutable_buffer & buffer);
+std::optional<asio::const_registered_buffer>   find_registered_buffer(const asio::any_io_executor & exec,
+                                                                      const const_buffer & buffer);
+
+}
+
+}
+
+#endif //PIO_REGISTERED_BUFFER_POOL_HPP
@@ -0,0 +1,132 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_RING_BUFFER_HPP
+#define PIO_RING_BUFFER_HPP
+
+#include <pio/buffer.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+#if !defined(ASIO_WINDOWS)
+
+namespace pio
+{
+
+/// A fixed-size ring buffer, that maps the same pages twice back-to-back.
+/**
+ * Because the second mapping mirrors the first one, the readable & the writable bytes are always
+ * a single contiguous buffer, even when they wrap around the end of the ring. Consuming only moves
+ * an offset, so a parser reading messages out of it never needs to move the remaining bytes to the front.
+ *
+ * It implements the DynamicBuffer_v1 interface and converts to a `pio::dynamic_buffer` referring to it,
+ * so it can be passed to `read`, `async_read` & friends directly.
+ * The capacity is rounded up to the page size and fixed, i.e. `max_size() == capacity()`.
+ */
+struct ring_buffer
+{
+    using const_buffers_type = const_buffer;
+    using mutable_buffers_type = mutable_buffer;
+
+    /// Creates the mapping, throws `std::system_error` if that fails.
+    explicit ring_buffer(std::size_t capacity);
+    ~ring_buffer();
+
+    ring_buffer(ring_buffer && lhs) noexcept;
+    ring_buffer& operator=(ring_buffer && lhs) noexcept;
+
+    ring_buffer(const ring_buffer &) = delete;
+    ring_buffer& operator=(const ring_buffer &) = delete;
+
+    std::size_t size() const noexcept {return size_;}
+    std::size_t max_size() const noexcept {return capacity_;}
+    std::size_t capacity() const noexcept {return capacity_;}
+
+    /// The readable bytes.
+    const_buffers_type data() const noexcept {return const_buffer(base_ + head_, size_);}
+
+    /// Make `n` bytes after the readable ones available for writing. Throws `std::length_error` if they don't fit.
+    mutable_buffers_type prepare(std::size_t n)
+    {
+        if (n > capacity_ - size_)
+            throw std::length_error("pio::ring_buffer too long");
+        return mutable_buffer(base_ + head_ + size_, n);
+    }
+    /// Move `n` bytes of the writable ones to the readable ones.
+    void commit(std::size_t n) noexcept {size_ += (std::min)(n, capacity_ - size_);}
+    /// Remove `n` bytes from the beginning of the readable ones.
+    void consume(std::size_t n) noexcept
+    {
+        n = (std::min)(n, size_);
+        size_ -= n;
+        // start over at the beginning when empty, to avoid needless wrapping.
+        head_ = size_ == 0u ? 0u : (head_ + n) % capacity_;
+    }
+    void clear() noexcept {consume(size_);}
+
+    // DynamicBuffer_v2
+    mutable_buffer data(std::size_t pos, std::size_t n) noexcept {return asio::buffer(asio::buffer(base_ + head_, size_) + pos, n);}
+    const_buffer data(std::size_t pos, std::size_t n) const noexcept {return asio::buffer(asio::buffer(base_ + head_, size_) + pos, n);}
+    void grow(std::size_t n)
+    {
+        if (n > capacity_ - size_)
+            throw std::length_error("pio::ring_buffer too long");
+        size_ += n;
+    }
+    void shrink(std::size_t n) noexcept {size_ -= (std::min)(n, size_);}
+
+    /// A `dynamic_buffer` referring to this ring. The ring needs to outlive it.
+    operator dynamic_buffer();
+
+  private:
+    unsigned char * base_ = nullptr;
+    std::size_t capacity_ = 0u;
+    std::size_t head_ = 0u;
+    std::size_t size_ = 0u;
+};
+
+namespace detail
+{
+
+// the copyable handle wrapped by the dynamic_buffer.
+struct ring_buffer_ref
+{
+    ring_buffer * ring;
+
+    using const_buffers_type = const_buffer;
+    using mutable_buffers_type = mutable_buffer;
+
+    std::size_t size() const noexcept {return ring->size();}
+    std::size_t max_size() const noexcept {return ring->max_size();}
+    std::size_t capacity() const noexcept {return ring->capacity();}
+
+    const_buffer data() const noexcept {return ring->data();}
+    mutable_buffer prepare(std::size_t n) {return ring->prepare(n);}
+    void commit(std::size_t n) noexcept {ring->commit(n);}
+
+    mutable_buffer data(std::size_t pos, std::size_t n) noexcept {return ring->data(pos, n);}
+    const_buffer data(std::size_t pos, std::size_t n) const noexcept {return std::as_const(*ring).data(pos, n);}
+    void grow(std::size_t n) {ring->grow(n);}
+    void shrink(std::size_t n) noexcept {ring->shrink(n);}
+    void consume(std::size_t n) noexcept {ring->consume(n);}
+};
+
+}
+
+inline ring_buffer::operator dynamic_buffer()
+{
+    return dynamic_buffer(detail::ring_buffer_ref{this});
+}
+
+}
+
+#endif
+
+#endif //PIO_RING_BUFFER_HPP
@@ -0,0 +1,88 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_SEGMENTED_BUFFER_HPP
+#define PIO_SEGMENTED_BUFFER_HPP
+
+#include <pio/buffer.hpp>
+
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace pio
+{
+
+/// A dynamic buffer made of fixed-size segments, so that it grows without reallocating & copying its content.
+/**
+ * The readable & writable regions are exposed as buffer sequences with one buffer per segment.
+ * Consumed segments are kept & reused by later `prepare` calls, so a buffer that's read into & written from
+ * in a loop stops allocating once it reached its working size. `shrink_to_fit` returns them to the memory resource.
+ *
+ * It follows the DynamicBuffer_v1 interface & is used like an `asio::streambuf`, i.e. `read` & `write` take it
+ * by reference and use the vectored stream operations. The sequences returned by `data` & `prepare`
+ * are invalidated by any modifying call.
+ */
+struct segmented_buffer
+{
+    using const_buffers_type = std::span<const const_buffer>;
+    using mutable_buffers_type = std::span<const mutable_buffer>;
+
+    explicit segmented_buffer(std::size_t segment_size = 64u * 1024u,
+                              std::size_t max_size = (std::numeric_limits<std::size_t>::max)(),
+                              std::pmr::memory_resource * resource = std::pmr::get_default_resource());
+    ~segmented_buffer();
+
+    segmented_buffer(const segmented_buffer &) = delete;
+    segmented_buffer& operator=(const segmented_buffer &) = delete;
+
+    std::size_t segment_size() const noexcept {return segment_size_;}
+
+    /// The bytes that can be read.
+    std::size_t size() const noexcept {return size_;}
+    std::size_t max_size() const noexcept {return max_size_;}
+    /// The bytes that can be held without allocating another segment.
+    std::size_t capacity() const noexcept;
+
+    /// The readable bytes, one buffer per segment.
+    const_buffers_type data() const;
+
+    /// Make room for `n` bytes after the readable ones. Throws `std::length_error` if that exceeds `max_size()`.
+    mutable_buffers_type prepare(std::size_t n);
+    /// Move `n` bytes of the last `prepare` to the readable bytes.
+    void commit(std::size_t n);
+    /// Remove `n` bytes from the beginning of the readable bytes & recycle the segments no longer used.
+    void consume(std::size_t n);
+
+    void clear();
+    /// Deallocate the recycled segments.
+    void shrink_to_fit();
+
+  private:
+    unsigned char * allocate_segment_();
+
+    std::size_t segment_size_;
+    std::size_t max_size_;
+    std::pmr::memory_resource * resource_;
+
+    std::deque<unsigned char*> segments_;
+    std::vector<unsigned char*> free_;
+    // the start of the readable bytes in the first segment.
+    std::size_t head_ = 0u;
+    std::size_t size_ = 0u;
+    std::size_t prepared_ = 0u;
+
+    mutable std::vector<const_buffer> readable_;
+    std::vector<mutable_buffer> writable_;
+};
+
+}
+
+#endif //PIO_SEGMENTED_BUFFER_HPP
@@ -9,6 +9,10 @@
 #define PIO_SERIAL_PORT_HPP
 
 #include <asio/serial_port.hpp>
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+#include <asio/posix/stream_descriptor.hpp>
+#include <memory>
+#endif
 #include <pio/buffer.hpp>
 #include <pio/concepts.hpp>
 
@@ -268,10 +272,23 @@ struct serial_port final :
   std::size_t write_some(const const_buffer& buffers, asio::error_code& ec);
   std::size_t read_some(const mutable_buffer& buffers);
   std::size_t read_some(const mutable_buffer& buffers, asio::error_code& ec);
+  std::size_t write_some(std::span<const const_buffer> buffers);
+  std::size_t write_some(std::span<const const_buffer> buffers, asio::error_code& ec);
+  std::size_t read_some(std::span<const mutable_buffer> buffers);
+  std::size_t read_some(std::span<const mutable_buffer> buffers, asio::error_code& ec);
 private:
     void async_read_some_impl(const asio::mutable_buffer &buffer, handler_type<void(std::error_code, std::size_t)> && h) override;
     void async_write_some_impl(asio::const_buffer buffer, handler_type<void(std::error_code, std::size_t)> && h) override;
+    void async_read_some_impl(std::span<const asio::mutable_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h) override;
+    void async_write_some_impl(std::span<const asio::const_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h) override;
     asio::serial_port impl_;
+    void reset_waiter_();
+    void cancel_waiter_();
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+    // waits for readiness before leasing a block from the pool.
+    void async_read_some_impl(buffer_pool & pool, handler_type<void(std::error_code, leased_buffer)> && h) override;
+    std::shared_ptr<asio::posix::stream_descriptor> waiter_;
+#endif
 };
 
 }
@@ -0,0 +1,142 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_SHARED_BUFFER_HPP
+#define PIO_SHARED_BUFFER_HPP
+
+#include <pio/buffer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+
+namespace pio
+{
+
+namespace detail
+{
+
+// the header of the allocation, the data follows it.
+struct shared_buffer_block
+{
+    alignas(std::atomic_ref<std::size_t>::required_alignment) std::size_t refs;
+    bool atomic;
+    std::size_t size;
+    std::pmr::memory_resource * resource;
+};
+
+}
+
+/// An immutable, reference-counted block of memory, and a view into it.
+/**
+ * Copying a `shared_buffer` or taking a `slice` of it only increments the count, so one payload
+ * can be written to many streams without copying it, each write holding its slice alive until it completes.
+ *
+ * The count is atomic by default. A buffer created with `threading::single` uses a plain increment instead,
+ * all its copies then must only be created & destroyed from one thread, e.g. the one running a single-threaded
+ * `io_context`.
+ */
+struct shared_buffer
+{
+    enum class threading
+    {
+        single,
+        multi
+    };
+
+    /// An empty buffer, that doesn't own anything.
+    shared_buffer() noexcept = default;
+
+    /// Allocate a block and copy `content` into it.
+    explicit shared_buffer(const_buffer content,
+                           threading t = threading::multi,
+                           std::pmr::memory_resource * resource = std::pmr::get_default_resource());
+
+    shared_buffer(const shared_buffer & lhs) noexcept : block_(lhs.block_), data_(lhs.data_), size_(lhs.size_)
+    {
+        acquire_();
+    }
+    shared_buffer(shared_buffer && lhs) noexcept
+        : block_(std::exchange(lhs.block_, nullptr)),
+          data_(std::exchange(lhs.data_, nullptr)),
+          size_(std::exchange(lhs.size_, 0u))
+    {
+    }
+
+    shared_buffer& operator=(const shared_buffer & lhs) noexcept
+    {
+        shared_buffer tmp{lhs};
+        return *this = std::move(tmp);
+    }
+    shared_buffer& operator=(shared_buffer && lhs) noexcept
+    {
+        if (this != &lhs)
+        {
+            release_();
+            block_ = std::exchange(lhs.block_, nullptr);
+            data_  = std::exchange(lhs.data_, nullptr);
+            size_  = std::exchange(lhs.size_, 0u);
+        }
+        return *this;
+    }
+
+    ~shared_buffer() {release_();}
+
+    const void * data() const noexcept {return data_;}
+    std::size_t size() const noexcept {return size_;}
+    bool empty() const noexcept {return size_ == 0u;}
+
+    /// The amount of buffers sharing the block, 0 if empty.
+    std::size_t use_count() const noexcept;
+
+    /// A view of `n` bytes from `offset`, clamped to this view, that shares the block.
+    shared_buffer slice(std::size_t offset, std::size_t n = static_cast<std::size_t>(-1)) const noexcept
+    {
+        shared_buffer res{*this};
+        res += offset;
+        res.size_ = (std::min)(res.size_, n);
+        return res;
+    }
+
+    /// Remove `n` bytes from the front of the view, like `const_buffer`.
+    shared_buffer& operator+=(std::size_t n) noexcept
+    {
+        n = (std::min)(n, size_);
+        data_ += n;
+        size_ -= n;
+        return *this;
+    }
+
+    operator const_buffer() const noexcept {return const_buffer(data_, size_);}
+
+  private:
+    void acquire_() noexcept
+    {
+        if (block_ == nullptr)
+            return;
+        if (block_->atomic)
+            std::atomic_ref<std::size_t>(block_->refs).fetch_add(1u, std::memory_order_relaxed);
+        else
+            block_->refs++;
+    }
+    void release_() noexcept
+    {
+        if (block_ != nullptr)
+            release_block_(std::exchange(block_, nullptr));
+    }
+    static void release_block_(detail::shared_buffer_block * block) noexcept;
+
+    detail::shared_buffer_block * block_ = nullptr;
+    const unsigned char * data_ = nullptr;
+    std::size_t size_ = 0u;
+};
+
+}
+
+#endif //PIO_SHARED_BUFFER_HPP
@@ -0,0 +1,126 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_SPLICE_HPP
+#define PIO_SPLICE_HPP
+
+#include <pio/handler.hpp>
+
+#include <asio/any_io_executor.hpp>
+#include <asio/async_result.hpp>
+#include <asio/detail/throw_error.hpp>
+
+#include <concepts>
+#include <cstddef>
+
+#if defined(__linux__)
+
+namespace pio
+{
+
+/// Any object with a posix descriptor, e.g. pipes, files & serial ports.
+template<typename T>
+concept native_descriptor_object = requires (T & t)
+{
+    {t.native_handle()} -> std::convertible_to<int>;
+    {t.get_executor()}  -> std::convertible_to<asio::any_io_executor>;
+};
+
+namespace detail
+{
+
+std::size_t splice_impl(int source, int sink, std::size_t n, std::error_code & ec);
+std::size_t tee_impl   (int source, int sink, std::size_t n, std::error_code & ec);
+
+void async_splice_impl(const asio::any_io_executor & exec, int source, int sink, std::size_t n,
+                       handler_type<void(std::error_code, std::size_t)> && h);
+void async_tee_impl   (const asio::any_io_executor & exec, int source, int sink, std::size_t n,
+                       handler_type<void(std::error_code, std::size_t)> && h);
+
+}
+
+/// Move `n` bytes from source to sink without copying them through user space, using `splice(2)`.
+/**
+ * One of the two must be a pipe. Files are read & written at their current position.
+ * Stops early at the end of the source, reporting `asio::error::eof`.
+ */
+template<native_descriptor_object Source, native_descriptor_object Sink>
+std::size_t splice(Source & source, Sink & sink, std::size_t n, std::error_code & ec)
+{
+    return detail::splice_impl(source.native_handle(), sink.native_handle(), n, ec);
+}
+
+template<native_descriptor_object Source, native_descriptor_object Sink>
+std::size_t splice(Source & source, Sink & sink, std::size_t n)
+{
+    std::error_code ec;
+    auto res = detail::splice_impl(source.native_handle(), sink.native_handle(), n, ec);
+    if (ec)
+        asio::detail::throw_error(ec, "splice");
+    return res;
+}
+
+/// Duplicate up to `n` bytes from one pipe into another without consuming them, using `tee(2)`.
+template<native_descriptor_object Source, native_descriptor_object Sink>
+std::size_t tee(Source & source, Sink & sink, std::size_t n, std::error_code & ec)
+{
+    return detail::tee_impl(source.native_handle(), sink.native_handle(), n, ec);
+}
+
+template<native_descriptor_object Source, native_descriptor_object Sink>
+std::size_t tee(Source & source, Sink & sink, std::size_t n)
+{
+    std::error_code ec;
+    auto res = detail::tee_impl(source.native_handle(), sink.native_handle(), n, ec);
+    if (ec)
+        asio::detail::throw_error(ec, "tee");
+    return res;
+}
+
+/// Asynchronously move `n` bytes from source to sink without copying them through user space.
+/**
+ * One of the two must be a pipe. Files are read & written at their current position.
+ * Completes early at the end of the source with `asio::error::eof`.
+ *
+ * The pipe ends are waited on with the reactor of the source's executor,
+ * the transfer itself runs on the thread that gets notified.
+ */
+template<native_descriptor_object Source, native_descriptor_object Sink, typename CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, std::size_t))
+async_splice(Source & source, Sink & sink, std::size_t n, CompletionToken && token)
+{
+    return asio::async_initiate<CompletionToken, void(std::error_code, std::size_t)>(
+            [&source, &sink](auto handler, std::size_t n)
+            {
+                auto exec = source.get_executor();
+                detail::async_splice_impl(exec, source.native_handle(), sink.native_handle(), n,
+                                          handler_type<void(std::error_code, std::size_t)>(std::move(handler), exec));
+            }, token, n);
+}
+
+/// Asynchronously duplicate up to `n` bytes from one pipe into another, without consuming them.
+/**
+ * Completes as soon as any data was duplicated, since repeating it would duplicate the same data again.
+ */
+template<native_descriptor_object Source, native_descriptor_object Sink, typename CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, std::size_t))
+async_tee(Source & source, Sink & sink, std::size_t n, CompletionToken && token)
+{
+    return asio::async_initiate<CompletionToken, void(std::error_code, std::size_t)>(
+            [&source, &sink](auto handler, std::size_t n)
+            {
+                auto exec = source.get_executor();
+                detail::async_tee_impl(exec, source.native_handle(), sink.native_handle(), n,
+                                       handler_type<void(std::error_code, std::size_t)>(std::move(handler), exec));
+            }, token, n);
+}
+
+}
+
+#endif
+
+#endif //PIO_SPLICE_HPP
@@ -21,6 +21,7 @@ struct stream_file final :
                 concepts::sync_write_stream,
                 concepts::async_read_stream,
                 concepts::async_write_stream,
+                concepts::async_syncable_device,
                 concepts::cancellable,
                 concepts::closable>,
         asio::file_base
@@ -81,9 +82,13 @@ struct stream_file final :
 
   std::size_t write_some(const const_buffer & buffers) override;
   std::size_t write_some(const const_buffer & buffers, asio::error_code& ec) override;
+  std::size_t write_some(std::span<const const_buffer> buffers) override;
+  std::size_t write_some(std::span<const const_buffer> buffers, asio::error_code& ec) override;
 
   std::size_t read_some(const mutable_buffer & buffers) override;
   std::size_t read_some(const mutable_buffer & buffers, asio::error_code& ec) override;
+  std::size_t read_some(std::span<const mutable_buffer> buffers) override;
+  std::size_t read_some(std::span<const mutable_buffer> buffers, asio::error_code& ec) override;
   executor_type get_executor();
 
   bool is_open() const override;
@@ -103,6 +108,12 @@ struct stream_file final :
 private:
   void async_read_some_impl(const asio::mutable_buffer &buffer, handler_type<void(std::error_code, std::size_t)> && h) override;
   void async_write_some_impl(asio::const_buffer buffer, handler_type<void(std::error_code, std::size_t)> && h) override;
+  void async_read_some_impl(std::span<const asio::mutable_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h) override;
+  void async_write_some_impl(std::span<const asio::const_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h) override;
+  // run on a helper thread pool, the file needs to stay open until they complete.
+  void async_sync_impl(handler_type<void(std::error_code)> && h) override;
+  void async_data_sync_impl(handler_type<void(std::error_code)> && h) override;
+  void async_sync_range_impl(std::uint64_t offset, std::uint64_t length, handler_type<void(std::error_code)> && h) override;
   asio::stream_file impl_;
 };
 
@@ -53,6 +53,8 @@ struct writable_pipe final :
 
   std::size_t write_some(const const_buffer & buffers) override;
   std::size_t write_some(const const_buffer & buffers, asio::error_code& ec) override;
+  std::size_t write_some(std::span<const const_buffer> buffers) override;
+  std::size_t write_some(std::span<const const_buffer> buffers, asio::error_code& ec) override;
 
   executor_type get_executor();
 
@@ -76,6 +78,7 @@ struct writable_pipe final :
 
 private:
   void async_write_some_impl(asio::const_buffer buffer, handler_type<void(std::error_code, std::size_t)> && h) override;
+  void async_write_some_impl(std::span<const asio::const_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h) override;
   asio::writable_pipe impl_;
 };
 
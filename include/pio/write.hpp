@@ -10,14 +10,14 @@
 
 #include <pio/concepts.hpp>
 #include <pio/buffer.hpp>
+#include <pio/completion_condition.hpp>
+#include <pio/segmented_buffer.hpp>
+#include <pio/shared_buffer.hpp>
 #include <asio/streambuf.hpp>
-#include <functional>
 
 namespace pio
 {
 
-using completion_condition_t = std::function<std::size_t(const asio::error_code &error, std::size_t bytes_transferred)>;
-
 
 std::size_t write(concepts::sync_write_stream& s, const asio::const_buffer& buffers);
 std::size_t write(concepts::sync_write_stream& s, const asio::const_buffer& buffers, asio::error_code& ec);
@@ -26,6 +26,12 @@ std::size_t write(concepts::sync_write_stream& s, const asio::const_buffer& buff
 std::size_t write(concepts::sync_write_stream& s, const asio::const_buffer& buffers, completion_condition_t completion_condition);
 std::size_t write(concepts::sync_write_stream& s, const asio::const_buffer& buffers, completion_condition_t completion_condition, asio::error_code& ec);
 
+std::size_t write(concepts::sync_write_stream& s, std::span<const asio::const_buffer> buffers);
+std::size_t write(concepts::sync_write_stream& s, std::span<const asio::const_buffer> buffers, asio::error_code& ec);
+
+std::size_t write(concepts::sync_write_stream& s, std::span<const asio::const_buffer> buffers, completion_condition_t completion_condition);
+std::size_t write(concepts::sync_write_stream& s, std::span<const asio::const_buffer> buffers, completion_condition_t completion_condition, asio::error_code& ec);
+
 std::size_t write(concepts::sync_write_stream& s, dynamic_buffer buffers);
 std::size_t write(concepts::sync_write_stream& s, dynamic_buffer buffers, asio::error_code& ec);
 
@@ -39,19 +45,67 @@ std::size_t write(concepts::sync_write_stream& s, asio::streambuf & buffers, asi
 std::size_t write(concepts::sync_write_stream& s, asio::streambuf & buffers, completion_condition_t completion_condition);
 std::size_t write(concepts::sync_write_stream& s, asio::streambuf & buffers, completion_condition_t completion_condition, asio::error_code& ec);
 
+std::size_t write(concepts::sync_write_stream& s, segmented_buffer & buffers);
+std::size_t write(concepts::sync_write_stream& s, segmented_buffer & buffers, asio::error_code& ec);
+
+std::size_t write(concepts::sync_write_stream& s, segmented_buffer & buffers, completion_condition_t completion_condition);
+std::size_t write(concepts::sync_write_stream& s, segmented_buffer & buffers, completion_condition_t completion_condition, asio::error_code& ec);
+
 namespace detail
 {
 
 void async_write_impl(concepts::async_write_stream& s, const asio::const_buffer& buffers,                                              handler_type<void(asio::error_code, std::size_t)> && h);
 void async_write_impl(concepts::async_write_stream& s, const asio::const_buffer& buffers, completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h);
+void async_write_impl(concepts::async_write_stream& s, std::span<const asio::const_buffer> buffers,                                              handler_type<void(asio::error_code, std::size_t)> && h);
+void async_write_impl(concepts::async_write_stream& s, std::span<const asio::const_buffer> buffers, completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h);
 void async_write_impl(concepts::async_write_stream& s, pio::dynamic_buffer buffers,                                              handler_type<void(asio::error_code, std::size_t)> && h);
 void async_write_impl(concepts::async_write_stream& s, pio::dynamic_buffer buffers, completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h);
 void async_write_impl(concepts::async_write_stream& s, asio::streambuf &buffer,                                              handler_type<void(asio::error_code, std::size_t)> && h);
 void async_write_impl(concepts::async_write_stream& s, asio::streambuf &buffer, completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h);
+void async_write_impl(concepts::async_write_stream& s, segmented_buffer &buffer,                                              handler_type<void(asio::error_code, std::size_t)> && h);
+void async_write_impl(concepts::async_write_stream& s, segmented_buffer &buffer, completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h);
+void async_write_impl(concepts::async_write_stream& s, shared_buffer buffer,                                                handler_type<void(asio::error_code, std::size_t)> && h);
+void async_write_impl(concepts::async_write_stream& s, shared_buffer buffer, completion_condition_t completion_condition,   handler_type<void(asio::error_code, std::size_t)> && h);
 
 }
 
 
+template <
+    ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
+      std::size_t)) WriteToken
+        ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(
+          typename concepts::async_write_stream::executor_type)>
+ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(WriteToken,
+    void (asio::error_code, std::size_t))
+async_write(concepts::async_write_stream& s, std::span<const asio::const_buffer> buffers,
+    ASIO_MOVE_ARG(WriteToken) token
+      ASIO_DEFAULT_COMPLETION_TOKEN(
+        typename concepts::async_write_stream::executor_type))
+{
+    return asio::async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+            [](auto handler, concepts::async_write_stream& s, std::span<const asio::const_buffer> buffers)
+            {
+                detail::async_write_impl(s, buffers, handler_type<void(asio::error_code, std::size_t)>(std::move(handler), s.get_executor()));
+            }, token, s, buffers);
+}
+
+template <
+    ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
+      std::size_t)) WriteToken>
+ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(WriteToken,
+    void (asio::error_code, std::size_t))
+async_write(concepts::async_write_stream& s, std::span<const asio::const_buffer> buffers,
+    completion_condition_t completion_condition,
+    ASIO_MOVE_ARG(WriteToken) token)
+{
+    return asio::async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+            [](auto handler, concepts::async_write_stream& s,
+               std::span<const asio::const_buffer> buffers, completion_condition_t completion_condition)
+            {
+                detail::async_write_impl(s, buffers, std::move(completion_condition), handler_type<void(asio::error_code, std::size_t)>(std::move(handler), s.get_executor()));
+            }, token, s, buffers, std::move(completion_condition));
+}
+
 template <
     ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
       std::size_t)) WriteToken
@@ -69,7 +123,7 @@ async_write(concepts::async_write_stream& s, const asio::const_buffer& buffers,
         declval<detail::initiate_async_write<concepts::async_write_stream> >(),
         token, buffers, transfer_all())))
 {
-    return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+    return asio::async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
             [](auto handler, concepts::async_write_stream& d, const asio::const_buffer& buffers)
             {
                 detail::async_write_impl(d, buffers, handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
@@ -91,7 +145,7 @@ async_write(concepts::async_write_stream& s, const asio::const_buffer& buffers,
         token, buffers,
         ASIO_MOVE_CAST(completion_condition_t)(completion_condition))))
 {
-    return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+    return asio::async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
             [](auto handler,
                concepts::async_write_stream& d,
                const asio::const_buffer& buffers, completion_condition_t completion_condition)
@@ -119,7 +173,7 @@ async_write(concepts::async_write_stream& s,
         token, std::declval<dynamic_buffer>(),
         transfer_all())))
 {
-    return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+    return asio::async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
             [](auto handler,
                concepts::async_write_stream& d, dynamic_buffer buffers)
             {
@@ -143,7 +197,7 @@ async_write(concepts::async_write_stream& s,
         token, std::declval<dynamic_buffer>(),
         ASIO_MOVE_CAST(completion_condition_t)(completion_condition))))
 {
-    return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+    return asio::async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
             [](auto handler,
                concepts::async_write_stream& d,
                dynamic_buffer buffers, completion_condition_t completion_condition)
@@ -167,7 +221,7 @@ async_write(concepts::async_write_stream& s, asio::streambuf& b,
     async_write(s, basic_streambuf_ref<Allocator>(b),
         ASIO_MOVE_CAST(WriteToken)(token))))
 {
-    return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+    return asio::async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
             [](auto handler,
                concepts::async_write_stream& d, asio::streambuf& b)
             {
@@ -189,7 +243,7 @@ async_write(concepts::async_write_stream& s, asio::streambuf& b,
         ASIO_MOVE_CAST(completion_condition_t)(completion_condition),
         ASIO_MOVE_CAST(WriteToken)(token))))
 {
-    return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+    return asio::async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
             [](auto handler,
                concepts::async_write_stream& d,
                asio::streambuf& b, completion_condition_t completion_condition)
@@ -199,6 +253,66 @@ async_write(concepts::async_write_stream& s, asio::streambuf& b,
             }, token, s, b, std::move(completion_condition));
 }
 
+template <ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code, std::size_t)) CompletionToken
+            ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(typename concepts::async_write_stream::executor_type)>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void (asio::error_code, std::size_t))
+async_write(concepts::async_write_stream& s, segmented_buffer& b,
+           ASIO_MOVE_ARG(CompletionToken) token
+             ASIO_DEFAULT_COMPLETION_TOKEN(typename concepts::async_write_stream::executor_type))
+{
+    return asio::async_initiate<CompletionToken, void (asio::error_code, std::size_t)>(
+            [](auto handler,
+               concepts::async_write_stream& d, segmented_buffer& b)
+            {
+                detail::async_write_impl(d, b, handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
+            }, token, s, b);
+}
+
+template <ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code, std::size_t)) CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void (asio::error_code, std::size_t))
+async_write(concepts::async_write_stream& s, segmented_buffer& b,
+           completion_condition_t completion_condition,
+           ASIO_MOVE_ARG(CompletionToken) token)
+{
+    return asio::async_initiate<CompletionToken, void (asio::error_code, std::size_t)>(
+            [](auto handler,
+               concepts::async_write_stream& d,
+               segmented_buffer& b, completion_condition_t completion_condition)
+            {
+                detail::async_write_impl(d, b, std::move(completion_condition), handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
+            }, token, s, b, std::move(completion_condition));
+}
+
+template <ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code, std::size_t)) CompletionToken
+            ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(typename concepts::async_write_stream::executor_type)>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void (asio::error_code, std::size_t))
+async_write(concepts::async_write_stream& s, shared_buffer buffer,
+            ASIO_MOVE_ARG(CompletionToken) token
+              ASIO_DEFAULT_COMPLETION_TOKEN(typename concepts::async_write_stream::executor_type))
+{
+    return asio::async_initiate<CompletionToken, void (asio::error_code, std::size_t)>(
+            [](auto handler,
+               concepts::async_write_stream& d, shared_buffer buffer)
+            {
+                detail::async_write_impl(d, std::move(buffer), handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
+            }, token, s, std::move(buffer));
+}
+
+template <ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code, std::size_t)) CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void (asio::error_code, std::size_t))
+async_write(concepts::async_write_stream& s, shared_buffer buffer,
+            completion_condition_t completion_condition,
+            ASIO_MOVE_ARG(CompletionToken) token)
+{
+    return asio::async_initiate<CompletionToken, void (asio::error_code, std::size_t)>(
+            [](auto handler,
+               concepts::async_write_stream& d,
+               shared_buffer buffer, completion_condition_t completion_condition)
+            {
+                detail::async_write_impl(d, std::move(buffer), std::move(completion_condition), handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
+            }, token, s, std::move(buffer), std::move(completion_condition));
+}
+
 }
 
 #endif //PIO_WRITE_HPP
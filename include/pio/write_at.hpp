@@ -10,14 +10,13 @@
 
 #include <pio/concepts.hpp>
 #include <pio/buffer.hpp>
+#include <pio/completion_condition.hpp>
+#include <pio/shared_buffer.hpp>
 #include <asio/streambuf.hpp>
-#include <functional>
 
 namespace pio
 {
 
-using completion_condition_t = std::function<std::size_t(const asio::error_code &error, std::size_t bytes_transferred)>;
-
 
 std::size_t write_at(concepts::sync_random_access_write_device& d,
                      uint64_t offset, const const_buffer & buffers);
@@ -32,6 +31,20 @@ std::size_t write_at(concepts::sync_random_access_write_device& d,
 std::size_t write_at(concepts::sync_random_access_write_device& d,
                      uint64_t offset, const const_buffer & buffers,
                      completion_condition_t completion_condition, asio::error_code& ec);
+std::size_t write_at(concepts::sync_random_access_write_device& d,
+                     uint64_t offset, std::span<const const_buffer> buffers);
+std::size_t write_at(concepts::sync_random_access_write_device& d,
+                     uint64_t offset, std::span<const const_buffer> buffers,
+                     asio::error_code& ec);
+
+std::size_t write_at(concepts::sync_random_access_write_device& d,
+                     uint64_t offset, std::span<const const_buffer> buffers,
+                     completion_condition_t completion_condition);
+
+std::size_t write_at(concepts::sync_random_access_write_device& d,
+                     uint64_t offset, std::span<const const_buffer> buffers,
+                     completion_condition_t completion_condition, asio::error_code& ec);
+
 std::size_t write_at(concepts::sync_random_access_write_device& d,
                      uint64_t offset, asio::streambuf& b);
 
@@ -57,6 +70,15 @@ void async_write_at_impl(
         const const_buffer & buffers, completion_condition_t completion_condition,
         handler_type<void(asio::error_code, std::size_t)> && h);
 
+void async_write_at_impl(
+        concepts::async_random_access_write_device& d, uint64_t offset,
+        std::span<const const_buffer> buffers, handler_type<void(asio::error_code, std::size_t)> && h);
+
+void async_write_at_impl(
+        concepts::async_random_access_write_device& d, uint64_t offset,
+        std::span<const const_buffer> buffers, completion_condition_t completion_condition,
+        handler_type<void(asio::error_code, std::size_t)> && h);
+
 
 void async_write_at_impl(
         concepts::async_random_access_write_device& d, uint64_t offset,
@@ -67,6 +89,15 @@ void async_write_at_impl(
         concepts::async_random_access_write_device& d, uint64_t offset,
         asio::streambuf& b, completion_condition_t completion_condition,
         handler_type<void(asio::error_code, std::size_t)> && h);
+
+void async_write_at_impl(
+        concepts::async_random_access_write_device& d, uint64_t offset,
+        shared_buffer buffer, handler_type<void(asio::error_code, std::size_t)> && h);
+
+void async_write_at_impl(
+        concepts::async_random_access_write_device& d, uint64_t offset,
+        shared_buffer buffer, completion_condition_t completion_condition,
+        handler_type<void(asio::error_code, std::size_t)> && h);
 }
 
 template <ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
@@ -90,7 +121,7 @@ async_write_at(concepts::async_random_access_write_device& d, uint64_t offset,
     return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
             [](auto handler,
                concepts::async_random_access_write_device& d, uint64_t offset,
-               asio::streambuf& b, const const_buffer & buffers)
+               const const_buffer & buffers)
             {
                 detail::async_write_at_impl(d, offset, std::move(buffers), handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
             }, token,
@@ -119,7 +150,7 @@ async_write_at(concepts::async_random_access_write_device& d, uint64_t offset,
     return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
             [](auto handler,
                concepts::async_random_access_write_device& d, uint64_t offset,
-               asio::streambuf& b, const const_buffer & buffers,
+               const const_buffer & buffers,
                completion_condition_t completion_condition)
             {
                 detail::async_write_at_impl(d, offset, std::move(buffers),
@@ -129,6 +160,54 @@ async_write_at(concepts::async_random_access_write_device& d, uint64_t offset,
 }
 
 
+template <ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
+      std::size_t)) WriteToken
+        ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(
+          typename concepts::async_random_access_write_device::executor_type)>
+ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(WriteToken,
+    void (asio::error_code, std::size_t))
+async_write_at(concepts::async_random_access_write_device& d, uint64_t offset,
+    std::span<const const_buffer> buffers,
+    ASIO_MOVE_ARG(WriteToken) token
+      ASIO_DEFAULT_COMPLETION_TOKEN(
+        typename concepts::async_random_access_write_device::executor_type))
+{
+    return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+            [](auto handler,
+               concepts::async_random_access_write_device& d, uint64_t offset,
+               std::span<const const_buffer> buffers)
+            {
+                detail::async_write_at_impl(d, offset, buffers, handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
+            }, token,
+            d, offset, buffers);
+}
+
+template <ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
+      std::size_t)) WriteToken
+        ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(
+          typename concepts::async_random_access_write_device::executor_type)>
+ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(WriteToken,
+    void (asio::error_code, std::size_t))
+async_write_at(concepts::async_random_access_write_device& d, uint64_t offset,
+    std::span<const const_buffer> buffers,
+    completion_condition_t completion_condition,
+    ASIO_MOVE_ARG(WriteToken) token
+      ASIO_DEFAULT_COMPLETION_TOKEN(
+        typename concepts::async_random_access_write_device::executor_type))
+{
+    return async_initiate<WriteToken, void (asio::error_code, std::size_t)>(
+            [](auto handler,
+               concepts::async_random_access_write_device& d, uint64_t offset,
+               std::span<const const_buffer> buffers,
+               completion_condition_t completion_condition)
+            {
+                detail::async_write_at_impl(d, offset, buffers,
+                                            std::move(completion_condition), handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
+            }, token,
+            d, offset, buffers, std::move(completion_condition));
+}
+
+
 template <ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
       std::size_t)) WriteToken
         ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(
@@ -187,6 +266,37 @@ async_write_at(concepts::async_random_access_write_device& d, uint64_t offset,
             d, offset,  b, std::move(completion_condition));
 }
 
+template <ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code, std::size_t)) CompletionToken
+            ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(typename concepts::async_random_access_write_device::executor_type)>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void (asio::error_code, std::size_t))
+async_write_at(concepts::async_random_access_write_device& d, uint64_t offset, shared_buffer buffer,
+               ASIO_MOVE_ARG(CompletionToken) token
+                 ASIO_DEFAULT_COMPLETION_TOKEN(typename concepts::async_random_access_write_device::executor_type))
+{
+    return asio::async_initiate<CompletionToken, void (asio::error_code, std::size_t)>(
+            [](auto handler,
+               concepts::async_random_access_write_device& d, uint64_t offset, shared_buffer buffer)
+            {
+                detail::async_write_at_impl(d, offset, std::move(buffer), handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
+            }, token, d, offset, std::move(buffer));
+}
+
+template <ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code, std::size_t)) CompletionToken>
+ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void (asio::error_code, std::size_t))
+async_write_at(concepts::async_random_access_write_device& d, uint64_t offset, shared_buffer buffer,
+               completion_condition_t completion_condition,
+               ASIO_MOVE_ARG(CompletionToken) token)
+{
+    return asio::async_initiate<CompletionToken, void (asio::error_code, std::size_t)>(
+            [](auto handler,
+               concepts::async_random_access_write_device& d, uint64_t offset,
+               shared_buffer buffer, completion_condition_t completion_condition)
+            {
+                detail::async_write_at_impl(d, offset, std::move(buffer), std::move(completion_condition),
+                                            handler_type<void(asio::error_code, std::size_t)>(std::move(handler), d.get_executor()));
+            }, token, d, offset, std::move(buffer), std::move(completion_condition));
+}
+
 }
 
 #endif //PIO_WRITE_AT_HPP
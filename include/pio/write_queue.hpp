@@ -0,0 +1,82 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_WRITE_QUEUE_HPP
+#define PIO_WRITE_QUEUE_HPP
+
+#include <pio/concepts.hpp>
+
+#include <asio/async_result.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <span>
+
+namespace pio
+{
+
+namespace detail
+{
+struct write_queue_state;
+}
+
+/// Serializes writes from many threads or coroutines onto one stream.
+/**
+ * Every `async_write` writes its buffers completely and in the order the calls were made.
+ * Writes that queue up while another one is in flight are gathered into one vectored write
+ * of up to `max_gather` buffers, and each caller's handler is completed individually.
+ *
+ * `async_write` is thread-safe and lock-free, the writes to the stream happen on the stream's executor.
+ * The queue must outlive all writes.
+ */
+struct write_queue
+{
+    explicit write_queue(concepts::async_write_stream & stream, std::size_t max_gather = 64u);
+    ~write_queue();
+
+    write_queue(const write_queue &) = delete;
+    write_queue& operator=(const write_queue &) = delete;
+
+    using executor_type = asio::any_io_executor;
+    executor_type get_executor();
+
+    /// Queue the buffer for writing. The buffer needs to stay valid until the operation completes.
+    template<typename CompletionToken>
+    ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, std::size_t))
+    async_write(const_buffer buffer, CompletionToken && token)
+    {
+        return asio::async_initiate<CompletionToken, void(std::error_code, std::size_t)>(
+                [this](auto handler, const_buffer buffer)
+                {
+                    this->async_write_impl(std::span<const const_buffer>(&buffer, 1u),
+                                           handler_type<void(std::error_code, std::size_t)>(std::move(handler), this->get_executor()));
+                }, token, buffer);
+    }
+
+    /// Queue the buffers to be written. They need to stay valid until the operation completes.
+    template<typename CompletionToken>
+    ASIO_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(std::error_code, std::size_t))
+    async_write(std::span<const const_buffer> buffers, CompletionToken && token)
+    {
+        return asio::async_initiate<CompletionToken, void(std::error_code, std::size_t)>(
+                [this](auto handler, std::span<const const_buffer> buffers)
+                {
+                    this->async_write_impl(buffers,
+                                           handler_type<void(std::error_code, std::size_t)>(std::move(handler), this->get_executor()));
+                }, token, buffers);
+    }
+
+  private:
+    // copies the buffer descriptors, not the data.
+    void async_write_impl(std::span<const const_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h);
+
+    std::unique_ptr<detail::write_queue_state> state_;
+};
+
+}
+
+#endif //PIO_WRITE_QUEUE_HPP
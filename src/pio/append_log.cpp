@@ -0,0 +1,231 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/append_log.hpp>
+#include <pio/write_at.hpp>
+#include "detail/handler_state.hpp"
+
+#include <asio/dispatch.hpp>
+#include <asio/strand.hpp>
+
+#include <cassert>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace pio
+{
+
+namespace detail
+{
+
+using append_handler_t = handler_type<void(std::error_code, std::uint64_t)>;
+
+struct append_record
+{
+    std::uint64_t offset;
+    std::uint64_t end;
+    const_buffer single;
+    std::vector<const_buffer> more;
+    // reset once completed, i.e. after a failure
+    std::optional<append_handler_t> handler;
+    bool written = false;
+
+    std::span<const const_buffer> buffers() const
+    {
+        if (more.empty())
+            return std::span<const const_buffer>(&single, 1u);
+        return more;
+    }
+};
+
+struct append_log_state
+{
+    append_log_state(random_access_file & file, std::uint64_t offset)
+        : file(file), strand(asio::make_strand(file.get_executor())), end(offset), durable(offset)
+    {
+    }
+
+    random_access_file & file;
+    // all operations on the file are initiated on the strand, the appends can come from any thread.
+    asio::strand<asio::any_io_executor> strand;
+    mutable std::mutex mtx;
+
+    std::uint64_t end;
+    std::uint64_t durable;
+    std::uint64_t syncs = 0u;
+    std::error_code error;
+
+    // the records that aren't durable yet, in offset order. front_seq is the sequence number of the first one.
+    std::deque<append_record> records;
+    std::uint64_t front_seq = 0u;
+    // the number of records at the front whose writes completed.
+    std::size_t written = 0u;
+    // the number of records at the front covered by the sync in flight.
+    std::size_t syncing = 0u;
+
+    // writes & syncs in flight
+    std::size_t outstanding = 0u;
+};
+
+namespace
+{
+
+using state = append_log_state;
+
+void complete(append_record & rec, std::error_code ec)
+{
+    if (!rec.handler)
+        return;
+    auto h = std::move(*rec.handler);
+    rec.handler.reset();
+    post_completion(std::move(h), ec, rec.offset);
+}
+
+void fail(state & st, std::error_code ec)
+{
+    if (!st.error)
+        st.error = ec;
+    // the records covered by the sync in flight can still become durable.
+    for (auto i = st.syncing; i < st.records.size(); i++)
+        complete(st.records[i], st.error);
+}
+
+void maybe_sync(state & st);
+
+struct sync_done_op
+{
+    state * st;
+
+    using executor_type = asio::strand<asio::any_io_executor>;
+    executor_type get_executor() const {return st->strand;}
+
+    void operator()(std::error_code ec)
+    {
+        std::lock_guard<std::mutex> lock{st->mtx};
+        st->outstanding--;
+        if (ec)
+        {
+            st->syncing = 0u;
+            return fail(*st, ec);
+        }
+
+        for (std::size_t i = 0u; i < st->syncing; i++)
+        {
+            auto & rec = st->records.front();
+            st->durable = rec.end;
+            complete(rec, {});
+            st->records.pop_front();
+        }
+        st->front_seq += st->syncing;
+        st->written -= st->syncing;
+        st->syncing = 0u;
+        maybe_sync(*st);
+    }
+};
+
+void maybe_sync(state & st)
+{
+    if (st.syncing != 0u || st.written == 0u || st.error)
+        return;
+
+    // covers everything written while the last sync was in flight.
+    st.syncing = st.written;
+    st.syncs++;
+    st.outstanding++;
+    st.file.async_data_sync(sync_done_op{&st});
+}
+
+// runs on the strand, so the follow-up writes of async_write_at after a short write are initiated there, too.
+struct write_done_op
+{
+    state * st;
+    std::uint64_t seq;
+
+    using executor_type = asio::strand<asio::any_io_executor>;
+    executor_type get_executor() const {return st->strand;}
+
+    void operator()(std::error_code ec, std::size_t)
+    {
+        std::lock_guard<std::mutex> lock{st->mtx};
+        st->outstanding--;
+        if (ec)
+            return fail(*st, ec);
+
+        st->records[seq - st->front_seq].written = true;
+        while (st->written < st->records.size() && st->records[st->written].written)
+            st->written++;
+        maybe_sync(*st);
+    }
+};
+
+}
+
+}
+
+append_log::append_log(random_access_file & file, std::uint64_t offset)
+    : state_(std::make_unique<detail::append_log_state>(file, offset))
+{
+}
+
+append_log::~append_log()
+{
+    assert(state_->outstanding == 0u);
+}
+
+auto append_log::get_executor() -> executor_type
+{
+    return state_->file.get_executor();
+}
+
+std::uint64_t append_log::size() const
+{
+    std::lock_guard<std::mutex> lock{state_->mtx};
+    return state_->end;
+}
+
+std::uint64_t append_log::durable_size() const
+{
+    std::lock_guard<std::mutex> lock{state_->mtx};
+    return state_->durable;
+}
+
+std::uint64_t append_log::syncs() const
+{
+    std::lock_guard<std::mutex> lock{state_->mtx};
+    return state_->syncs;
+}
+
+void append_log::async_append_impl(std::span<const const_buffer> buffers, handler_type<void(std::error_code, std::uint64_t)> && h)
+{
+    auto & st = *state_;
+    std::lock_guard<std::mutex> lock{st.mtx};
+    if (st.error)
+        return detail::post_completion(std::move(h), st.error, std::uint64_t(0u));
+
+    auto & rec = st.records.emplace_back();
+    rec.offset = st.end;
+    st.end += asio::buffer_size(buffers);
+    rec.end = st.end;
+    if (buffers.size() == 1u)
+        rec.single = buffers.front();
+    else
+        rec.more.assign(buffers.begin(), buffers.end());
+    rec.handler.emplace(std::move(h));
+
+    // the deque doesn't move its elements & the record stays until it's durable,
+    // so the copied descriptors stay valid during the write.
+    st.outstanding++;
+    asio::dispatch(st.strand,
+                   [&st, &rec, seq = st.front_seq + st.records.size() - 1u]
+                   {
+                       pio::async_write_at(st.file, rec.offset, rec.buffers(), detail::write_done_op{&st, seq});
+                   });
+}
+
+}
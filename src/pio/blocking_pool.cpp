@@ -0,0 +1,23 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "detail/blocking_pool.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace pio::detail
+{
+
+asio::thread_pool & blocking_pool()
+{
+    // the syncs mostly wait for the device, so a few threads are plenty.
+    static asio::thread_pool pool{std::clamp(std::thread::hardware_concurrency(), 2u, 8u)};
+    return pool;
+}
+
+}
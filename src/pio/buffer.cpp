@@ -7,13 +7,192 @@
 
 #include <pio/buffer.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)) && !defined(PIO_NO_COPY_KERNELS)
+#define PIO_HAS_X86_COPY_KERNELS 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+// copies at least this large bypass the cache, they would evict more than they could reuse.
+#if !defined(PIO_NON_TEMPORAL_COPY_THRESHOLD)
+#define PIO_NON_TEMPORAL_COPY_THRESHOLD (1024u * 1024u)
+#endif
 
 namespace pio
 {
 
+namespace
+{
+
+// below this memcpy wins, it gets inlined & doesn't pay for the dispatch or the startup of rep movsb.
+constexpr std::size_t rep_movsb_threshold = 2048u;
+
+using copy_kernel = void(*)(unsigned char * target, const unsigned char * source, std::size_t n) noexcept;
+
+void copy_memcpy(unsigned char * target, const unsigned char * source, std::size_t n) noexcept
+{
+    std::memcpy(target, source, n);
+}
+
+#if defined(PIO_HAS_X86_COPY_KERNELS)
+
+void copy_rep_movsb(unsigned char * target, const unsigned char * source, std::size_t n) noexcept
+{
+    asm volatile("rep movsb" : "+D"(target), "+S"(source), "+c"(n) : : "memory");
+}
+
+// the streaming stores need an aligned target, the head & tail are copied normally.
+__attribute__((target("avx2")))
+void copy_non_temporal_avx2(unsigned char * target, const unsigned char * source, std::size_t n) noexcept
+{
+    const auto head = (32u - (reinterpret_cast<std::uintptr_t>(target) & 31u)) & 31u;
+    std::memcpy(target, source, head);
+    target += head;
+    source += head;
+    n -= head;
+
+    for (; n >= 128u; n -= 128u, target += 128u, source += 128u)
+    {
+        const auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+        const auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + 32u));
+        const auto c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + 64u));
+        const auto d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + 96u));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(target),       a);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(target + 32u), b);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(target + 64u), c);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(target + 96u), d);
+    }
+    // order the streaming stores before anything that follows, e.g. the completion of a write.
+    _mm_sfence();
+    std::memcpy(target, source, n);
+}
+
+__attribute__((target("avx512f")))
+void copy_non_temporal_avx512(unsigned char * target, const unsigned char * source, std::size_t n) noexcept
+{
+    const auto head = (64u - (reinterpret_cast<std::uintptr_t>(target) & 63u)) & 63u;
+    std::memcpy(target, source, head);
+    target += head;
+    source += head;
+    n -= head;
+
+    for (; n >= 256u; n -= 256u, target += 256u, source += 256u)
+    {
+        const auto a = _mm512_loadu_si512(source);
+        const auto b = _mm512_loadu_si512(source + 64u);
+        const auto c = _mm512_loadu_si512(source + 128u);
+        const auto d = _mm512_loadu_si512(source + 192u);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(target),        a);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(target + 64u),  b);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(target + 128u), c);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(target + 192u), d);
+    }
+    _mm_sfence();
+    std::memcpy(target, source, n);
+}
+
+#endif
+
+struct copy_kernels
+{
+    copy_kernel mid = &copy_memcpy;
+    copy_kernel large = &copy_memcpy;
+};
+
+copy_kernels detect_copy_kernels() noexcept
+{
+    copy_kernels res;
+#if defined(PIO_HAS_X86_COPY_KERNELS)
+    __builtin_cpu_init();
+    unsigned eax, ebx, ecx, edx;
+    // enhanced rep movsb/stosb
+    if (__get_cpuid_count(7u, 0u, &eax, &ebx, &ecx, &edx) && (ebx & (1u << 9)))
+        res.mid = &copy_rep_movsb;
+
+    if (__builtin_cpu_supports("avx512f"))
+        res.large = &copy_non_temporal_avx512;
+    else if (__builtin_cpu_supports("avx2"))
+        res.large = &copy_non_temporal_avx2;
+    else
+        res.large = res.mid;
+#endif
+    return res;
+}
+
+// resolved on first use, so it works during static initialization, too.
+const copy_kernels & kernels() noexcept
+{
+    static const copy_kernels k = detect_copy_kernels();
+    return k;
+}
+
+void copy_bytes(void * target, const void * source, std::size_t n) noexcept
+{
+    if (n == 0u)
+        return;
+    if (n < rep_movsb_threshold)
+        return static_cast<void>(std::memcpy(target, source, n));
+
+    const auto & k = kernels();
+    (n < PIO_NON_TEMPORAL_COPY_THRESHOLD ? k.mid : k.large)(
+            static_cast<unsigned char*>(target), static_cast<const unsigned char*>(source), n);
+}
+
+// walks both sequences, one chunk per pair of overlapping buffers.
+std::size_t copy_sequence(std::span<const mutable_buffer> target, std::span<const const_buffer> source) noexcept
+{
+    std::size_t total = 0u;
+    auto t = target.begin();
+    auto s = source.begin();
+    std::size_t t_offset = 0u, s_offset = 0u;
+    while (t != target.end() && s != source.end())
+    {
+        const auto n = (std::min)(t->size() - t_offset, s->size() - s_offset);
+        copy_bytes(static_cast<unsigned char*>(t->data()) + t_offset,
+                   static_cast<const unsigned char*>(s->data()) + s_offset, n);
+        total += n;
+        t_offset += n;
+        s_offset += n;
+        if (t_offset == t->size())
+        {
+            ++t;
+            t_offset = 0u;
+        }
+        if (s_offset == s->size())
+        {
+            ++s;
+            s_offset = 0u;
+        }
+    }
+    return total;
+}
+
+}
+
 std::size_t buffer_copy(const mutable_buffer & target, const const_buffer & source) noexcept
 {
-    return asio::buffer_copy(target, source);
+    const auto n = (std::min)(target.size(), source.size());
+    copy_bytes(target.data(), source.data(), n);
+    return n;
+}
+
+std::size_t buffer_copy(const mutable_buffer & target, std::span<const const_buffer> source) noexcept
+{
+    return copy_sequence(std::span<const mutable_buffer>(&target, 1u), source);
+}
+
+std::size_t buffer_copy(std::span<const mutable_buffer> target, const const_buffer & source) noexcept
+{
+    return copy_sequence(target, std::span<const const_buffer>(&source, 1u));
+}
+
+std::size_t buffer_copy(std::span<const mutable_buffer> target, std::span<const const_buffer> source) noexcept
+{
+    return copy_sequence(target, source);
 }
 
 
@@ -22,4 +201,4 @@ template dynamic_buffer::dynamic_buffer(std::vector<unsigned char>&);
 
 template dynamic_buffer::dynamic_buffer(std::string &,               std::size_t &&);
 template dynamic_buffer::dynamic_buffer(std::vector<unsigned char>&, std::size_t &&);
-}
\ No newline at end of file
+}
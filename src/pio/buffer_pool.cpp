@@ -0,0 +1,205 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/buffer_pool.hpp>
+#include <pio/concepts.hpp>
+#include "detail/leased_read.hpp"
+
+#include <asio/post.hpp>
+
+#include <cassert>
+#include <cerrno>
+#include <new>
+#include <utility>
+
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace pio
+{
+
+void buffer_pool::slab_deleter::operator()(unsigned char * p) const noexcept
+{
+    ::operator delete(p, std::align_val_t{alignment});
+}
+
+buffer_pool::buffer_pool(std::size_t block_size, std::size_t block_count, std::size_t alignment)
+    : alignment_(alignment),
+      block_size_((block_size + alignment - 1u) / alignment * alignment),
+      block_count_(block_count),
+      slab_(static_cast<unsigned char*>(::operator new(block_size_ * block_count_, std::align_val_t{alignment_})),
+            slab_deleter{alignment_})
+{
+    free_.reserve(block_count_);
+    for (std::size_t i = block_count_; i > 0u; i--)
+        free_.push_back(slab_.get() + (i - 1u) * block_size_);
+}
+
+buffer_pool::~buffer_pool()
+{
+    assert(available() == block_count_);
+}
+
+std::size_t buffer_pool::available() const
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    return free_.size();
+}
+
+leased_buffer buffer_pool::try_acquire()
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (free_.empty())
+        return leased_buffer{};
+
+    auto block = free_.back();
+    free_.pop_back();
+    return leased_buffer{this, block};
+}
+
+void buffer_pool::deallocate_(unsigned char * block) noexcept
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    // can't throw, the capacity is reserved for all blocks
+    free_.push_back(block);
+}
+
+leased_buffer::leased_buffer(leased_buffer && lhs) noexcept
+    : pool_(std::exchange(lhs.pool_, nullptr)),
+      block_(std::exchange(lhs.block_, nullptr)),
+      size_(std::exchange(lhs.size_, 0u))
+{
+}
+
+leased_buffer& leased_buffer::operator=(leased_buffer && lhs) noexcept
+{
+    if (this != &lhs)
+    {
+        release();
+        pool_  = std::exchange(lhs.pool_, nullptr);
+        block_ = std::exchange(lhs.block_, nullptr);
+        size_  = std::exchange(lhs.size_, 0u);
+    }
+    return *this;
+}
+
+leased_buffer::~leased_buffer()
+{
+    release();
+}
+
+std::size_t leased_buffer::capacity() const noexcept
+{
+    return pool_ ? pool_->block_size() : 0u;
+}
+
+void leased_buffer::release() noexcept
+{
+    if (pool_)
+        std::exchange(pool_, nullptr)->deallocate_(block_);
+    block_ = nullptr;
+    size_ = 0u;
+}
+
+void concepts::async_read_stream::async_read_some_impl(buffer_pool & pool, handler_type<void(std::error_code, leased_buffer)> && h)
+{
+    auto buffer = pool.try_acquire();
+    if (!buffer)
+        return detail::post_leased(std::move(h), asio::error::no_buffer_space);
+
+    const auto mb = buffer.prepare();
+    auto st = detail::new_handler_state<detail::leased_read_state>(std::move(h), pool, std::move(buffer));
+    this->async_read_some(mb, detail::leased_read_op{{st}});
+}
+
+namespace detail
+{
+
+void post_leased(leased_handler && h, std::error_code ec)
+{
+    post_completion(std::move(h), ec, leased_buffer{});
+}
+
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+
+std::size_t read_nowait(int fd, const mutable_buffer & buffer, std::error_code & ec)
+{
+    ec.clear();
+    if (buffer.size() == 0u)
+        return 0u;
+
+    ::iovec iov{buffer.data(), buffer.size()};
+    ::ssize_t n = -1;
+#if defined(RWF_NOWAIT)
+    n = ::preadv2(fd, &iov, 1, -1, RWF_NOWAIT);
+    if (n < 0 && errno != EOPNOTSUPP && errno != ENOSYS && errno != EINVAL)
+    {
+        ec.assign(errno, std::system_category());
+        return 0u;
+    }
+#endif
+    if (n < 0)
+    {
+        // RWF_NOWAIT isn't supported for this kind of file, e.g. a tty. set O_NONBLOCK only for this read.
+        const int fl = ::fcntl(fd, F_GETFL);
+        if (fl < 0)
+        {
+            ec.assign(errno, std::system_category());
+            return 0u;
+        }
+        if (!(fl & O_NONBLOCK))
+            ::fcntl(fd, F_SETFL, fl | O_NONBLOCK);
+        n = ::readv(fd, &iov, 1);
+        const int err = errno;
+        if (!(fl & O_NONBLOCK))
+            ::fcntl(fd, F_SETFL, fl);
+        if (n < 0)
+        {
+            ec.assign(err, std::system_category());
+            return 0u;
+        }
+    }
+
+    if (n == 0)
+        ec = asio::error::eof;
+    return static_cast<std::size_t>(n);
+}
+
+void async_ready_read(std::shared_ptr<asio::posix::stream_descriptor> & waiter,
+                      const asio::any_io_executor & exec, int fd,
+                      buffer_pool & pool, leased_handler && h)
+{
+    if (!waiter)
+    {
+        const int dp = ::dup(fd);
+        if (dp < 0)
+            return post_leased(std::move(h), std::error_code(errno, std::system_category()));
+        waiter = std::make_shared<asio::posix::stream_descriptor>(exec, dp);
+    }
+
+    auto st = new_handler_state<leased_read_state>(std::move(h), pool, leased_buffer{});
+    st->waiter = waiter;
+    waiter->async_wait(asio::posix::descriptor_base::wait_read, ready_read_op{{st}});
+}
+
+void reset_waiter(std::shared_ptr<asio::posix::stream_descriptor> & waiter)
+{
+    if (!waiter)
+        return;
+    std::error_code ec;
+    waiter->close(ec);
+    waiter.reset();
+}
+
+#endif
+
+}
+
+}
@@ -0,0 +1,372 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/cached_random_access_device.hpp>
+#include <pio/direct_io.hpp>
+#include <pio/read_at.hpp>
+#include "detail/handler_state.hpp"
+
+#include <asio/error.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace pio
+{
+
+namespace detail
+{
+
+using read_handler_t = handler_type<void(std::error_code, std::size_t)>;
+using block_data = std::vector<unsigned char, aligned_allocator<unsigned char>>;
+
+struct cache_entry
+{
+    std::uint64_t block;
+    block_data data;
+    // the valid bytes, less than the block size at the end of the device.
+    std::size_t size;
+    // the referenced bit for clock, the access count (up to 3) for s3-fifo.
+    std::uint8_t freq = 0u;
+};
+
+// a read waiting for a block to arrive from the next layer.
+struct cache_waiter
+{
+    std::uint64_t offset;
+    mutable_buffer buffer;
+    read_handler_t handler;
+};
+
+struct cache_shard
+{
+    using entry_list = std::list<cache_entry>;
+
+    std::mutex mtx;
+    std::unordered_map<std::uint64_t, entry_list::iterator> index;
+    // clock only uses main, as a ring with the hand.
+    entry_list small, main;
+    entry_list::iterator hand = main.end();
+    // s3-fifo ghost queue, the blocks recently evicted from small.
+    std::list<std::uint64_t> ghost;
+    std::unordered_map<std::uint64_t, std::list<std::uint64_t>::iterator> ghost_index;
+
+    std::unordered_map<std::uint64_t, std::vector<cache_waiter>> pending;
+    std::size_t outstanding = 0u;
+};
+
+struct block_cache_state
+{
+    using options = cached_random_access_device::options;
+
+    block_cache_state(concepts::async_random_access_read_device & next, options opts)
+        : next(next), opts(opts), shards(opts.shards)
+    {
+        const auto blocks = std::max<std::size_t>(opts.capacity / opts.block_size, 1u);
+        shard_capacity = std::max<std::size_t>(blocks / opts.shards, 1u);
+        small_capacity = std::max<std::size_t>(shard_capacity / 10u, 1u);
+    }
+
+    concepts::async_random_access_read_device & next;
+    const options opts;
+    std::vector<cache_shard> shards;
+    // in blocks
+    std::size_t shard_capacity;
+    std::size_t small_capacity;
+
+    std::atomic<std::uint64_t> hits{0u}, misses{0u}, coalesced{0u}, evictions{0u};
+    std::atomic<std::size_t> size{0u};
+
+    cache_shard & shard_of(std::uint64_t block)
+    {
+        // fibonacci hashing, so strided access patterns still spread over the shards.
+        return shards[(block * 0x9E3779B97F4A7C15ull >> 32) % shards.size()];
+    }
+};
+
+namespace
+{
+
+using state = block_cache_state;
+
+
+// copy the requested part of the block, eof if it's past the end of the device.
+std::pair<std::error_code, std::size_t> copy_out(const state & st, const cache_entry & e,
+                                                 std::uint64_t offset, mutable_buffer buffer)
+{
+    const auto in_block = static_cast<std::size_t>(offset - e.block * st.opts.block_size);
+    if (in_block >= e.size)
+        return {asio::error::eof, 0u};
+    const auto n = std::min(buffer.size(), e.size - in_block);
+    std::memcpy(buffer.data(), e.data.data() + in_block, n);
+    return {std::error_code{}, n};
+}
+
+void remove(state & st, cache_shard & sh, cache_shard::entry_list & list, cache_shard::entry_list::iterator itr)
+{
+    st.evictions.fetch_add(1u, std::memory_order_relaxed);
+    st.size.fetch_sub(itr->size, std::memory_order_relaxed);
+    sh.index.erase(itr->block);
+    if (&list == &sh.main && itr == sh.hand)
+        sh.hand = list.erase(itr);
+    else
+        list.erase(itr);
+}
+
+void evict_clock(state & st, cache_shard & sh)
+{
+    // give every referenced block a second chance.
+    while (true)
+    {
+        if (sh.hand == sh.main.end())
+            sh.hand = sh.main.begin();
+        if (sh.hand->freq == 0u)
+            return remove(st, sh, sh.main, sh.hand);
+        sh.hand->freq = 0u;
+        ++sh.hand;
+    }
+}
+
+void remember_ghost(state & st, cache_shard & sh, std::uint64_t block)
+{
+    sh.ghost.push_front(block);
+    sh.ghost_index[block] = sh.ghost.begin();
+    if (sh.ghost.size() > st.shard_capacity)
+    {
+        sh.ghost_index.erase(sh.ghost.back());
+        sh.ghost.pop_back();
+    }
+}
+
+void evict_s3_fifo(state & st, cache_shard & sh)
+{
+    while (true)
+    {
+        if (!sh.small.empty() && (sh.small.size() >= st.small_capacity || sh.main.empty()))
+        {
+            auto itr = std::prev(sh.small.end());
+            if (itr->freq > 1u)
+            {
+                // accessed again while on probation, promote it.
+                itr->freq = 0u;
+                sh.main.splice(sh.main.begin(), sh.small, itr);
+                continue;
+            }
+            remember_ghost(st, sh, itr->block);
+            return remove(st, sh, sh.small, itr);
+        }
+
+        auto itr = std::prev(sh.main.end());
+        if (itr->freq > 0u)
+        {
+            itr->freq--;
+            sh.main.splice(sh.main.begin(), sh.main, itr);
+            continue;
+        }
+        return remove(st, sh, sh.main, itr);
+    }
+}
+
+void touch(state & st, cache_entry & e)
+{
+    if (st.opts.policy == cached_random_access_device::eviction::clock)
+        e.freq = 1u;
+    else if (e.freq < 3u)
+        e.freq++;
+}
+
+cache_entry & insert(state & st, cache_shard & sh, std::uint64_t block, block_data && data, std::size_t size)
+{
+    while (sh.index.size() >= st.shard_capacity)
+    {
+        if (st.opts.policy == cached_random_access_device::eviction::clock)
+            evict_clock(st, sh);
+        else
+            evict_s3_fifo(st, sh);
+    }
+
+    st.size.fetch_add(size, std::memory_order_relaxed);
+    cache_entry e{block, std::move(data), size};
+    cache_shard::entry_list::iterator itr;
+    if (st.opts.policy == cached_random_access_device::eviction::clock)
+        // right behind the hand, i.e. the last one it visits.
+        itr = sh.main.insert(sh.hand, std::move(e));
+    else if (auto g = sh.ghost_index.find(block); g != sh.ghost_index.end())
+    {
+        // evicted from small not long ago, so it goes straight to main.
+        sh.ghost.erase(g->second);
+        sh.ghost_index.erase(g);
+        sh.main.push_front(std::move(e));
+        itr = sh.main.begin();
+    }
+    else
+    {
+        sh.small.push_front(std::move(e));
+        itr = sh.small.begin();
+    }
+
+    sh.index.emplace(block, itr);
+    return *itr;
+}
+
+struct fill_op
+{
+    state * st;
+    cache_shard * sh;
+    std::uint64_t block;
+    block_data data;
+
+    void operator()(std::error_code ec, std::size_t n)
+    {
+        // a short block at the end of the device
+        if (ec == asio::error::eof)
+            ec.clear();
+
+        std::vector<cache_waiter> waiters;
+        std::vector<std::pair<std::error_code, std::size_t>> results;
+        {
+            std::lock_guard<std::mutex> lock{sh->mtx};
+            sh->outstanding--;
+            auto itr = sh->pending.find(block);
+            assert(itr != sh->pending.end());
+            waiters = std::move(itr->second);
+            sh->pending.erase(itr);
+
+            if (ec)
+                results.assign(waiters.size(), {ec, 0u});
+            else if (n == 0u)
+                results.assign(waiters.size(), {asio::error::eof, 0u});
+            else
+            {
+                auto & e = insert(*st, *sh, block, std::move(data), n);
+                for (auto & w : waiters)
+                    results.push_back(copy_out(*st, e, w.offset, w.buffer));
+            }
+        }
+
+        for (std::size_t i = 0u; i < waiters.size(); i++)
+            post_completion(std::move(waiters[i].handler), results[i].first, results[i].second);
+    }
+};
+
+}
+
+}
+
+cached_random_access_device::cached_random_access_device(concepts::async_random_access_read_device & next)
+    : cached_random_access_device(next, options{})
+{
+}
+
+cached_random_access_device::cached_random_access_device(concepts::async_random_access_read_device & next, options opts)
+{
+    opts.block_size = std::max<std::size_t>(opts.block_size, 1u);
+    // every shard holds at least one block, so more shards than blocks would exceed the capacity.
+    opts.shards = std::clamp<std::size_t>(opts.shards, 1u, std::max<std::size_t>(opts.capacity / opts.block_size, 1u));
+    state_ = std::make_unique<detail::block_cache_state>(next, opts);
+}
+
+cached_random_access_device::~cached_random_access_device()
+{
+#if !defined(NDEBUG)
+    for (auto & sh : state_->shards)
+        assert(sh.outstanding == 0u);
+#endif
+}
+
+auto cached_random_access_device::get_executor() -> executor_type
+{
+    return state_->next.get_executor();
+}
+
+auto cached_random_access_device::stats() const -> statistics
+{
+    auto & st = *state_;
+    statistics res;
+    res.hits      = st.hits.load(std::memory_order_relaxed);
+    res.misses    = st.misses.load(std::memory_order_relaxed);
+    res.coalesced = st.coalesced.load(std::memory_order_relaxed);
+    res.evictions = st.evictions.load(std::memory_order_relaxed);
+    res.size      = st.size.load(std::memory_order_relaxed);
+    return res;
+}
+
+void cached_random_access_device::reset_stats()
+{
+    auto & st = *state_;
+    st.hits.store(0u, std::memory_order_relaxed);
+    st.misses.store(0u, std::memory_order_relaxed);
+    st.coalesced.store(0u, std::memory_order_relaxed);
+    st.evictions.store(0u, std::memory_order_relaxed);
+}
+
+void cached_random_access_device::invalidate()
+{
+    auto & st = *state_;
+    for (auto & sh : st.shards)
+    {
+        std::lock_guard<std::mutex> lock{sh.mtx};
+        std::size_t bytes = 0u;
+        for (auto & e : sh.small)
+            bytes += e.size;
+        for (auto & e : sh.main)
+            bytes += e.size;
+        st.size.fetch_sub(bytes, std::memory_order_relaxed);
+
+        sh.index.clear();
+        sh.small.clear();
+        sh.main.clear();
+        sh.hand = sh.main.end();
+        sh.ghost.clear();
+        sh.ghost_index.clear();
+    }
+}
+
+void cached_random_access_device::async_read_some_at_impl(std::uint64_t offset, mutable_buffer buffer,
+                                                          handler_type<void(std::error_code, std::size_t)> && h)
+{
+    auto & st = *state_;
+    if (buffer.size() == 0u)
+        return detail::post_completion(std::move(h), std::error_code{}, 0u);
+
+    const auto block = offset / st.opts.block_size;
+    auto & sh = st.shard_of(block);
+    {
+        std::lock_guard<std::mutex> lock{sh.mtx};
+        if (auto itr = sh.index.find(block); itr != sh.index.end())
+        {
+            st.hits.fetch_add(1u, std::memory_order_relaxed);
+            detail::touch(st, *itr->second);
+            auto [ec, n] = detail::copy_out(st, *itr->second, offset, buffer);
+            return detail::post_completion(std::move(h), ec, n);
+        }
+
+        if (auto itr = sh.pending.find(block); itr != sh.pending.end())
+        {
+            st.coalesced.fetch_add(1u, std::memory_order_relaxed);
+            itr->second.push_back({offset, buffer, std::move(h)});
+            return;
+        }
+
+        st.misses.fetch_add(1u, std::memory_order_relaxed);
+        sh.pending[block].push_back({offset, buffer, std::move(h)});
+        sh.outstanding++;
+    }
+
+    detail::block_data data(st.opts.block_size, aligned_allocator<unsigned char>(st.opts.alignment));
+    const auto target = mutable_buffer(data.data(), data.size());
+    pio::async_read_at(st.next, block * st.opts.block_size, target,
+                       detail::fill_op{&st, &sh, block, std::move(data)});
+}
+
+}
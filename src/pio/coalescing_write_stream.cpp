@@ -0,0 +1,393 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/coalescing_write_stream.hpp>
+#include <pio/write.hpp>
+#include "detail/handler_state.hpp"
+
+#include <asio/error.hpp>
+#include <asio/steady_timer.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace pio
+{
+
+namespace detail
+{
+
+using write_handler_t = handler_type<void(std::error_code, std::size_t)>;
+using flush_handler_t = handler_type<void(std::error_code)>;
+
+// The state is on the heap, so that a flush or timer in flight can outlive the stream.
+struct coalescing_state
+{
+    using options = coalescing_write_stream::options;
+
+    coalescing_state(concepts::async_write_stream & next, options opts)
+        : next(next), opts(opts), timer(next.get_executor())
+    {
+        for (auto & g : generations)
+            g.data.reserve(opts.capacity);
+    }
+
+    // the data buffered between two flushes & who's waiting for it.
+    struct generation
+    {
+        std::vector<unsigned char> data;
+        std::vector<std::pair<write_handler_t, std::size_t>> writers;
+        std::vector<flush_handler_t> flushers;
+    };
+
+    concepts::async_write_stream & next;
+    options opts;
+
+    // one generation accepts writes, while the other one is flushed.
+    generation generations[2];
+    std::size_t active = 0u;
+    bool flushing = false;
+    // a flush was requested or the timer expired while another flush was in flight.
+    bool flush_requested = false;
+    std::error_code error;
+
+    asio::steady_timer timer;
+    // invalidates waits of the timer that were cancelled.
+    std::size_t timer_generation = 0u;
+    bool timer_armed = false;
+
+    // a write waiting for room in the buffer.
+    std::optional<write_handler_t> blocked;
+    const_buffer blocked_single;
+    std::span<const const_buffer> blocked_buffers;
+
+    // a large write that's passed through with the flush.
+    std::optional<write_handler_t> passthrough;
+    std::vector<const_buffer> gathered;
+
+    // the flush & timer waits in flight, the last one deletes an orphaned state.
+    std::size_t outstanding = 0u;
+    bool orphaned = false;
+};
+
+namespace
+{
+
+using state = coalescing_state;
+
+void start_flush(state & st, std::span<const const_buffer> extra = {});
+void accept(state & st, std::span<const const_buffer> buffers, write_handler_t && h);
+
+// an async op of the state finished, returns true if the stream is gone.
+bool release(state & st)
+{
+    st.outstanding--;
+    if (st.orphaned && st.outstanding == 0u)
+    {
+        delete &st;
+        return true;
+    }
+    return st.orphaned;
+}
+
+struct timer_op
+{
+    state * st;
+    std::size_t generation;
+
+    void operator()(std::error_code ec)
+    {
+        if (release(*st) || generation != st->timer_generation)
+            return;
+
+        st->timer_armed = false;
+        if (ec)
+            return;
+        if (st->flushing)
+            st->flush_requested = true;
+        else if (!st->generations[st->active].data.empty())
+            start_flush(*st);
+    }
+};
+
+void arm_timer(state & st)
+{
+    if (st.opts.delay == std::chrono::steady_clock::duration::zero() || st.timer_armed)
+        return;
+
+    st.timer_armed = true;
+    st.outstanding++;
+    st.timer.expires_after(st.opts.delay);
+    st.timer.async_wait(timer_op{&st, ++st.timer_generation});
+}
+
+void disarm_timer(state & st)
+{
+    st.timer_generation++;
+    if (st.timer_armed)
+    {
+        st.timer_armed = false;
+        st.timer.cancel();
+    }
+}
+
+// the handlers of a generation that won't be flushed by the stream anymore.
+void abort_generation(coalescing_state::generation & g)
+{
+    for (auto & [h, written] : g.writers)
+        post_completion(std::move(h), asio::error::operation_aborted, std::size_t(0u));
+    for (auto & h : g.flushers)
+        post_completion(std::move(h), asio::error::operation_aborted);
+    g.writers.clear();
+    g.flushers.clear();
+}
+
+struct flush_op
+{
+    state * st;
+    std::size_t index;
+
+    void operator()(std::error_code ec, std::size_t n)
+    {
+        // the buffers of the flush were in use until now, so its handlers are completed here & not by the destructor.
+        if (st->orphaned)
+        {
+            abort_generation(st->generations[index]);
+            if (st->passthrough)
+            {
+                post_completion(std::move(*st->passthrough), asio::error::operation_aborted, std::size_t(0u));
+                st->passthrough.reset();
+            }
+            release(*st);
+            return;
+        }
+        release(*st);
+
+        auto & g = st->generations[index];
+        if (ec && !st->error)
+            st->error = ec;
+
+        for (auto & [h, written] : g.writers)
+            post_completion(std::move(h), ec, ec ? std::size_t(0u) : written);
+        for (auto & h : g.flushers)
+            post_completion(std::move(h), ec);
+
+        if (st->passthrough)
+        {
+            const auto buffered = g.data.size();
+            post_completion(std::move(*st->passthrough), ec, n > buffered ? n - buffered : std::size_t(0u));
+            st->passthrough.reset();
+        }
+
+        g.writers.clear();
+        g.flushers.clear();
+        g.data.clear();
+        st->flushing = false;
+
+        if (st->blocked)
+        {
+            auto h = std::move(*st->blocked);
+            st->blocked.reset();
+            accept(*st, st->blocked_buffers, std::move(h));
+        }
+
+        // the data in the other buffer was due while this flush was in flight.
+        auto & a = st->generations[st->active];
+        if (!st->flushing && !a.data.empty()
+            && (st->flush_requested || a.data.size() == st->opts.capacity))
+            start_flush(*st);
+    }
+};
+
+void start_flush(state & st, std::span<const const_buffer> extra)
+{
+    assert(!st.flushing);
+    const auto index = st.active;
+    auto & g = st.generations[index];
+    st.active ^= 1u;
+    st.flushing = true;
+    st.flush_requested = false;
+    disarm_timer(st);
+
+    st.gathered.clear();
+    if (!g.data.empty())
+        st.gathered.emplace_back(g.data.data(), g.data.size());
+    st.gathered.insert(st.gathered.end(), extra.begin(), extra.end());
+
+    st.outstanding++;
+    pio::async_write(st.next, std::span<const const_buffer>(st.gathered), flush_op{&st, index});
+}
+
+void accept(state & st, std::span<const const_buffer> buffers, write_handler_t && h)
+{
+    const auto total = asio::buffer_size(buffers);
+    if (st.error)
+        return post_completion(std::move(h), st.error, std::size_t(0u));
+    if (total == 0u)
+        return post_completion(std::move(h), std::error_code{}, std::size_t(0u));
+
+    // large enough to not be worth copying, write it right after the buffered data.
+    if (!st.flushing && total >= st.opts.capacity)
+    {
+        st.passthrough.emplace(std::move(h));
+        return start_flush(st, buffers);
+    }
+
+    auto & g = st.generations[st.active];
+    const auto room = st.opts.capacity - g.data.size();
+    if (room == 0u)
+    {
+        // both buffers are full, wait for the flush in flight.
+        st.blocked.emplace(std::move(h));
+        if (buffers.size() == 1u)
+        {
+            st.blocked_single = buffers.front();
+            st.blocked_buffers = std::span<const const_buffer>(&st.blocked_single, 1u);
+        }
+        else
+            st.blocked_buffers = buffers;
+        return;
+    }
+
+    const bool was_empty = g.data.empty();
+    std::size_t n = 0u;
+    for (const auto & b : buffers)
+    {
+        const auto chunk = std::min(b.size(), room - n);
+        const auto p = static_cast<const unsigned char*>(b.data());
+        g.data.insert(g.data.end(), p, p + chunk);
+        n += chunk;
+        if (n == room)
+            break;
+    }
+
+    if (st.opts.complete == coalescing_write_stream::completion::on_enqueue)
+        post_completion(std::move(h), std::error_code{}, n);
+    else
+        g.writers.emplace_back(std::move(h), n);
+
+    if (g.data.size() == st.opts.capacity)
+    {
+        if (!st.flushing)
+            start_flush(st);
+    }
+    else if (was_empty)
+        arm_timer(st);
+}
+
+}
+
+}
+
+coalescing_write_stream::coalescing_write_stream(concepts::async_write_stream & next)
+    : coalescing_write_stream(next, options{})
+{
+}
+
+coalescing_write_stream::coalescing_write_stream(concepts::async_write_stream & next, options opts)
+{
+    opts.capacity = std::max<std::size_t>(opts.capacity, 1u);
+    state_ = new detail::coalescing_state(next, opts);
+}
+
+coalescing_write_stream::coalescing_write_stream(coalescing_write_stream && lhs) noexcept
+    : state_(std::exchange(lhs.state_, nullptr))
+{
+}
+
+coalescing_write_stream& coalescing_write_stream::operator=(coalescing_write_stream && lhs) noexcept
+{
+    if (this != &lhs)
+    {
+        destroy_();
+        state_ = std::exchange(lhs.state_, nullptr);
+    }
+    return *this;
+}
+
+coalescing_write_stream::~coalescing_write_stream()
+{
+    destroy_();
+}
+
+void coalescing_write_stream::destroy_() noexcept
+{
+    if (!state_)
+        return;
+
+    auto st = std::exchange(state_, nullptr);
+    // the generation accepting writes isn't flushing, the other one is completed by the flush in flight.
+    detail::abort_generation(st->generations[st->active]);
+    if (st->blocked)
+    {
+        detail::post_completion(std::move(*st->blocked), asio::error::operation_aborted, std::size_t(0u));
+        st->blocked.reset();
+    }
+
+    if (st->outstanding == 0u)
+    {
+        delete st;
+        return;
+    }
+
+    st->orphaned = true;
+    detail::disarm_timer(*st);
+}
+
+auto coalescing_write_stream::get_executor() -> executor_type
+{
+    assert(state_);
+    return state_->next.get_executor();
+}
+
+std::size_t coalescing_write_stream::buffered() const
+{
+    assert(state_);
+    return state_->generations[0].data.size() + state_->generations[1].data.size();
+}
+
+void coalescing_write_stream::async_write_some_impl(const_buffer buffer, handler_type<void(std::error_code, std::size_t)> && h)
+{
+    assert(state_);
+    detail::accept(*state_, std::span<const const_buffer>(&buffer, 1u), std::move(h));
+}
+
+void coalescing_write_stream::async_write_some_impl(std::span<const const_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h)
+{
+    assert(state_);
+    detail::accept(*state_, buffers, std::move(h));
+}
+
+void coalescing_write_stream::async_flush_impl(handler_type<void(std::error_code)> && h)
+{
+    assert(state_);
+    auto & st = *state_;
+    auto & a = st.generations[st.active];
+    if (st.error)
+        return detail::post_completion(std::move(h), st.error);
+
+    if (a.data.empty())
+    {
+        // nothing new, wait for the flush in flight if any.
+        if (st.flushing)
+            st.generations[st.active ^ 1u].flushers.push_back(std::move(h));
+        else
+            detail::post_completion(std::move(h), std::error_code{});
+        return;
+    }
+
+    a.flushers.push_back(std::move(h));
+    if (st.flushing)
+        st.flush_requested = true;
+    else
+        detail::start_flush(st);
+}
+
+}
@@ -0,0 +1,359 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/copy_file.hpp>
+#include "detail/blocking_pool.hpp"
+#include "detail/handler_state.hpp"
+
+#include <asio/error.hpp>
+#include <asio/post.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace pio::detail
+{
+
+namespace
+{
+
+using copy_handler = handler_type<void(std::error_code, std::uint64_t)>;
+
+enum class copy_phase
+{
+    reflink,
+    kernel,
+    user_space
+};
+
+// one of the chunks of the user space fallback in flight. positions are relative to the start of the copy.
+struct copy_lane
+{
+    std::uint64_t position = 0u, end = 0u;
+    unsigned char * buffer = nullptr;
+    std::size_t filled = 0u, written = 0u;
+    bool reading = false;
+};
+
+struct copy_state : handler_state<void(std::error_code, std::uint64_t)>
+{
+    copy_state(random_access_file & src, random_access_file & dst,
+               std::uint64_t offset_in, std::uint64_t offset_out, std::uint64_t len,
+               copy_file_options && options, copy_handler && h)
+        : handler_state(std::move(h)), src(src), dst(dst),
+          offset_in(offset_in), offset_out(offset_out), len(len),
+          options(std::move(options)), lanes(allocator.resource())
+    {
+#if defined(__linux__)
+        if (this->options.reflink)
+            phase = copy_phase::reflink;
+        else if (this->options.kernel_chunk_size > 0u)
+            phase = copy_phase::kernel;
+#endif
+    }
+
+    random_access_file & src, & dst;
+    std::uint64_t offset_in, offset_out, len;
+    copy_file_options options;
+    copy_phase phase = copy_phase::user_space;
+    std::atomic<bool> cancelled{false};
+
+    // guards everything below while the lanes are running.
+    std::mutex mutex;
+    std::uint64_t copied = 0u, claimed = 0u;
+    std::size_t active = 0u;
+    std::error_code error;
+    std::pmr::vector<copy_lane> lanes;
+    std::unique_ptr<unsigned char[]> buffers;
+};
+
+using copy_ptr = handler_state_ptr<copy_state>;
+
+void complete(copy_ptr st, std::error_code ec)
+{
+    auto slot = st->handler.get_cancellation_slot();
+    if (slot.is_connected())
+        slot.clear();
+
+    auto h = std::move(st->handler);
+    const auto n = st->copied;
+    st.reset();
+    h(ec, n);
+}
+
+void report_progress(copy_state & st)
+{
+    if (st.options.progress)
+        st.options.progress(st.copied);
+}
+
+// Base of the intermediate handlers of the lanes.
+struct copy_op_base
+{
+    using executor_type = asio::any_io_executor;
+    using allocator_type = std::pmr::polymorphic_allocator<void>;
+};
+
+// the outcome of a syscall run on the blocking pool.
+struct syscall_result
+{
+    long result;
+    int error;
+};
+
+// a step of the in-kernel copy. The syscalls run on the blocking pool, one chunk at a time,
+// so neither the io_context nor a pool thread is occupied for the whole copy.
+struct copy_step_op : copy_op_base
+{
+    copy_ptr state;
+
+    executor_type get_executor() const {return state->handler.get_executor();}
+    allocator_type get_allocator() const {return state->allocator;}
+
+    void operator()();
+    void operator()(syscall_result res);
+};
+
+// the reads & writes of a lane, the last lane to finish deletes the state.
+struct copy_lane_op : copy_op_base
+{
+    copy_state * state;
+    std::size_t index;
+
+    executor_type get_executor() const {return state->handler.get_executor();}
+    allocator_type get_allocator() const {return state->allocator;}
+
+    void operator()(std::error_code ec, std::size_t n);
+};
+
+void lane_read(copy_state & st, std::size_t index)
+{
+    auto & l = st.lanes[index];
+    l.reading = true;
+    const auto n = static_cast<std::size_t>(std::min<std::uint64_t>(l.end - l.position, st.options.chunk_size));
+    st.src.async_read_some_at(st.offset_in + l.position, asio::buffer(l.buffer, n), copy_lane_op{{}, &st, index});
+}
+
+void lane_write(copy_state & st, std::size_t index)
+{
+    auto & l = st.lanes[index];
+    l.reading = false;
+    st.dst.async_write_some_at(st.offset_out + l.position + l.written,
+                               asio::buffer(l.buffer + l.written, l.filled - l.written),
+                               copy_lane_op{{}, &st, index});
+}
+
+// the lanes finish out of order, so the bytes copied are only a contiguous prefix up to the lowest gap.
+std::uint64_t copied_prefix(const copy_state & st)
+{
+    auto prefix = st.claimed;
+    for (const auto & l : st.lanes)
+        if (l.position < l.end)
+            prefix = std::min(prefix, l.position + (l.reading ? 0u : l.written));
+    return prefix;
+}
+
+void lane_finish(copy_state & st, std::error_code ec)
+{
+    std::unique_lock<std::mutex> lock{st.mutex};
+    if (ec && !st.error)
+        st.error = ec;
+    if (--st.active > 0u)
+        return;
+    lock.unlock();
+
+    ec = st.error;
+    if (!ec && st.cancelled)
+        ec = asio::error::operation_aborted;
+    if (ec)
+        st.copied = copied_prefix(st);
+    complete(copy_ptr{&st}, ec);
+}
+
+void copy_lane_op::operator()(std::error_code ec, std::size_t n)
+{
+    auto & st = *state;
+    auto & l = st.lanes[index];
+    if (l.reading)
+    {
+        if (!ec && n == 0u)
+            ec = asio::error::eof;
+        if (ec)
+            return lane_finish(st, ec);
+        l.filled = n;
+        l.written = 0u;
+        return lane_write(st, index);
+    }
+
+    if (ec)
+        return lane_finish(st, ec);
+    l.written += n;
+    if (l.written < l.filled)
+        return lane_write(st, index);
+
+    l.position += l.filled;
+    bool done = false;
+    {
+        std::lock_guard<std::mutex> lock{st.mutex};
+        st.copied += l.filled;
+        report_progress(st);
+        if (st.error || st.cancelled)
+            done = true;
+        else if (l.position == l.end)
+        {
+            // claim the next chunk
+            if (st.claimed < st.len)
+            {
+                l.position = st.claimed;
+                l.end = std::min<std::uint64_t>(st.claimed + st.options.chunk_size, st.len);
+                st.claimed = l.end;
+            }
+            else
+                done = true;
+        }
+    }
+
+    if (done)
+        lane_finish(st, {});
+    else
+        lane_read(st, index);
+}
+
+void start_user_space(copy_ptr state)
+{
+    auto & st = *state;
+    const std::uint64_t chunk = st.options.chunk_size;
+    const auto count = static_cast<std::size_t>(
+            std::min<std::uint64_t>(st.options.queue_depth, (st.len - st.copied + chunk - 1u) / chunk));
+
+    st.buffers = std::make_unique_for_overwrite<unsigned char[]>(count * st.options.chunk_size);
+    st.lanes.resize(count);
+    st.active = count;
+    // continue where the kernel stopped, if it did copy anything.
+    st.claimed = st.copied;
+    // all ranges are claimed before any lane starts, so this doesn't need the lock.
+    for (std::size_t i = 0u; i < count; i++)
+    {
+        auto & l = st.lanes[i];
+        l.buffer = st.buffers.get() + i * st.options.chunk_size;
+        l.position = st.claimed;
+        l.end = std::min<std::uint64_t>(st.claimed + chunk, st.len);
+        st.claimed = l.end;
+    }
+
+    auto p = state.release();
+    for (std::size_t i = 0u; i < count; i++)
+        lane_read(*p, i);
+}
+
+void copy_step_op::operator()()
+{
+    auto & st = *state;
+    if (st.cancelled)
+        return complete(std::move(state), asio::error::operation_aborted);
+    if (st.copied == st.len)
+        return complete(std::move(state), {});
+
+#if defined(__linux__)
+    const int src = st.src.native_handle(), dst = st.dst.native_handle();
+    auto exec = st.handler.get_executor();
+    if (st.phase == copy_phase::reflink)
+    {
+        // the clone of the whole range can take a while on large files, since it updates all the extents.
+        const file_clone_range range{src, st.offset_in, st.len, st.offset_out};
+        return run_blocking(exec,
+                            [dst, range]() mutable
+                            {
+                                const auto res = ::ioctl(dst, FICLONERANGE, &range);
+                                return syscall_result{res, res == 0 ? 0 : errno};
+                            },
+                            std::move(*this));
+    }
+
+    if (st.phase == copy_phase::kernel)
+    {
+        const auto in  = static_cast<loff_t>(st.offset_in  + st.copied),
+                   out = static_cast<loff_t>(st.offset_out + st.copied);
+        const auto n = static_cast<std::size_t>(std::min<std::uint64_t>(st.len - st.copied, st.options.kernel_chunk_size));
+        return run_blocking(exec,
+                            [src, dst, in, out, n]() mutable
+                            {
+                                auto i = in, o = out;
+                                const auto res = ::copy_file_range(src, &i, dst, &o, n, 0u);
+                                return syscall_result{static_cast<long>(res), res < 0 ? errno : 0};
+                            },
+                            std::move(*this));
+    }
+#endif
+
+    start_user_space(std::move(state));
+}
+
+void copy_step_op::operator()(syscall_result res)
+{
+    auto & st = *state;
+#if defined(__linux__)
+    if (st.phase == copy_phase::reflink)
+    {
+        st.phase = st.options.kernel_chunk_size > 0u ? copy_phase::kernel : copy_phase::user_space;
+        if (res.result == 0)
+        {
+            st.copied = st.len;
+            report_progress(st);
+            return complete(std::move(state), {});
+        }
+        // no reflink support, different filesystems or unaligned ranges: copy the data.
+    }
+    else if (res.result > 0)
+    {
+        st.copied += static_cast<std::uint64_t>(res.result);
+        report_progress(st);
+    }
+    else if (res.result == 0)
+        return complete(std::move(state), asio::error::eof);
+    else if (res.error != EINTR)
+    {
+        if (res.error != EXDEV && res.error != ENOSYS && res.error != EOPNOTSUPP && res.error != EINVAL)
+            return complete(std::move(state), std::error_code(res.error, std::system_category()));
+        st.phase = copy_phase::user_space;
+    }
+#endif
+    (*this)();
+}
+
+}
+
+void async_copy_file_impl(random_access_file & src, random_access_file & dst,
+                          std::uint64_t offset_in, std::uint64_t offset_out, std::uint64_t len,
+                          copy_file_options && options, copy_handler && h)
+{
+    options.chunk_size        = std::max<std::size_t>(options.chunk_size, 1u);
+    options.queue_depth       = std::max<std::size_t>(options.queue_depth, 1u);
+
+    copy_ptr st{new_handler_state<copy_state>(std::move(h), src, dst, offset_in, offset_out, len, std::move(options))};
+
+    auto slot = st->handler.get_cancellation_slot();
+    if (slot.is_connected())
+        slot.assign([p = st.get()](asio::cancellation_type) {p->cancelled = true;});
+
+    // the first step is posted, so the copy never completes from within the initiating function.
+    auto exec = st->handler.get_executor();
+    asio::post(exec, copy_step_op{{}, std::move(st)});
+}
+
+}
@@ -0,0 +1,54 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_DETAIL_BLOCKING_POOL_HPP
+#define PIO_DETAIL_BLOCKING_POOL_HPP
+
+#include <pio/handler.hpp>
+
+#include <asio/execution/outstanding_work.hpp>
+#include <asio/post.hpp>
+#include <asio/prefer.hpp>
+#include <asio/thread_pool.hpp>
+
+#include <tuple>
+#include <utility>
+
+namespace pio::detail
+{
+
+// The threads running syscalls that can block for long, e.g. fsync, so they don't stall an io_context.
+asio::thread_pool & blocking_pool();
+
+// Run `f` on the blocking pool & `c` with its result on `exec`, which is kept busy until then.
+template<typename Executor, typename Function, typename Completion>
+void run_blocking(const Executor & exec, Function f, Completion c)
+{
+    auto work = asio::prefer(exec, asio::execution::outstanding_work.tracked);
+    asio::post(blocking_pool(),
+               [work = std::move(work), f = std::move(f), c = std::move(c)]() mutable
+               {
+                   auto res = f();
+                   asio::post(work, [c = std::move(c), res = std::move(res)]() mutable {c(std::move(res));});
+               });
+}
+
+// Run `f` on the blocking pool & complete the handler with the tuple it returns on the handler's executor.
+template<typename ... Args, typename Function>
+void run_blocking(handler_type<void(Args...)> && h, Function f)
+{
+    auto exec = h.get_executor();
+    run_blocking(exec, std::move(f),
+                 [h = std::move(h)](std::tuple<Args...> res) mutable
+                 {
+                     std::apply(std::move(h), std::move(res));
+                 });
+}
+
+}
+
+#endif //PIO_DETAIL_BLOCKING_POOL_HPP
@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_DETAIL_HANDLER_STATE_HPP
+#define PIO_DETAIL_HANDLER_STATE_HPP
+
+#include <pio/handler.hpp>
+
+#include <asio/post.hpp>
+
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+namespace pio::detail
+{
+
+// Base of the heap state of a composed operation, that owns the final handler.
+// The state is allocated with the handler's allocator, since it's shared by all the parts of the operation.
+// It keeps a copy of that allocator, that - unlike the one of the handler - stays valid
+// after the handler moved into the state. The intermediate handlers forward it as their allocator,
+// together with the handler's executor. The cancellation slot isn't forwarded if several of them are in flight,
+// the operation is connected to it as a whole instead.
+template<typename Signature>
+struct handler_state
+{
+    explicit handler_state(handler_type<Signature> && h)
+        : allocator(h.get_handler_allocator()), handler(std::move(h))
+    {
+    }
+
+    handler_allocator allocator;
+    handler_type<Signature> handler;
+};
+
+// Allocate the state with the allocator of the handler, which is passed to the constructor last.
+template<typename State, typename Signature, typename ... Args>
+State * new_handler_state(handler_type<Signature> && h, Args && ... args)
+{
+    const auto alloc = h.get_handler_allocator();
+    std::pmr::polymorphic_allocator<State> pa{alloc.resource()};
+    return pa.template new_object<State>(std::forward<Args>(args)..., std::move(h));
+}
+
+template<typename State>
+void delete_handler_state(State * st)
+{
+    // the state owns the allocator, so it needs a copy to deallocate itself.
+    const handler_allocator alloc{st->allocator};
+    std::pmr::polymorphic_allocator<State> pa{alloc.resource()};
+    pa.delete_object(st);
+}
+
+struct handler_state_deleter
+{
+    template<typename State>
+    void operator()(State * st) const
+    {
+        delete_handler_state(st);
+    }
+};
+
+template<typename State>
+using handler_state_ptr = std::unique_ptr<State, handler_state_deleter>;
+
+// Complete the handler with the values through its executor, e.g. when it must not be invoked from the initiation.
+template<typename ... Args, typename ... Values>
+void post_completion(handler_type<void(Args...)> && h, Values ... values)
+{
+    auto exec = h.get_executor();
+    asio::post(exec, [h = std::move(h), ... values = std::move(values)]() mutable {h(std::move(values)...);});
+}
+
+}
+
+#endif //PIO_DETAIL_HANDLER_STATE_HPP
@@ -0,0 +1,130 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_DETAIL_LEASED_READ_HPP
+#define PIO_DETAIL_LEASED_READ_HPP
+
+#include <pio/buffer_pool.hpp>
+#include <pio/handler.hpp>
+#include "handler_state.hpp"
+
+#include <asio/error.hpp>
+
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+#include <asio/posix/stream_descriptor.hpp>
+#include <memory>
+#endif
+
+namespace pio::detail
+{
+
+using leased_handler = handler_type<void(std::error_code, leased_buffer)>;
+
+// complete h with ec from a fresh handler, i.e. not from within the initiating function.
+void post_leased(leased_handler && h, std::error_code ec);
+
+// The state of a read into a leased block, allocated with the handler's allocator.
+// The intermediate handlers only hold a pointer to it, so they're stored inline in the handler_type
+// of the read, which a nested leased_handler would never fit into.
+struct leased_read_state : handler_state<void(std::error_code, leased_buffer)>
+{
+    leased_read_state(buffer_pool & pool, leased_buffer && buffer, leased_handler && h)
+        : handler_state(std::move(h)), pool(pool), buffer(std::move(buffer))
+    {
+    }
+
+    buffer_pool & pool;
+    leased_buffer buffer;
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+    // shared with the io object, so the op doesn't depend on where the io object lives.
+    std::shared_ptr<asio::posix::stream_descriptor> waiter;
+#endif
+};
+
+// Base of the intermediate handlers, forwarding the associated properties of the final one.
+struct leased_op_base
+{
+    leased_read_state * state;
+
+    using executor_type = asio::any_io_executor;
+    executor_type get_executor() const {return state->handler.get_executor();}
+
+    using allocator_type = std::pmr::polymorphic_allocator<void>;
+    allocator_type get_allocator() const {return state->allocator;}
+
+    using cancellation_slot_type = asio::cancellation_slot;
+    cancellation_slot_type get_cancellation_slot() const {return state->handler.get_cancellation_slot();}
+
+    void complete(std::error_code ec)
+    {
+        auto buffer = std::move(state->buffer);
+        // don't hold on to a block without data, e.g. at eof
+        if (buffer.empty())
+            buffer.release();
+        auto h = std::move(state->handler);
+        delete_handler_state(std::exchange(state, nullptr));
+        h(ec, std::move(buffer));
+    }
+};
+
+// reads into a block that was leased up front.
+struct leased_read_op : leased_op_base
+{
+    void operator()(std::error_code ec, std::size_t n)
+    {
+        state->buffer.commit(n);
+        complete(ec);
+    }
+};
+
+static_assert(handler_type<void(std::error_code, std::size_t)>::stores_inline<leased_read_op>);
+
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+
+// read without blocking, but also without setting O_NONBLOCK on the open file description,
+// which the duplicate shares with the descriptor of the io object.
+std::size_t read_nowait(int fd, const mutable_buffer & buffer, std::error_code & ec);
+
+// Waits for readiness on a duplicate of the descriptor and only then leases a block and reads without blocking.
+// A duplicate is used, because the asio pipe & serial port don't expose readiness waits.
+struct ready_read_op : leased_op_base
+{
+    void operator()(std::error_code ec)
+    {
+        if (ec)
+            return complete(ec);
+
+        auto & st = *state;
+        st.buffer = st.pool.try_acquire();
+        if (!st.buffer)
+            return complete(asio::error::no_buffer_space);
+
+        const auto n = read_nowait(st.waiter->native_handle(), st.buffer.prepare(), ec);
+        if (ec == asio::error::would_block || ec == asio::error::try_again)
+        {
+            // spurious wakeup, e.g. somebody else read the data. give the block back while waiting.
+            st.buffer.release();
+            return st.waiter->async_wait(asio::posix::descriptor_base::wait_read, std::move(*this));
+        }
+        st.buffer.commit(n);
+        complete(ec);
+    }
+};
+
+// start a ready_read_op, creating the waiting descriptor the first time.
+void async_ready_read(std::shared_ptr<asio::posix::stream_descriptor> & waiter,
+                      const asio::any_io_executor & exec, int fd,
+                      buffer_pool & pool, leased_handler && h);
+
+// close the waiting descriptor, which aborts the wait in flight, & drop the io object's reference.
+void reset_waiter(std::shared_ptr<asio::posix::stream_descriptor> & waiter);
+
+#endif
+
+}
+
+#endif //PIO_DETAIL_LEASED_READ_HPP
@@ -0,0 +1,86 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_DETAIL_MPSC_QUEUE_HPP
+#define PIO_DETAIL_MPSC_QUEUE_HPP
+
+#include <atomic>
+
+namespace pio::detail
+{
+
+// Base of the nodes of an mpsc_queue.
+struct mpsc_node
+{
+    std::atomic<mpsc_node*> next{nullptr};
+};
+
+// An intrusive, lock-free queue with many producers & a single consumer (after D. Vyukov).
+// push is wait-free. pop can return nullptr while a push is half done,
+// so the producer needs to notify the consumer after its push returned.
+template<typename Node>
+struct mpsc_queue
+{
+    mpsc_queue() = default;
+    mpsc_queue(const mpsc_queue &) = delete;
+    mpsc_queue& operator=(const mpsc_queue &) = delete;
+
+    // thread-safe
+    void push(Node * n) noexcept
+    {
+        push_(n);
+    }
+
+    // consumer only
+    Node * pop() noexcept
+    {
+        mpsc_node * tail = tail_;
+        mpsc_node * next = tail->next.load(std::memory_order_acquire);
+        if (tail == &stub_)
+        {
+            if (next == nullptr)
+                return nullptr;
+            tail_ = tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next != nullptr)
+        {
+            tail_ = next;
+            return static_cast<Node*>(tail);
+        }
+
+        // tail is the last node, unless a push is in progress
+        if (tail != head_.load(std::memory_order_acquire))
+            return nullptr;
+
+        push_(&stub_);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next != nullptr)
+        {
+            tail_ = next;
+            return static_cast<Node*>(tail);
+        }
+        return nullptr;
+    }
+
+  private:
+    void push_(mpsc_node * n) noexcept
+    {
+        n->next.store(nullptr, std::memory_order_relaxed);
+        mpsc_node * prev = head_.exchange(n, std::memory_order_acq_rel);
+        prev->next.store(n, std::memory_order_release);
+    }
+
+    mpsc_node stub_;
+    std::atomic<mpsc_node*> head_{&stub_};
+    mpsc_node * tail_ = &stub_;
+};
+
+}
+
+#endif //PIO_DETAIL_MPSC_QUEUE_HPP
@@ -0,0 +1,368 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef PIO_DETAIL_TRANSFER_OP_HPP
+#define PIO_DETAIL_TRANSFER_OP_HPP
+
+#include <pio/buffer.hpp>
+#include <pio/concepts.hpp>
+#include <pio/read.hpp>
+#include <pio/segmented_buffer.hpp>
+#include <pio/shared_buffer.hpp>
+
+#include <asio/completion_condition.hpp>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <memory_resource>
+#include <span>
+
+namespace pio::detail
+{
+
+using transfer_handler = handler_type<void(std::error_code, std::size_t)>;
+
+// The intermediate operations, i.e. the *_some functions of the concepts.
+struct read_some_op
+{
+    concepts::async_read_stream & stream;
+    void operator()(std::size_t, const mutable_buffer & buffer, transfer_handler && h)
+    {
+        stream.async_read_some_impl(buffer, std::move(h));
+    }
+    void operator()(std::size_t, std::span<const mutable_buffer> buffers, transfer_handler && h)
+    {
+        stream.async_read_some_impl(buffers, std::move(h));
+    }
+};
+
+struct write_some_op
+{
+    concepts::async_write_stream & stream;
+    void operator()(std::size_t, const const_buffer & buffer, transfer_handler && h)
+    {
+        stream.async_write_some_impl(buffer, std::move(h));
+    }
+    void operator()(std::size_t, std::span<const const_buffer> buffers, transfer_handler && h)
+    {
+        stream.async_write_some_impl(buffers, std::move(h));
+    }
+};
+
+struct read_some_at_op
+{
+    concepts::async_random_access_read_device & device;
+    std::uint64_t offset;
+    void operator()(std::size_t transferred, const mutable_buffer & buffer, transfer_handler && h)
+    {
+        device.async_read_some_at_impl(offset + transferred, buffer, std::move(h));
+    }
+    void operator()(std::size_t transferred, std::span<const mutable_buffer> buffers, transfer_handler && h)
+    {
+        device.async_read_some_at_impl(offset + transferred, buffers, std::move(h));
+    }
+};
+
+struct write_some_at_op
+{
+    concepts::async_random_access_write_device & device;
+    std::uint64_t offset;
+    void operator()(std::size_t transferred, const const_buffer & buffer, transfer_handler && h)
+    {
+        device.async_write_some_at_impl(offset + transferred, buffer, std::move(h));
+    }
+    void operator()(std::size_t transferred, std::span<const const_buffer> buffers, transfer_handler && h)
+    {
+        device.async_write_some_at_impl(offset + transferred, buffers, std::move(h));
+    }
+};
+
+// Transfer into or from a fixed buffer.
+template<typename Op, typename Buffer>
+struct buffer_step
+{
+    Op op;
+    Buffer buffer;
+
+    std::size_t limit(std::size_t max_size) const {return (std::min)(max_size, buffer.size());}
+    void initiate(std::size_t transferred, std::size_t max_size, transfer_handler && h)
+    {
+        op(transferred, asio::buffer(buffer, max_size), std::move(h));
+    }
+    void transferred(std::size_t n) {buffer += n;}
+    void finish(std::size_t) {}
+};
+
+// Transfer into or from a buffer sequence, using the vectored operations.
+template<typename Op, typename Buffer>
+struct buffer_sequence_step
+{
+    // same as asio's limit for one scatter/gather operation
+    constexpr static std::size_t max_buffers = 64u;
+
+    Op op;
+    std::span<const Buffer> buffers;
+    std::size_t remaining = asio::buffer_size(buffers);
+    std::size_t offset = 0u; // into buffers.front()
+    std::array<Buffer, max_buffers> prepared{};
+
+    std::size_t limit(std::size_t max_size) const {return (std::min)(max_size, remaining);}
+    void initiate(std::size_t transferred, std::size_t max_size, transfer_handler && h)
+    {
+        std::size_t count = 0u;
+        auto off = offset;
+        for (auto itr = buffers.begin(); itr != buffers.end() && count < max_buffers && max_size > 0u; itr++, off = 0u)
+        {
+            const auto b = asio::buffer(*itr + off, max_size);
+            if (b.size() == 0u)
+                continue;
+            prepared[count++] = b;
+            max_size -= b.size();
+        }
+        op(transferred, std::span<const Buffer>(prepared.data(), count), std::move(h));
+    }
+    void transferred(std::size_t n)
+    {
+        remaining -= n;
+        while (n > 0u && !buffers.empty())
+        {
+            const auto left = buffers.front().size() - offset;
+            if (n < left)
+            {
+                offset += n;
+                n = 0u;
+            }
+            else
+            {
+                n -= left;
+                offset = 0u;
+                buffers = buffers.subspan(1u);
+            }
+        }
+    }
+    void finish(std::size_t) {}
+};
+
+// Write the data of a dynamic buffer & consume what got written.
+template<typename Op, typename DynamicBuffer>
+struct write_dynamic_step : buffer_step<Op, const_buffer>
+{
+    DynamicBuffer buffers;
+    void finish(std::size_t n) {buffers.consume(n);}
+};
+
+// Read into a dynamic buffer with the v1 interface, i.e. prepare & commit.
+template<typename Op, typename DynamicBuffer>
+struct read_dynamic_v1_step
+{
+    Op op;
+    DynamicBuffer buffers;
+
+    std::size_t limit(std::size_t max_size) const
+    {
+        return (std::min)((std::max)(std::size_t(512u), buffers.capacity() - buffers.size()),
+                          (std::min)(max_size, buffers.max_size() - buffers.size()));
+    }
+    void initiate(std::size_t transferred, std::size_t max_size, transfer_handler && h)
+    {
+        op(transferred, buffers.prepare(max_size), std::move(h));
+    }
+    void transferred(std::size_t n) {buffers.commit(n);}
+    void finish(std::size_t) {}
+};
+
+// Read into a dynamic buffer with the v2 interface, i.e. grow & shrink.
+template<typename Op, typename DynamicBuffer>
+struct read_dynamic_v2_step
+{
+    Op op;
+    DynamicBuffer buffers;
+    std::size_t grown = 0u;
+
+    std::size_t limit(std::size_t max_size) const
+    {
+        return (std::min)((std::max)(std::size_t(512u), buffers.capacity() - buffers.size()),
+                          (std::min)(max_size, buffers.max_size() - buffers.size()));
+    }
+    void initiate(std::size_t transferred, std::size_t max_size, transfer_handler && h)
+    {
+        const auto pos = buffers.size();
+        buffers.grow(max_size);
+        grown = max_size;
+        op(transferred, buffers.data(pos, max_size), std::move(h));
+    }
+    void transferred(std::size_t n)
+    {
+        buffers.shrink(grown - n);
+        grown = 0u;
+    }
+    void finish(std::size_t) {}
+};
+
+// Write a shared buffer, the step holds a reference to the block until the operation completes.
+template<typename Op>
+struct shared_buffer_step
+{
+    Op op;
+    shared_buffer buffer;
+
+    std::size_t limit(std::size_t max_size) const {return (std::min)(max_size, buffer.size());}
+    void initiate(std::size_t transferred, std::size_t max_size, transfer_handler && h)
+    {
+        op(transferred, asio::buffer(const_buffer(buffer), max_size), std::move(h));
+    }
+    void transferred(std::size_t n) {buffer += n;}
+    void finish(std::size_t) {}
+};
+
+// Read into a segmented buffer, using the vectored operations.
+template<typename Op>
+struct read_segmented_step
+{
+    constexpr static std::size_t max_buffers = 64u;
+
+    Op op;
+    segmented_buffer & buffers;
+
+    std::size_t limit(std::size_t max_size) const
+    {
+        return (std::min)((std::max)(buffers.segment_size(), buffers.capacity() - buffers.size()),
+                          (std::min)(max_size, buffers.max_size() - buffers.size()));
+    }
+    void initiate(std::size_t transferred, std::size_t max_size, transfer_handler && h)
+    {
+        auto prepared = buffers.prepare(max_size);
+        op(transferred, prepared.first((std::min)(prepared.size(), max_buffers)), std::move(h));
+    }
+    void transferred(std::size_t n) {buffers.commit(n);}
+    void finish(std::size_t) {}
+};
+
+// Write the data of a segmented buffer, consuming the written segments as it goes.
+template<typename Op>
+struct write_segmented_step
+{
+    constexpr static std::size_t max_buffers = 64u;
+
+    Op op;
+    segmented_buffer & buffers;
+    std::array<const_buffer, max_buffers> prepared{};
+
+    std::size_t limit(std::size_t max_size) const {return (std::min)(max_size, buffers.size());}
+    void initiate(std::size_t transferred, std::size_t max_size, transfer_handler && h)
+    {
+        std::size_t count = 0u;
+        for (const auto & b : buffers.data())
+        {
+            if (count == max_buffers || max_size == 0u)
+                break;
+            prepared[count] = asio::buffer(b, max_size);
+            max_size -= prepared[count++].size();
+        }
+        op(transferred, std::span<const const_buffer>(prepared.data(), count), std::move(h));
+    }
+    void transferred(std::size_t n) {buffers.consume(n);}
+    void finish(std::size_t) {}
+};
+
+// A composed read or write, that allocates its state once and reuses it for every intermediate operation.
+/*
+ * The intermediate handler only holds a pointer to the state, so the handler_type passed
+ * to the *_some_impl functions stores it inline and the handler never gets erased again.
+ */
+template<typename Step>
+struct transfer_op
+{
+    Step step;
+    completion_condition_t completion_condition;
+    transfer_handler handler;
+    asio::any_io_executor executor;
+    std::size_t total_transferred = 0u;
+
+    struct next_handler
+    {
+        transfer_op * op;
+
+        using allocator_type = std::pmr::polymorphic_allocator<void>;
+        allocator_type get_allocator() const {return op->handler.get_allocator();}
+
+        using cancellation_slot_type = asio::cancellation_slot;
+        cancellation_slot_type get_cancellation_slot() const {return op->handler.get_cancellation_slot();}
+
+        void operator()(std::error_code ec, std::size_t n)
+        {
+            op->resume(ec, n);
+        }
+    };
+
+    transfer_op(Step && step, completion_condition_t && completion_condition, transfer_handler && h)
+        : step(std::move(step)), completion_condition(std::move(completion_condition)),
+          handler(std::move(h)), executor(handler.get_executor())
+    {
+    }
+
+    void initiate(std::size_t max_size)
+    {
+        step.initiate(total_transferred, max_size, transfer_handler(next_handler{this}, executor));
+    }
+
+    void resume(std::error_code ec, std::size_t n)
+    {
+        total_transferred += n;
+        step.transferred(n);
+
+        std::size_t max_size = 0u;
+        if (ec || n > 0u)
+            max_size = step.limit(completion_condition(ec, total_transferred));
+
+        if (max_size > 0u)
+            initiate(max_size);
+        else
+            complete(ec);
+    }
+
+    void complete(std::error_code ec)
+    {
+        step.finish(total_transferred);
+        auto h = std::move(handler);
+        const auto n = total_transferred;
+        destroy(h.get_allocator());
+        std::move(h)(ec, n);
+    }
+
+    void destroy(std::pmr::polymorphic_allocator<transfer_op> alloc)
+    {
+        std::destroy_at(this);
+        alloc.deallocate(this, 1u);
+    }
+};
+
+// Start a composed operation. Like asio, the first intermediate operation is always initiated,
+// even if the completion condition is already fulfilled, so the handler never gets invoked from within.
+template<typename Step>
+void start_transfer(Step step, completion_condition_t completion_condition, transfer_handler && h)
+{
+    using op_t = transfer_op<Step>;
+    std::pmr::polymorphic_allocator<op_t> alloc{h.get_allocator()};
+    auto op = new (alloc.allocate(1u)) op_t(std::move(step), std::move(completion_condition), std::move(h));
+    try
+    {
+        op->initiate(op->step.limit(op->completion_condition(std::error_code{}, 0u)));
+    }
+    catch (...)
+    {
+        // the allocator might refer to the handler, so it needs to outlive the op.
+        auto h_ = std::move(op->handler);
+        op->destroy(h_.get_allocator());
+        throw;
+    }
+}
+
+}
+
+#endif //PIO_DETAIL_TRANSFER_OP_HPP
@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/direct_io.hpp>
+
+#include <asio/error.hpp>
+
+#include <cerrno>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#endif
+
+namespace pio
+{
+
+template<typename Buffer>
+static bool check_all(const io_alignment & al, std::uint64_t position, std::span<const Buffer> buffers)
+{
+    for (const auto & b : buffers)
+    {
+        if (!al.check(position, b.data(), b.size()))
+            return false;
+        position += b.size();
+    }
+    return true;
+}
+
+bool io_alignment::check(std::uint64_t position, std::span<const const_buffer> buffers) const noexcept
+{
+    return check_all(*this, position, buffers);
+}
+
+bool io_alignment::check(std::uint64_t position, std::span<const mutable_buffer> buffers) const noexcept
+{
+    return check_all(*this, position, buffers);
+}
+
+constexpr static std::size_t default_direct_io_alignment = 4096u;
+
+io_alignment query_direct_io_alignment(int fd, std::error_code & ec)
+{
+    ec.clear();
+#if defined(__linux__)
+#if defined(STATX_DIOALIGN)
+    struct statx stx;
+    if (::statx(fd, "", AT_EMPTY_PATH, STATX_DIOALIGN, &stx) == 0
+        && (stx.stx_mask & STATX_DIOALIGN) && stx.stx_dio_offset_align != 0u)
+        return io_alignment{stx.stx_dio_mem_align, stx.stx_dio_offset_align};
+#endif
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        ec.assign(errno, std::system_category());
+        return {};
+    }
+
+    int sector_size = 0;
+    if (S_ISBLK(st.st_mode) && ::ioctl(fd, BLKSSZGET, &sector_size) == 0 && sector_size > 0)
+        return io_alignment{static_cast<std::size_t>(sector_size), static_cast<std::size_t>(sector_size)};
+
+    return io_alignment{default_direct_io_alignment, default_direct_io_alignment};
+#else
+    ec = asio::error::operation_not_supported;
+    return {};
+#endif
+}
+
+}
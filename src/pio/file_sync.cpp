@@ -0,0 +1,135 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/random_access_file.hpp>
+#include <pio/stream_file.hpp>
+#include "detail/blocking_pool.hpp"
+#include "detail/handler_state.hpp"
+
+#include <asio/error.hpp>
+
+#if defined(ASIO_WINDOWS)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace pio
+{
+
+namespace detail
+{
+
+namespace
+{
+
+enum class sync_kind
+{
+    all,
+    data,
+    range
+};
+
+using native_file_t = asio::random_access_file::native_handle_type;
+static_assert(std::is_same_v<native_file_t, asio::stream_file::native_handle_type>);
+
+std::error_code do_sync(native_file_t fd, sync_kind kind, std::uint64_t offset, std::uint64_t length)
+{
+#if defined(ASIO_WINDOWS)
+    // there's no data-only or ranged flush.
+    if (!::FlushFileBuffers(fd))
+        return std::error_code(static_cast<int>(::GetLastError()), asio::error::get_system_category());
+    return {};
+#else
+    int res;
+    do
+    {
+        switch (kind)
+        {
+#if defined(__linux__)
+            case sync_kind::range:
+                res = ::sync_file_range(fd, static_cast<off64_t>(offset), static_cast<off64_t>(length),
+                                        SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+                break;
+#else
+            case sync_kind::range:
+                [[fallthrough]];
+#endif
+#if defined(__APPLE__)
+            // no fdatasync, and fsync doesn't flush the drive cache.
+            case sync_kind::data:
+            case sync_kind::all:
+                res = ::fcntl(fd, F_FULLFSYNC);
+                break;
+#else
+            case sync_kind::data:
+                res = ::fdatasync(fd);
+                break;
+            case sync_kind::all:
+                res = ::fsync(fd);
+                break;
+#endif
+        }
+    }
+    while (res == -1 && errno == EINTR);
+
+    if (res == -1)
+        return std::error_code(errno, asio::error::get_system_category());
+    return {};
+#endif
+}
+
+void async_sync(bool is_open, native_file_t fd, sync_kind kind, std::uint64_t offset, std::uint64_t length,
+                handler_type<void(std::error_code)> && h)
+{
+    if (!is_open)
+        return post_completion(std::move(h), asio::error::bad_descriptor);
+
+    run_blocking(std::move(h),
+                 [=]
+                 {
+                     return std::make_tuple(do_sync(fd, kind, offset, length));
+                 });
+}
+
+}
+
+}
+
+void stream_file::async_sync_impl(handler_type<void(std::error_code)> && h)
+{
+    detail::async_sync(impl_.is_open(), impl_.native_handle(), detail::sync_kind::all, 0u, 0u, std::move(h));
+}
+
+void stream_file::async_data_sync_impl(handler_type<void(std::error_code)> && h)
+{
+    detail::async_sync(impl_.is_open(), impl_.native_handle(), detail::sync_kind::data, 0u, 0u, std::move(h));
+}
+
+void stream_file::async_sync_range_impl(std::uint64_t offset, std::uint64_t length, handler_type<void(std::error_code)> && h)
+{
+    detail::async_sync(impl_.is_open(), impl_.native_handle(), detail::sync_kind::range, offset, length, std::move(h));
+}
+
+void random_access_file::async_sync_impl(handler_type<void(std::error_code)> && h)
+{
+    detail::async_sync(impl_.is_open(), impl_.native_handle(), detail::sync_kind::all, 0u, 0u, std::move(h));
+}
+
+void random_access_file::async_data_sync_impl(handler_type<void(std::error_code)> && h)
+{
+    detail::async_sync(impl_.is_open(), impl_.native_handle(), detail::sync_kind::data, 0u, 0u, std::move(h));
+}
+
+void random_access_file::async_sync_range_impl(std::uint64_t offset, std::uint64_t length, handler_type<void(std::error_code)> && h)
+{
+    detail::async_sync(impl_.is_open(), impl_.native_handle(), detail::sync_kind::range, offset, length, std::move(h));
+}
+
+}
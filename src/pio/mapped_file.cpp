@@ -0,0 +1,341 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/mapped_file.hpp>
+
+#if !defined(ASIO_WINDOWS)
+
+#include <asio/detail/throw_error.hpp>
+#include <asio/error.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pio
+{
+
+static std::error_code last_error()
+{
+    return std::error_code(errno, std::system_category());
+}
+
+mapped_file::mapped_file(const executor_type& ex) : executor_(ex) {}
+
+mapped_file::mapped_file(const executor_type& ex, const char* path) : executor_(ex)
+{
+    open(path);
+}
+
+mapped_file::mapped_file(const executor_type& ex, const std::string& path) : executor_(ex)
+{
+    open(path);
+}
+
+mapped_file::mapped_file(const executor_type& ex, const native_handle_type& native_file) : executor_(ex)
+{
+    assign(native_file);
+}
+
+mapped_file::mapped_file(mapped_file&& other) noexcept
+    : executor_(other.executor_),
+      fd_(std::exchange(other.fd_, -1)),
+      data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0u))
+{
+}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept
+{
+    if (this != &other)
+    {
+        asio::error_code ec;
+        close(ec);
+        executor_ = other.executor_;
+        fd_   = std::exchange(other.fd_, -1);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0u);
+    }
+    return *this;
+}
+
+mapped_file::~mapped_file()
+{
+    asio::error_code ec;
+    close(ec);
+}
+
+void mapped_file::open(const char* path)
+{
+    asio::error_code ec;
+    open(path, ec);
+    asio::detail::throw_error(ec, "open");
+}
+
+ASIO_SYNC_OP_VOID mapped_file::open(const char* path, asio::error_code& ec)
+{
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        ec = last_error();
+        ASIO_SYNC_OP_VOID_RETURN(ec);
+    }
+    assign(fd, ec);
+    if (ec)
+        ::close(fd);
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+}
+
+void mapped_file::open(const std::string& path)
+{
+    open(path.c_str());
+}
+
+ASIO_SYNC_OP_VOID mapped_file::open(const std::string& path, asio::error_code& ec)
+{
+    return open(path.c_str(), ec);
+}
+
+void mapped_file::assign(const native_handle_type& native_file)
+{
+    asio::error_code ec;
+    assign(native_file, ec);
+    asio::detail::throw_error(ec, "assign");
+}
+
+ASIO_SYNC_OP_VOID mapped_file::assign(const native_handle_type& native_file, asio::error_code& ec)
+{
+    if (is_open())
+    {
+        ec = asio::error::already_open;
+        ASIO_SYNC_OP_VOID_RETURN(ec);
+    }
+    fd_ = native_file;
+    remap(ec);
+    if (ec)
+    {
+        // don't take ownership if it can't be mapped
+        unmap_();
+        fd_ = -1;
+    }
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+}
+
+std::size_t mapped_file::read_some_at(std::uint64_t offset, const mutable_buffer & buffer)
+{
+    asio::error_code ec;
+    auto n = read_some_at(offset, buffer, ec);
+    asio::detail::throw_error(ec, "read_some_at");
+    return n;
+}
+
+std::size_t mapped_file::read_some_at(std::uint64_t offset, const mutable_buffer & buffer, asio::error_code& ec)
+{
+    return read_some_at(offset, std::span<const mutable_buffer>(&buffer, 1u), ec);
+}
+
+std::size_t mapped_file::read_some_at(std::uint64_t offset, std::span<const mutable_buffer> buffers)
+{
+    asio::error_code ec;
+    auto n = read_some_at(offset, buffers, ec);
+    asio::detail::throw_error(ec, "read_some_at");
+    return n;
+}
+
+// like pread, reads at the end report eof unless nothing was requested.
+std::size_t mapped_file::read_some_at(std::uint64_t offset, std::span<const mutable_buffer> buffers, asio::error_code& ec)
+{
+    ec.clear();
+    if (!is_open())
+    {
+        ec = asio::error::bad_descriptor;
+        return 0u;
+    }
+
+    std::size_t total = 0u;
+    for (const auto & b : buffers)
+    {
+        const auto src = view(offset + total, b.size());
+        std::memcpy(b.data(), src.data(), src.size());
+        total += src.size();
+        if (src.size() < b.size())
+            break;
+    }
+
+    if (total == 0u && asio::buffer_size(buffers) > 0u)
+        ec = asio::error::eof;
+    return total;
+}
+
+const_buffer mapped_file::view(std::uint64_t offset, std::size_t n) const noexcept
+{
+    if (offset >= size_)
+        return const_buffer();
+    return const_buffer(data_ + offset, static_cast<std::size_t>(std::min<std::uint64_t>(n, size_ - offset)));
+}
+
+static int advice_flag(mapped_file::advice a)
+{
+    switch (a)
+    {
+        case mapped_file::advice::sequential: return MADV_SEQUENTIAL;
+        case mapped_file::advice::random:     return MADV_RANDOM;
+        case mapped_file::advice::willneed:   return MADV_WILLNEED;
+        case mapped_file::advice::dontneed:   return MADV_DONTNEED;
+        default:                              return MADV_NORMAL;
+    }
+}
+
+void mapped_file::advise(advice a)
+{
+    advise(a, 0u, size_);
+}
+
+ASIO_SYNC_OP_VOID mapped_file::advise(advice a, asio::error_code& ec)
+{
+    return advise(a, 0u, size_, ec);
+}
+
+void mapped_file::advise(advice a, std::uint64_t offset, std::uint64_t length)
+{
+    asio::error_code ec;
+    advise(a, offset, length, ec);
+    asio::detail::throw_error(ec, "advise");
+}
+
+ASIO_SYNC_OP_VOID mapped_file::advise(advice a, std::uint64_t offset, std::uint64_t length, asio::error_code& ec)
+{
+    ec.clear();
+    if (offset >= size_)
+        ASIO_SYNC_OP_VOID_RETURN(ec);
+
+    // madvise needs a page aligned address
+    const auto page = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+    const auto begin = offset / page * page;
+    const auto end = std::min(size_, offset + length);
+    if (::madvise(data_ + begin, static_cast<std::size_t>(end - begin), advice_flag(a)) != 0)
+        ec = last_error();
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+}
+
+std::uint64_t mapped_file::remap()
+{
+    asio::error_code ec;
+    auto n = remap(ec);
+    asio::detail::throw_error(ec, "remap");
+    return n;
+}
+
+std::uint64_t mapped_file::remap(asio::error_code& ec)
+{
+    ec.clear();
+    if (!is_open())
+    {
+        ec = asio::error::bad_descriptor;
+        return 0u;
+    }
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0)
+    {
+        ec = last_error();
+        return size_;
+    }
+
+    const auto new_size = static_cast<std::uint64_t>(st.st_size);
+    if (new_size == size_)
+        return size_;
+
+    // an empty file can't be mapped
+    if (new_size == 0u)
+    {
+        unmap_();
+        return 0u;
+    }
+
+    void * p;
+#if defined(__linux__)
+    if (data_)
+        p = ::mremap(data_, static_cast<std::size_t>(size_), static_cast<std::size_t>(new_size), MREMAP_MAYMOVE);
+    else
+#endif
+        p = ::mmap(nullptr, static_cast<std::size_t>(new_size), PROT_READ, MAP_SHARED, fd_, 0);
+
+    if (p == MAP_FAILED)
+    {
+        ec = last_error();
+        return size_;
+    }
+
+#if !defined(__linux__)
+    unmap_();
+#endif
+    data_ = static_cast<unsigned char*>(p);
+    size_ = new_size;
+    return size_;
+}
+
+void mapped_file::unmap_() noexcept
+{
+    if (data_)
+        ::munmap(data_, static_cast<std::size_t>(size_));
+    data_ = nullptr;
+    size_ = 0u;
+}
+
+auto mapped_file::get_executor() -> executor_type {return executor_;}
+
+bool mapped_file::is_open() const {return fd_ >= 0;}
+
+void mapped_file::close()
+{
+    asio::error_code ec;
+    close(ec);
+    asio::detail::throw_error(ec, "close");
+}
+
+ASIO_SYNC_OP_VOID mapped_file::close(asio::error_code& ec)
+{
+    ec.clear();
+    unmap_();
+    if (is_open() && ::close(std::exchange(fd_, -1)) != 0)
+        ec = last_error();
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+}
+
+auto mapped_file::native_handle() -> native_handle_type {return fd_;}
+
+auto mapped_file::release() -> native_handle_type
+{
+    unmap_();
+    return std::exchange(fd_, -1);
+}
+
+// the data is copied right away, only the completion is posted.
+void mapped_file::async_read_some_at_impl(std::uint64_t offset, mutable_buffer buffer, handler_type<void(std::error_code, std::size_t)> && h)
+{
+    asio::error_code ec;
+    const auto n = read_some_at(offset, buffer, ec);
+    detail::post_completion(std::move(h), ec, n);
+}
+
+void mapped_file::async_read_some_at_impl(std::uint64_t offset, std::span<const mutable_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h)
+{
+    asio::error_code ec;
+    const auto n = read_some_at(offset, buffers, ec);
+    detail::post_completion(std::move(h), ec, n);
+}
+
+}
+
+#endif
@@ -0,0 +1,169 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/open_file.hpp>
+#include "detail/blocking_pool.hpp"
+#include "detail/handler_state.hpp"
+
+#if !defined(ASIO_WINDOWS)
+
+#include <asio/error.hpp>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace pio::detail
+{
+
+namespace
+{
+
+std::error_code last_error()
+{
+    return std::error_code(errno, asio::error::get_system_category());
+}
+
+// the result of an open on the pool, turned into a file on the executor.
+struct opened
+{
+    int fd;
+    std::error_code ec;
+};
+
+opened do_open(const std::string & path, asio::file_base::flags open_flags, bool direct)
+{
+    // asio's flags are the posix open flags
+    int flags = static_cast<int>(open_flags) | O_CLOEXEC;
+    if (direct)
+    {
+#if defined(O_DIRECT)
+        flags |= O_DIRECT;
+#else
+        return {-1, asio::error::operation_not_supported};
+#endif
+    }
+
+    int fd;
+    do
+        fd = ::open(path.c_str(), flags, 0777);
+    while (fd == -1 && errno == EINTR);
+
+    if (fd == -1)
+        return {-1, last_error()};
+    return {fd, {}};
+}
+
+template<typename File>
+void finish_open(const asio::any_io_executor & ex, opened res, handler_type<void(std::error_code, File)> && h)
+{
+    File f{ex};
+    if (!res.ec)
+    {
+        f.assign(res.fd, res.ec);
+        if (res.ec)
+            ::close(res.fd);
+    }
+    std::move(h)(res.ec, std::move(f));
+}
+
+file_status to_status(const struct ::stat & st)
+{
+    namespace fs = std::filesystem;
+    file_status res;
+    switch (st.st_mode & S_IFMT)
+    {
+        case S_IFREG:  res.type = fs::file_type::regular;   break;
+        case S_IFDIR:  res.type = fs::file_type::directory; break;
+        case S_IFLNK:  res.type = fs::file_type::symlink;   break;
+        case S_IFBLK:  res.type = fs::file_type::block;     break;
+        case S_IFCHR:  res.type = fs::file_type::character; break;
+        case S_IFIFO:  res.type = fs::file_type::fifo;      break;
+        case S_IFSOCK: res.type = fs::file_type::socket;    break;
+        default:       res.type = fs::file_type::unknown;   break;
+    }
+    res.permissions = static_cast<fs::perms>(st.st_mode & 07777);
+    res.size = static_cast<std::uint64_t>(st.st_size);
+    res.allocated = static_cast<std::uint64_t>(st.st_blocks) * 512u;
+    res.block_size = static_cast<std::size_t>(st.st_blksize);
+
+#if defined(__APPLE__)
+    const auto & mtime = st.st_mtimespec;
+#else
+    const auto & mtime = st.st_mtim;
+#endif
+    res.last_write_time = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    std::chrono::seconds(mtime.tv_sec) + std::chrono::nanoseconds(mtime.tv_nsec)));
+    return res;
+}
+
+}
+
+void async_open_stream_file_impl(const asio::any_io_executor & ex, std::string && path, asio::file_base::flags open_flags,
+                                 handler_type<void(std::error_code, stream_file)> && h)
+{
+    auto exec = h.get_executor();
+    run_blocking(exec,
+                 [path = std::move(path), open_flags] {return do_open(path, open_flags, false);},
+                 [ex, h = std::move(h)](opened res) mutable {finish_open(ex, res, std::move(h));});
+}
+
+void async_open_random_access_file_impl(const asio::any_io_executor & ex, std::string && path, asio::file_base::flags open_flags,
+                                        bool direct, handler_type<void(std::error_code, random_access_file)> && h)
+{
+    auto exec = h.get_executor();
+    run_blocking(exec,
+                 [path = std::move(path), open_flags, direct] {return do_open(path, open_flags, direct);},
+                 [ex, h = std::move(h)](opened res) mutable {finish_open(ex, res, std::move(h));});
+}
+
+void async_stat_impl(std::string && path, handler_type<void(std::error_code, file_status)> && h)
+{
+    run_blocking(std::move(h),
+                 [path = std::move(path)]
+                 {
+                     struct ::stat st;
+                     if (::stat(path.c_str(), &st) == -1)
+                         return std::make_tuple(last_error(), file_status{});
+                     return std::make_tuple(std::error_code{}, to_status(st));
+                 });
+}
+
+void async_stat_impl(int fd, handler_type<void(std::error_code, file_status)> && h)
+{
+    run_blocking(std::move(h),
+                 [fd]
+                 {
+                     struct ::stat st;
+                     if (::fstat(fd, &st) == -1)
+                         return std::make_tuple(last_error(), file_status{});
+                     return std::make_tuple(std::error_code{}, to_status(st));
+                 });
+}
+
+void async_close_impl(int fd, std::error_code ec, handler_type<void(std::error_code)> && h)
+{
+    if (!ec && fd == -1)
+        ec = asio::error::bad_descriptor;
+    if (ec)
+        return post_completion(std::move(h), ec);
+
+    run_blocking(std::move(h),
+                 [fd]
+                 {
+                     // the descriptor is gone even if close fails, so EINTR must not be retried.
+                     if (::close(fd) == -1 && errno != EINTR)
+                         return std::make_tuple(last_error());
+                     return std::make_tuple(std::error_code{});
+                 });
+}
+
+}
+
+#endif
@@ -0,0 +1,179 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/parallel_transfer.hpp>
+#include <pio/read_at.hpp>
+#include <pio/write_at.hpp>
+#include "detail/handler_state.hpp"
+
+#include <asio/error.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory_resource>
+#include <mutex>
+
+namespace pio
+{
+
+namespace detail
+{
+
+namespace
+{
+
+using transfer_handler = handler_type<void(std::error_code, std::size_t)>;
+
+template<typename Device, typename Buffer>
+struct parallel_state : handler_state<void(std::error_code, std::size_t)>
+{
+    parallel_state(Device & device, std::uint64_t offset, Buffer buffer,
+                   parallel_transfer_options options, transfer_handler && h)
+        : handler_state(std::move(h)), device(device), offset(offset), buffer(buffer), options(options)
+    {
+    }
+
+    Device & device;
+    const std::uint64_t offset;
+    const Buffer buffer;
+    const parallel_transfer_options options;
+    std::atomic<bool> cancelled{false};
+
+    // guards everything below while chunks are in flight.
+    std::mutex mutex;
+    std::size_t claimed = 0u;
+    std::size_t active = 0u;
+    // the start of the first chunk that wasn't transferred completely & its error.
+    std::size_t gap = std::numeric_limits<std::size_t>::max();
+    std::error_code error;
+};
+
+template<typename Device, typename Buffer>
+void complete(parallel_state<Device, Buffer> * st)
+{
+    auto slot = st->handler.get_cancellation_slot();
+    if (slot.is_connected())
+        slot.clear();
+
+    std::error_code ec = st->error;
+    std::size_t n = std::min(st->gap, st->buffer.size());
+    if (!ec && st->cancelled && st->claimed < st->buffer.size())
+    {
+        ec = asio::error::operation_aborted;
+        n = st->claimed;
+    }
+
+    auto h = std::move(st->handler);
+    delete_handler_state(st);
+    h(ec, n);
+}
+
+void start_transfer(parallel_state<concepts::async_random_access_read_device, mutable_buffer> & st,
+                           std::size_t position, std::size_t size, auto && op)
+{
+    pio::async_read_at(st.device, st.offset + position, asio::buffer(st.buffer + position, size), std::move(op));
+}
+
+void start_transfer(parallel_state<concepts::async_random_access_write_device, const_buffer> & st,
+                           std::size_t position, std::size_t size, auto && op)
+{
+    pio::async_write_at(st.device, st.offset + position, asio::buffer(st.buffer + position, size), std::move(op));
+}
+
+template<typename Device, typename Buffer>
+void start_chunk(parallel_state<Device, Buffer> & st);
+
+// one chunk in flight.
+template<typename Device, typename Buffer>
+struct chunk_op
+{
+    parallel_state<Device, Buffer> * st;
+    std::size_t position;
+    std::size_t size;
+
+    using executor_type = asio::any_io_executor;
+    executor_type get_executor() const {return st->handler.get_executor();}
+
+    using allocator_type = std::pmr::polymorphic_allocator<void>;
+    allocator_type get_allocator() const {return st->allocator;}
+
+    void operator()(std::error_code ec, std::size_t n)
+    {
+        bool done;
+        {
+            std::lock_guard<std::mutex> lock{st->mutex};
+            st->active--;
+            if ((ec || n < size) && position + n < st->gap)
+            {
+                st->gap = position + n;
+                st->error = ec ? ec : std::error_code(asio::error::eof);
+            }
+
+            if (!st->error && !st->cancelled && st->claimed < st->buffer.size())
+                start_chunk(*st);
+            done = st->active == 0u;
+        }
+
+        if (done)
+            complete(st);
+    }
+};
+
+// needs to be called with the lock held.
+template<typename Device, typename Buffer>
+void start_chunk(parallel_state<Device, Buffer> & st)
+{
+    const auto position = st.claimed;
+    const auto size = std::min(st.options.chunk_size, st.buffer.size() - position);
+    st.claimed += size;
+    st.active++;
+    start_transfer(st, position, size, chunk_op<Device, Buffer>{&st, position, size});
+}
+
+template<typename Device, typename Buffer>
+void async_parallel_transfer(Device & d, std::uint64_t offset, Buffer buffer,
+                             parallel_transfer_options options, transfer_handler && h)
+{
+    if (buffer.size() == 0u)
+        return post_completion(std::move(h), std::error_code{}, std::size_t(0u));
+
+    options.chunk_size = std::max<std::size_t>(options.chunk_size, 1u);
+    options.depth      = std::max<std::size_t>(options.depth, 1u);
+
+    using state = parallel_state<Device, Buffer>;
+    auto st = new_handler_state<state>(std::move(h), d, offset, buffer, options);
+
+    auto slot = st->handler.get_cancellation_slot();
+    if (slot.is_connected())
+        slot.assign([st](asio::cancellation_type) {st->cancelled = true;});
+
+    // chunks can complete on other threads while the rest is started.
+    std::lock_guard<std::mutex> lock{st->mutex};
+    for (std::size_t i = 0u; i < options.depth && st->claimed < buffer.size(); i++)
+        start_chunk(*st);
+}
+
+}
+
+void async_parallel_read_at_impl(concepts::async_random_access_read_device & d, std::uint64_t offset,
+                                 mutable_buffer buffer, parallel_transfer_options options,
+                                 handler_type<void(std::error_code, std::size_t)> && h)
+{
+    async_parallel_transfer(d, offset, buffer, options, std::move(h));
+}
+
+void async_parallel_write_at_impl(concepts::async_random_access_write_device & d, std::uint64_t offset,
+                                  const_buffer buffer, parallel_transfer_options options,
+                                  handler_type<void(std::error_code, std::size_t)> && h)
+{
+    async_parallel_transfer(d, offset, buffer, options, std::move(h));
+}
+
+}
+
+}
@@ -0,0 +1,332 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/prefetching_read_stream.hpp>
+#include "detail/handler_state.hpp"
+
+#include <asio/error.hpp>
+#include <asio/post.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace pio
+{
+
+namespace detail
+{
+
+using read_handler_t = handler_type<void(std::error_code, std::size_t)>;
+
+namespace
+{
+
+struct prefetch_block
+{
+    enum status_t {idle, fetching, ready};
+
+    std::unique_ptr<unsigned char[]> data;
+    std::uint64_t offset = 0u;
+    std::size_t size = 0u, consumed = 0u;
+    std::error_code ec;
+    status_t status = idle;
+};
+
+}
+
+// The state is on the heap, so that prefetches can outlive the stream.
+struct prefetch_state
+{
+    using options = prefetching_read_stream::options;
+
+    prefetch_state(concepts::async_random_access_read_device & device, std::uint64_t offset, options opts)
+        : device(device), opts(opts), ring(opts.max_depth), depth(opts.min_depth),
+          fetch_offset(offset), position(offset)
+    {
+    }
+
+    concepts::async_random_access_read_device & device;
+    options opts;
+
+    // the blocks in use are [head, head + fetched) modulo the ring size.
+    std::vector<prefetch_block> ring;
+    std::size_t head = 0u, fetched = 0u, ready = 0u, in_flight = 0u, depth;
+    std::uint64_t fetch_offset, position;
+    // a fetch hit the end of the device or failed, so there's nothing more to fetch.
+    bool stopped = false;
+    // the first read always waits, it doesn't count as a stall.
+    bool started = false;
+    // the stream was destroyed, the last prefetch deletes the state.
+    bool orphaned = false;
+
+    std::optional<read_handler_t> pending;
+    mutable_buffer single;
+    std::span<const mutable_buffer> buffers;
+};
+
+namespace
+{
+
+using state = prefetch_state;
+
+void fetch(state & st, std::size_t idx);
+
+struct fetch_op
+{
+    state * st;
+    std::size_t idx;
+
+    void operator()(std::error_code ec, std::size_t n);
+};
+
+void fetch(state & st, std::size_t idx)
+{
+    auto & blk = st.ring[idx];
+    st.in_flight++;
+    st.device.async_read_some_at(blk.offset + blk.size,
+                                 asio::buffer(blk.data.get() + blk.size, st.opts.block_size - blk.size),
+                                 fetch_op{&st, idx});
+}
+
+// start fetching blocks until the window is full.
+void refill(state & st)
+{
+    while (!st.stopped && st.fetched < st.depth)
+    {
+        auto & blk = st.ring[(st.head + st.fetched) % st.ring.size()];
+        if (!blk.data)
+            blk.data = std::make_unique_for_overwrite<unsigned char[]>(st.opts.block_size);
+        blk.offset = st.fetch_offset;
+        blk.size = blk.consumed = 0u;
+        blk.ec.clear();
+        blk.status = prefetch_block::fetching;
+
+        st.fetch_offset += st.opts.block_size;
+        st.fetched++;
+        fetch(st, (st.head + st.fetched - 1u) % st.ring.size());
+    }
+}
+
+// copy the data of the ready blocks at the head into the buffers.
+std::size_t consume(state & st, std::error_code & ec)
+{
+    std::size_t total = 0u, in_buffer = 0u;
+    auto itr = st.buffers.begin();
+    while (st.fetched > 0u)
+    {
+        auto & blk = st.ring[st.head];
+        if (blk.status != prefetch_block::ready)
+            break;
+
+        if (blk.consumed == blk.size)
+        {
+            // keep the failed block, so every further read reports the error.
+            if (blk.ec)
+            {
+                if (total == 0u)
+                    ec = blk.ec;
+                break;
+            }
+
+            blk.status = prefetch_block::idle;
+            st.head = (st.head + 1u) % st.ring.size();
+            st.fetched--;
+            st.ready--;
+            // the device is ahead of the consumer, a smaller window will do.
+            if (st.ready == st.fetched && st.fetched + 1u >= st.depth && st.depth > st.opts.min_depth)
+                st.depth--;
+            continue;
+        }
+
+        while (itr != st.buffers.end() && in_buffer == itr->size())
+        {
+            ++itr;
+            in_buffer = 0u;
+        }
+        if (itr == st.buffers.end())
+            break;
+
+        const auto n = std::min(blk.size - blk.consumed, itr->size() - in_buffer);
+        std::memcpy(static_cast<unsigned char*>(itr->data()) + in_buffer, blk.data.get() + blk.consumed, n);
+        blk.consumed += n;
+        in_buffer += n;
+        total += n;
+        st.position += n;
+    }
+    return total;
+}
+
+// the cancellation handler can't clear its own slot, that would destroy it while it runs,
+// so it leaves that to the posted completion.
+void complete_pending(state & st, std::error_code ec, std::size_t n, bool from_slot = false)
+{
+    auto h = std::move(*st.pending);
+    st.pending.reset();
+
+    if (!from_slot)
+    {
+        auto slot = h.get_cancellation_slot();
+        if (slot.is_connected())
+            slot.clear();
+        return post_completion(std::move(h), ec, n);
+    }
+
+    auto exec = h.get_executor();
+    asio::post(exec,
+               [h = std::move(h), ec, n]() mutable
+               {
+                   auto slot = h.get_cancellation_slot();
+                   if (slot.is_connected())
+                       slot.clear();
+                   h(ec, n);
+               });
+}
+
+void fetch_op::operator()(std::error_code ec, std::size_t n)
+{
+    st->in_flight--;
+    if (st->orphaned)
+    {
+        if (st->in_flight == 0u)
+            delete st;
+        return;
+    }
+
+    auto & blk = st->ring[idx];
+    blk.size += n;
+    if (!ec && n > 0u && blk.size < st->opts.block_size)
+        return fetch(*st, idx); // short read, get the rest of the block first
+
+    if (!ec && blk.size < st->opts.block_size)
+        ec = asio::error::eof;
+    blk.ec = ec;
+    blk.status = prefetch_block::ready;
+    st->ready++;
+    if (ec)
+        st->stopped = true;
+
+    if (st->pending && idx == st->head)
+    {
+        std::error_code rec;
+        const auto rn = consume(*st, rec);
+        refill(*st);
+        complete_pending(*st, rec, rn);
+    }
+}
+
+}
+
+}
+
+using detail::read_handler_t;
+
+prefetching_read_stream::prefetching_read_stream(concepts::async_random_access_read_device & device, std::uint64_t offset)
+    : prefetching_read_stream(device, offset, options{})
+{
+}
+
+prefetching_read_stream::prefetching_read_stream(concepts::async_random_access_read_device & device, std::uint64_t offset, options opts)
+{
+    opts.block_size = std::max<std::size_t>(opts.block_size, 1u);
+    opts.max_depth  = std::max<std::size_t>(opts.max_depth, 1u);
+    opts.min_depth  = std::clamp<std::size_t>(opts.min_depth, 1u, opts.max_depth);
+    state_ = new detail::prefetch_state(device, offset, opts);
+}
+
+prefetching_read_stream::prefetching_read_stream(prefetching_read_stream && lhs) noexcept
+    : state_(std::exchange(lhs.state_, nullptr))
+{
+}
+
+prefetching_read_stream& prefetching_read_stream::operator=(prefetching_read_stream && lhs) noexcept
+{
+    if (this != &lhs)
+    {
+        destroy_();
+        state_ = std::exchange(lhs.state_, nullptr);
+    }
+    return *this;
+}
+
+prefetching_read_stream::~prefetching_read_stream()
+{
+    destroy_();
+}
+
+void prefetching_read_stream::destroy_() noexcept
+{
+    if (!state_)
+        return;
+    if (state_->pending)
+        detail::complete_pending(*state_, asio::error::operation_aborted, 0u);
+    if (state_->in_flight > 0u)
+        std::exchange(state_, nullptr)->orphaned = true;
+    else
+        delete std::exchange(state_, nullptr);
+}
+
+auto prefetching_read_stream::get_executor() -> executor_type
+{
+    assert(state_);
+    return state_->device.get_executor();
+}
+
+std::uint64_t prefetching_read_stream::position() const
+{
+    assert(state_);
+    return state_->position;
+}
+
+std::size_t prefetching_read_stream::depth() const
+{
+    assert(state_);
+    return state_->depth;
+}
+
+void prefetching_read_stream::async_read_some_impl(const mutable_buffer & buffer, read_handler_t && h)
+{
+    assert(state_);
+    state_->single = buffer;
+    async_read_some_impl(std::span<const mutable_buffer>(&state_->single, 1u), std::move(h));
+}
+
+void prefetching_read_stream::async_read_some_impl(std::span<const mutable_buffer> buffers, read_handler_t && h)
+{
+    assert(state_ && !state_->pending);
+    auto & st = *state_;
+    st.buffers = buffers;
+
+    std::error_code ec;
+    const auto n = detail::consume(st, ec);
+    if (n > 0u || ec || asio::buffer_size(buffers) == 0u)
+    {
+        detail::refill(st);
+        return detail::post_completion(std::move(h), ec, n);
+    }
+
+    // the consumer caught up with the prefetches, so widen the window.
+    if (st.started)
+        st.depth = std::min(st.depth * 2u, st.opts.max_depth);
+    st.started = true;
+    detail::refill(st);
+
+    st.pending.emplace(std::move(h));
+    auto slot = st.pending->get_cancellation_slot();
+    if (slot.is_connected())
+        slot.assign([s = &st](asio::cancellation_type)
+                    {
+                        if (s->pending)
+                            detail::complete_pending(*s, asio::error::operation_aborted, 0u, true);
+                    });
+}
+
+}
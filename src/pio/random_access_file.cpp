@@ -6,6 +6,18 @@
 //
 
 #include <pio/random_access_file.hpp>
+#include <pio/registered_buffer_pool.hpp>
+#include "detail/handler_state.hpp"
+
+#include <asio/detail/throw_error.hpp>
+
+#include <cerrno>
+
+#if !defined(ASIO_WINDOWS)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace pio
 {
@@ -13,33 +25,192 @@ namespace pio
 random_access_file::random_access_file(const executor_type& ex) : impl_(ex) {}
 random_access_file::random_access_file(const executor_type& ex, const char* path, file_base::flags open_flags) : impl_(ex, path, open_flags) {}
 random_access_file::random_access_file(const executor_type& ex, const std::string& path, file_base::flags open_flags) : impl_(ex, path, open_flags) {}
-random_access_file::random_access_file(const executor_type& ex, const native_handle_type& native_file) : impl_(ex, native_file) {}
+random_access_file::random_access_file(const executor_type& ex, const native_handle_type& native_file) : impl_(ex, native_file) {update_alignment_();}
 random_access_file::random_access_file(random_access_file&& other) noexcept  = default;
 random_access_file& random_access_file::operator=(random_access_file&& other) noexcept  = default;
 random_access_file::~random_access_file() = default;
 
-std::size_t random_access_file::write_some_at(std::uint64_t offset, const const_buffer & buffers) {return impl_.write_some_at(offset, buffers);};
-std::size_t random_access_file::write_some_at(std::uint64_t offset, const const_buffer & buffers, asio::error_code& ec) {return impl_.write_some_at(offset, buffers, ec);};
-std::size_t random_access_file::read_some_at(std::uint64_t offset, const mutable_buffer & buffers) {return impl_.read_some_at(offset, buffers);};
-std::size_t random_access_file::read_some_at(std::uint64_t offset, const mutable_buffer & buffers, asio::error_code& ec) {return impl_.read_some_at(offset, buffers, ec);};
-void random_access_file::async_read_some_at_impl (std::uint64_t offset, mutable_buffer buffer, handler_type<void(std::error_code, std::size_t)> && h) { return impl_.async_read_some_at(offset, buffer, std::move(h)); }
-void random_access_file::async_write_some_at_impl(std::uint64_t offset,   const_buffer buffer, handler_type<void(std::error_code, std::size_t)> && h) { return impl_.async_write_some_at(offset, buffer, std::move(h)); }
+random_access_file::random_access_file(const executor_type& ex, const std::string& path, file_base::flags open_flags, direct_io_t tag)
+    : random_access_file(ex, path.c_str(), open_flags, tag)
+{
+}
+
+random_access_file::random_access_file(const executor_type& ex, const char* path, file_base::flags open_flags, direct_io_t) : impl_(ex)
+{
+#if defined(O_DIRECT)
+    // asio's flags are the posix open flags
+    const int fd = ::open(path, static_cast<int>(open_flags) | O_DIRECT | O_CLOEXEC, 0777);
+    if (fd < 0)
+        asio::detail::throw_error(std::error_code(errno, std::system_category()), "open");
+
+    std::error_code ec;
+    impl_.assign(fd, ec);
+    if (ec)
+    {
+        ::close(fd);
+        asio::detail::throw_error(ec, "open");
+    }
+    update_alignment_();
+#else
+    asio::detail::throw_error(asio::error::operation_not_supported, "open");
+#endif
+}
+
+void random_access_file::update_alignment_()
+{
+    alignment_ = {};
+#if defined(O_DIRECT)
+    const int fd = impl_.native_handle();
+    const int fl = ::fcntl(fd, F_GETFL);
+    if (fl >= 0 && (fl & O_DIRECT))
+    {
+        std::error_code ec;
+        alignment_ = query_direct_io_alignment(fd, ec);
+    }
+#endif
+}
+
+// direct i/o would fail with EINVAL, but only once it reaches the kernel.
+template<typename Buffers>
+static bool misaligned(const io_alignment & alignment, std::uint64_t offset, const Buffers & buffers)
+{
+    return alignment.required() && !alignment.check(offset, buffers);
+}
+
+// a read at or past the end transfers nothing, so it's eof whatever the alignment.
+// That's where a composed read ends up after the short read of a partial last block.
+static std::error_code misaligned_read_error(int fd, std::uint64_t offset)
+{
+#if !defined(ASIO_WINDOWS)
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && offset >= static_cast<std::uint64_t>(st.st_size))
+        return asio::error::eof;
+#endif
+    return asio::error::invalid_argument;
+}
+
+static void post_misaligned(handler_type<void(std::error_code, std::size_t)> && h,
+                            std::error_code ec = asio::error::invalid_argument)
+{
+    detail::post_completion(std::move(h), ec, std::size_t(0u));
+}
+
+std::size_t random_access_file::write_some_at(std::uint64_t offset, const const_buffer & buffers)
+{
+    if (misaligned(alignment_, offset, buffers))
+        asio::detail::throw_error(asio::error::invalid_argument, "write_some_at");
+    return impl_.write_some_at(offset, buffers);
+}
+std::size_t random_access_file::write_some_at(std::uint64_t offset, const const_buffer & buffers, asio::error_code& ec)
+{
+    if (misaligned(alignment_, offset, buffers))
+    {
+        ec = asio::error::invalid_argument;
+        return 0u;
+    }
+    return impl_.write_some_at(offset, buffers, ec);
+}
+std::size_t random_access_file::read_some_at(std::uint64_t offset, const mutable_buffer & buffers)
+{
+    if (misaligned(alignment_, offset, buffers))
+        asio::detail::throw_error(misaligned_read_error(impl_.native_handle(), offset), "read_some_at");
+    return impl_.read_some_at(offset, buffers);
+}
+std::size_t random_access_file::read_some_at(std::uint64_t offset, const mutable_buffer & buffers, asio::error_code& ec)
+{
+    if (misaligned(alignment_, offset, buffers))
+    {
+        ec = misaligned_read_error(impl_.native_handle(), offset);
+        return 0u;
+    }
+    return impl_.read_some_at(offset, buffers, ec);
+}
+std::size_t random_access_file::write_some_at(std::uint64_t offset, std::span<const const_buffer> buffers)
+{
+    if (misaligned(alignment_, offset, buffers))
+        asio::detail::throw_error(asio::error::invalid_argument, "write_some_at");
+    return impl_.write_some_at(offset, buffers);
+}
+std::size_t random_access_file::write_some_at(std::uint64_t offset, std::span<const const_buffer> buffers, asio::error_code& ec)
+{
+    if (misaligned(alignment_, offset, buffers))
+    {
+        ec = asio::error::invalid_argument;
+        return 0u;
+    }
+    return impl_.write_some_at(offset, buffers, ec);
+}
+std::size_t random_access_file::read_some_at(std::uint64_t offset, std::span<const mutable_buffer> buffers)
+{
+    if (misaligned(alignment_, offset, buffers))
+        asio::detail::throw_error(misaligned_read_error(impl_.native_handle(), offset), "read_some_at");
+    return impl_.read_some_at(offset, buffers);
+}
+std::size_t random_access_file::read_some_at(std::uint64_t offset, std::span<const mutable_buffer> buffers, asio::error_code& ec)
+{
+    if (misaligned(alignment_, offset, buffers))
+    {
+        ec = misaligned_read_error(impl_.native_handle(), offset);
+        return 0u;
+    }
+    return impl_.read_some_at(offset, buffers, ec);
+}
+
+// buffers from a registered_buffer_pool use READ_FIXED / WRITE_FIXED
+void random_access_file::async_read_some_at_impl (std::uint64_t offset, mutable_buffer buffer, handler_type<void(std::error_code, std::size_t)> && h)
+{
+    if (misaligned(alignment_, offset, buffer))
+        return post_misaligned(std::move(h), misaligned_read_error(impl_.native_handle(), offset));
+    if (auto rb = detail::find_registered_buffer(impl_.get_executor(), buffer))
+        return impl_.async_read_some_at(offset, *rb, std::move(h));
+    return impl_.async_read_some_at(offset, buffer, std::move(h));
+}
+void random_access_file::async_write_some_at_impl(std::uint64_t offset,   const_buffer buffer, handler_type<void(std::error_code, std::size_t)> && h)
+{
+    if (misaligned(alignment_, offset, buffer))
+        return post_misaligned(std::move(h));
+    if (auto rb = detail::find_registered_buffer(impl_.get_executor(), buffer))
+        return impl_.async_write_some_at(offset, *rb, std::move(h));
+    return impl_.async_write_some_at(offset, buffer, std::move(h));
+}
+void random_access_file::async_read_some_at_impl (std::uint64_t offset, std::span<const mutable_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h)
+{
+    if (misaligned(alignment_, offset, buffers))
+        return post_misaligned(std::move(h), misaligned_read_error(impl_.native_handle(), offset));
+    return impl_.async_read_some_at(offset, buffers, std::move(h));
+}
+void random_access_file::async_write_some_at_impl(std::uint64_t offset, std::span<const   const_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h)
+{
+    if (misaligned(alignment_, offset, buffers))
+        return post_misaligned(std::move(h));
+    return impl_.async_write_some_at(offset, buffers, std::move(h));
+}
 
 auto random_access_file::get_executor() -> executor_type {return impl_.get_executor();}
 
 bool random_access_file::is_open() const {return impl_.is_open();}
-void              random_access_file::close()                     {return impl_.close();}
-ASIO_SYNC_OP_VOID random_access_file::close(asio::error_code& ec) {return impl_.close(ec);}
+void              random_access_file::close()                     {alignment_ = {}; return impl_.close();}
+ASIO_SYNC_OP_VOID random_access_file::close(asio::error_code& ec) {alignment_ = {}; return impl_.close(ec);}
 
 void              random_access_file::cancel()                     {return impl_.cancel();}
 ASIO_SYNC_OP_VOID random_access_file::cancel(asio::error_code& ec) {return impl_.cancel(ec);}
 
-             void random_access_file::assign(const native_handle_type& native_handle)                        {return impl_.assign(native_handle);}
-ASIO_SYNC_OP_VOID random_access_file::assign(const native_handle_type& native_handle, asio::error_code & ec) {return impl_.assign(native_handle, ec);}
+void random_access_file::assign(const native_handle_type& native_handle)
+{
+    impl_.assign(native_handle);
+    update_alignment_();
+}
+ASIO_SYNC_OP_VOID random_access_file::assign(const native_handle_type& native_handle, asio::error_code & ec)
+{
+    impl_.assign(native_handle, ec);
+    if (!ec)
+        update_alignment_();
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+}
 
 auto random_access_file::native_handle() -> native_handle_type {return impl_.native_handle();};
 
-auto random_access_file::release()                      -> native_handle_type {return impl_.release();}   
-auto random_access_file::release(asio::error_code & ec) -> native_handle_type {return impl_.release(ec);}                           
+auto random_access_file::release()                      -> native_handle_type {alignment_ = {}; return impl_.release();}
+auto random_access_file::release(asio::error_code & ec) -> native_handle_type {alignment_ = {}; return impl_.release(ec);}                           
 
 }
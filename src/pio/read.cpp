@@ -7,6 +7,7 @@
 
 #include <asio/read.hpp>
 #include <pio/read.hpp>
+#include "detail/transfer_op.hpp"
 
 namespace pio
 {
@@ -15,6 +16,10 @@ namespace pio
     std::size_t read(concepts::sync_read_stream& s, const asio::mutable_buffer& buffers, asio::error_code& ec)                                               {return asio::read(s, buffers, ec);}
     std::size_t read(concepts::sync_read_stream& s, const asio::mutable_buffer& buffers, completion_condition_t completion_condition)                        {return asio::read(s, buffers, std::move(completion_condition));}
     std::size_t read(concepts::sync_read_stream& s, const asio::mutable_buffer& buffers, completion_condition_t completion_condition, asio::error_code& ec)  {return asio::read(s, buffers, std::move(completion_condition), ec);}
+    std::size_t read(concepts::sync_read_stream& s, std::span<const asio::mutable_buffer> buffers)                                                                      {return asio::read(s, buffers);}
+    std::size_t read(concepts::sync_read_stream& s, std::span<const asio::mutable_buffer> buffers, asio::error_code& ec)                                                {return asio::read(s, buffers, ec);}
+    std::size_t read(concepts::sync_read_stream& s, std::span<const asio::mutable_buffer> buffers, completion_condition_t completion_condition)                         {return asio::read(s, buffers, std::move(completion_condition));}
+    std::size_t read(concepts::sync_read_stream& s, std::span<const asio::mutable_buffer> buffers, completion_condition_t completion_condition, asio::error_code& ec)   {return asio::read(s, buffers, std::move(completion_condition), ec);}
     std::size_t read(concepts::sync_read_stream& s, dynamic_buffer buffers)                                                                                {return asio::read(s, std::move(buffers));}
     std::size_t read(concepts::sync_read_stream& s, dynamic_buffer buffers, asio::error_code& ec)                                                          {return asio::read(s, std::move(buffers), ec);}
     std::size_t read(concepts::sync_read_stream& s, dynamic_buffer buffers, completion_condition_t completion_condition)                                   {return asio::read(s, std::move(buffers), std::move(completion_condition));}
@@ -23,16 +28,50 @@ namespace pio
     std::size_t read(concepts::sync_read_stream& s, asio::streambuf & buffers, asio::error_code& ec)                                                       {return asio::read(s, buffers, ec);}
     std::size_t read(concepts::sync_read_stream& s, asio::streambuf & buffers, completion_condition_t completion_condition)                                {return asio::read(s, buffers, std::move(completion_condition));}
     std::size_t read(concepts::sync_read_stream& s, asio::streambuf & buffers, completion_condition_t completion_condition, asio::error_code& ec)          {return asio::read(s, buffers, std::move(completion_condition), ec);}
+    std::size_t read(concepts::sync_read_stream& s, segmented_buffer & buffers)                                                                            {return read(s, buffers, transfer_all());}
+    std::size_t read(concepts::sync_read_stream& s, segmented_buffer & buffers, asio::error_code& ec)                                                      {return read(s, buffers, transfer_all(), ec);}
+
+    std::size_t read(concepts::sync_read_stream& s, segmented_buffer & buffers, completion_condition_t completion_condition)
+    {
+        asio::error_code ec;
+        auto n = read(s, buffers, std::move(completion_condition), ec);
+        asio::detail::throw_error(ec, "read");
+        return n;
+    }
+
+    std::size_t read(concepts::sync_read_stream& s, segmented_buffer & buffers, completion_condition_t completion_condition, asio::error_code& ec)
+    {
+        ec.clear();
+        std::size_t total = 0u;
+        auto max_size = completion_condition(ec, total);
+        while (max_size > 0u)
+        {
+            const auto n = (std::min)((std::max)(buffers.segment_size(), buffers.capacity() - buffers.size()),
+                                      (std::min)(max_size, buffers.max_size() - buffers.size()));
+            if (n == 0u)
+                break;
+            const auto prepared = buffers.prepare(n);
+            const auto transferred = s.read_some(prepared.first((std::min)(prepared.size(), std::size_t(64u))), ec);
+            buffers.commit(transferred);
+            total += transferred;
+            max_size = completion_condition(ec, total);
+        }
+        return total;
+    }
 
     namespace detail
     {
-        void async_read_impl(concepts::async_read_stream& s, const asio::mutable_buffer& buffers,                                              handler_type<void(asio::error_code, std::size_t)> && h) {asio::async_read(s, buffers,                                  std::move(h));}
-        void async_read_impl(concepts::async_read_stream& s, const asio::mutable_buffer& buffers, completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h) {asio::async_read(s, buffers, std::move(completion_condition), std::move(h));}
-        void async_read_impl(concepts::async_read_stream& s, pio::dynamic_buffer buffers,                                                    handler_type<void(asio::error_code, std::size_t)> && h) {asio::async_read(s, std::move(buffers),                                  std::move(h));}
-        void async_read_impl(concepts::async_read_stream& s, pio::dynamic_buffer buffers,       completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h) {asio::async_read(s, std::move(buffers), std::move(completion_condition), std::move(h));}
-        void async_read_impl(concepts::async_read_stream& s, asio::streambuf &buffers,                                                       handler_type<void(asio::error_code, std::size_t)> && h) {asio::async_read(s, buffers,                                  std::move(h));}
-        void async_read_impl(concepts::async_read_stream& s, asio::streambuf &buffers,          completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h) {asio::async_read(s, buffers, std::move(completion_condition), std::move(h));}
+        void async_read_impl(concepts::async_read_stream& s, const asio::mutable_buffer& buffers,                                              handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(buffer_step<read_some_op, mutable_buffer>{{s}, buffers},                          transfer_all(),            std::move(h));}
+        void async_read_impl(concepts::async_read_stream& s, const asio::mutable_buffer& buffers, completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(buffer_step<read_some_op, mutable_buffer>{{s}, buffers},                          std::move(completion_condition), std::move(h));}
+        void async_read_impl(concepts::async_read_stream& s, std::span<const asio::mutable_buffer> buffers,                                              handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(buffer_sequence_step<read_some_op, mutable_buffer>{{s}, buffers},              transfer_all(),            std::move(h));}
+        void async_read_impl(concepts::async_read_stream& s, std::span<const asio::mutable_buffer> buffers, completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(buffer_sequence_step<read_some_op, mutable_buffer>{{s}, buffers},              std::move(completion_condition), std::move(h));}
+        void async_read_impl(concepts::async_read_stream& s, pio::dynamic_buffer buffers,                                                    handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(read_dynamic_v2_step<read_some_op, pio::dynamic_buffer>{{s}, std::move(buffers)}, transfer_all(),            std::move(h));}
+        void async_read_impl(concepts::async_read_stream& s, pio::dynamic_buffer buffers,       completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(read_dynamic_v2_step<read_some_op, pio::dynamic_buffer>{{s}, std::move(buffers)}, std::move(completion_condition), std::move(h));}
+        void async_read_impl(concepts::async_read_stream& s, asio::streambuf &buffers,                                                       handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(read_dynamic_v1_step<read_some_op, asio::streambuf&>{{s}, buffers},             transfer_all(),            std::move(h));}
+        void async_read_impl(concepts::async_read_stream& s, asio::streambuf &buffers,          completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(read_dynamic_v1_step<read_some_op, asio::streambuf&>{{s}, buffers},             std::move(completion_condition), std::move(h));}
+        void async_read_impl(concepts::async_read_stream& s, segmented_buffer &buffers,                                                      handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(read_segmented_step<read_some_op>{{s}, buffers},                                 transfer_all(),            std::move(h));}
+        void async_read_impl(concepts::async_read_stream& s, segmented_buffer &buffers,         completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(read_segmented_step<read_some_op>{{s}, buffers},                                 std::move(completion_condition), std::move(h));}
 
     }
 
-}
\ No newline at end of file
+}
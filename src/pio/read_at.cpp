@@ -7,6 +7,7 @@
 
 #include <asio/read_at.hpp>
 #include <pio/read_at.hpp>
+#include "detail/transfer_op.hpp"
 
 namespace pio
 {
@@ -39,6 +40,33 @@ std::size_t read_at(concepts::sync_random_access_read_device& d,
     return asio::read_at(d, offset, buffers, std::move(completion_condition), ec);
 }
 
+std::size_t read_at(concepts::sync_random_access_read_device& d,
+                     uint64_t offset, std::span<const mutable_buffer> buffers)
+{
+    return asio::read_at(d, offset, buffers);
+}
+
+std::size_t read_at(concepts::sync_random_access_read_device& d,
+                     uint64_t offset, std::span<const mutable_buffer> buffers,
+                     asio::error_code& ec)
+{
+    return asio::read_at(d, offset, buffers, ec);
+}
+
+std::size_t read_at(concepts::sync_random_access_read_device& d,
+                     uint64_t offset, std::span<const mutable_buffer> buffers,
+                     completion_condition_t completion_condition)
+{
+    return asio::read_at(d, offset, buffers, std::move(completion_condition));
+}
+
+std::size_t read_at(concepts::sync_random_access_read_device& d,
+                     uint64_t offset, std::span<const mutable_buffer> buffers,
+                     completion_condition_t completion_condition, asio::error_code& ec)
+{
+    return asio::read_at(d, offset, buffers, std::move(completion_condition), ec);
+}
+
 std::size_t read_at(concepts::sync_random_access_read_device& d,
                      uint64_t offset, asio::streambuf& b)
 {
@@ -71,15 +99,37 @@ void async_read_at_impl(
         concepts::async_random_access_read_device& d, std::uint64_t offset,
         const mutable_buffer & buffers, handler_type<void(asio::error_code, std::size_t)> && h)
 {
-    asio::async_read_at(d, offset, buffers, std::move(h));
+    start_transfer(buffer_step<read_some_at_op, mutable_buffer>{{d, offset}, buffers}, transfer_all(), std::move(h));
+}
+
+void async_read_at_impl(
+        concepts::async_random_access_read_device& d, std::uint64_t offset,
+        const mutable_buffer & buffers, completion_condition_t completion_condition,
+        handler_type<void(asio::error_code, std::size_t)> && h)
+{
+    start_transfer(buffer_step<read_some_at_op, mutable_buffer>{{d, offset}, buffers}, std::move(completion_condition), std::move(h));
+}
+
+void async_read_at_impl(
+        concepts::async_random_access_read_device& d, std::uint64_t offset,
+        std::span<const mutable_buffer> buffers, handler_type<void(asio::error_code, std::size_t)> && h)
+{
+    start_transfer(buffer_sequence_step<read_some_at_op, mutable_buffer>{{d, offset}, buffers}, transfer_all(), std::move(h));
 }
 
+void async_read_at_impl(
+        concepts::async_random_access_read_device& d, std::uint64_t offset,
+        std::span<const mutable_buffer> buffers, completion_condition_t completion_condition,
+        handler_type<void(asio::error_code, std::size_t)> && h)
+{
+    start_transfer(buffer_sequence_step<read_some_at_op, mutable_buffer>{{d, offset}, buffers}, std::move(completion_condition), std::move(h));
+}
 
 void async_read_at_impl(
         concepts::async_random_access_read_device& d, std::uint64_t offset,
         asio::streambuf& b, handler_type<void(asio::error_code, std::size_t)> && h)
 {
-    asio::async_read_at(d, offset, b, std::move(h));
+    start_transfer(read_dynamic_v1_step<read_some_at_op, asio::streambuf&>{{d, offset}, b}, transfer_all(), std::move(h));
 }
 
 void async_read_at_impl(
@@ -87,10 +137,9 @@ void async_read_at_impl(
         asio::streambuf& b, completion_condition_t completion_condition,
         handler_type<void(asio::error_code, std::size_t)> && h)
 {
-    asio::async_read_at(d, offset, b, std::move(completion_condition), std::move(h));
-
+    start_transfer(read_dynamic_v1_step<read_some_at_op, asio::streambuf&>{{d, offset}, b}, std::move(completion_condition), std::move(h));
 }
 
 }
 
-}
\ No newline at end of file
+}
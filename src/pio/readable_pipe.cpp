@@ -6,6 +6,7 @@
 //
 
 #include <pio/readable_pipe.hpp>
+#include "detail/leased_read.hpp"
 
 namespace pio
 {
@@ -14,29 +15,60 @@ readable_pipe::readable_pipe(const executor_type& ex)
 readable_pipe::readable_pipe(const executor_type& ex, const native_handle_type& native_file) : impl_(ex, native_file) {}
 
 readable_pipe::readable_pipe(readable_pipe&& other) noexcept = default;
-readable_pipe& readable_pipe::operator=(readable_pipe&& other) noexcept = default;
-readable_pipe::~readable_pipe() = default;
+readable_pipe& readable_pipe::operator=(readable_pipe&& other) noexcept
+{
+    reset_waiter_();
+    impl_ = std::move(other.impl_);
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+    waiter_ = std::move(other.waiter_);
+#endif
+    return *this;
+}
+readable_pipe::~readable_pipe() {reset_waiter_();}
 
 
 std::size_t readable_pipe::read_some(const mutable_buffer & buffers) {return impl_.read_some(buffers);}
 std::size_t readable_pipe::read_some(const mutable_buffer & buffers, asio::error_code& ec) {return impl_.read_some(buffers, ec);}
+std::size_t readable_pipe::read_some(std::span<const mutable_buffer> buffers) {return impl_.read_some(buffers);}
+std::size_t readable_pipe::read_some(std::span<const mutable_buffer> buffers, asio::error_code& ec) {return impl_.read_some(buffers, ec);}
 void readable_pipe::async_read_some_impl(const asio::mutable_buffer &buffer, handler_type<void(std::error_code, std::size_t)> && h) {return impl_.async_read_some(buffer, std::move(h));}
+void readable_pipe::async_read_some_impl(std::span<const asio::mutable_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h) {return impl_.async_read_some(buffers, std::move(h));}
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+void readable_pipe::async_read_some_impl(buffer_pool & pool, handler_type<void(std::error_code, leased_buffer)> && h) {return detail::async_ready_read(waiter_, impl_.get_executor(), impl_.native_handle(), pool, std::move(h));}
+#endif
 
 auto readable_pipe::get_executor() -> executor_type {return impl_.get_executor();}
 
 bool readable_pipe::is_open() const {return impl_.is_open();}
-void              readable_pipe::close()                     {return impl_.close();}
-ASIO_SYNC_OP_VOID readable_pipe::close(asio::error_code& ec) {return impl_.close(ec);}
 
-void              readable_pipe::cancel()                     {return impl_.cancel();}
-ASIO_SYNC_OP_VOID readable_pipe::cancel(asio::error_code& ec) {return impl_.cancel(ec);}
+// the duplicate used for readiness waits follows the lifetime of the pipe's descriptor
+void readable_pipe::reset_waiter_()
+{
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+    detail::reset_waiter(waiter_);
+#endif
+}
+
+void readable_pipe::cancel_waiter_()
+{
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+    if (waiter_)
+        waiter_->cancel();
+#endif
+}
+
+void              readable_pipe::close()                     {reset_waiter_(); return impl_.close();}
+ASIO_SYNC_OP_VOID readable_pipe::close(asio::error_code& ec) {reset_waiter_(); return impl_.close(ec);}
+
+void              readable_pipe::cancel()                     {cancel_waiter_(); return impl_.cancel();}
+ASIO_SYNC_OP_VOID readable_pipe::cancel(asio::error_code& ec) {cancel_waiter_(); return impl_.cancel(ec);}
 
-void readable_pipe::assign(const native_handle_type& native_handle)                        {return impl_.assign(native_handle);}
-ASIO_SYNC_OP_VOID readable_pipe::assign(const native_handle_type& native_handle, asio::error_code & ec) {return impl_.assign(native_handle, ec);}
+void readable_pipe::assign(const native_handle_type& native_handle)                        {reset_waiter_(); return impl_.assign(native_handle);}
+ASIO_SYNC_OP_VOID readable_pipe::assign(const native_handle_type& native_handle, asio::error_code & ec) {reset_waiter_(); return impl_.assign(native_handle, ec);}
 
 auto readable_pipe::native_handle() -> native_handle_type { return impl_.native_handle();};
 
-auto readable_pipe::release()                      -> native_handle_type {return impl_.release();}
-auto readable_pipe::release(asio::error_code & ec) -> native_handle_type {return impl_.release(ec);}
+auto readable_pipe::release()                      -> native_handle_type {reset_waiter_(); return impl_.release();}
+auto readable_pipe::release(asio::error_code & ec) -> native_handle_type {reset_waiter_(); return impl_.release(ec);}
 
 }
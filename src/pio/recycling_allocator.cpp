@@ -0,0 +1,124 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/recycling_allocator.hpp>
+
+#include <bit>
+#include <new>
+
+namespace pio
+{
+
+namespace
+{
+
+constexpr std::size_t min_block_shift = 6u; // 64 bytes
+constexpr std::size_t size_classes = 8u;    // up to 8 KiB
+constexpr std::size_t cache_depth = 32u;
+
+constexpr std::size_t size_class(std::size_t bytes)
+{
+    return bytes <= (std::size_t(1) << min_block_shift) ? 0u : std::bit_width(bytes - 1u) - min_block_shift;
+}
+
+constexpr std::size_t class_size(std::size_t idx)
+{
+    return std::size_t(1) << (idx + min_block_shift);
+}
+
+struct thread_cache;
+
+// trivially destructible, so they can still be read after the cache got destroyed at thread exit.
+thread_local thread_cache * current_cache = nullptr;
+thread_local bool cache_shut_down = false;
+
+struct thread_cache
+{
+    struct bucket
+    {
+        void * blocks[cache_depth];
+        std::size_t count = 0u;
+    };
+
+    bucket buckets[size_classes];
+
+    thread_cache()
+    {
+        current_cache = this;
+    }
+
+    ~thread_cache()
+    {
+        current_cache = nullptr;
+        cache_shut_down = true;
+        for (auto & b : buckets)
+            while (b.count > 0u)
+                ::operator delete(b.blocks[--b.count]);
+    }
+};
+
+thread_cache * get_cache()
+{
+    if (current_cache || cache_shut_down)
+        return current_cache;
+
+    thread_local thread_cache cache;
+    return &cache;
+}
+
+struct recycling_memory_resource final : std::pmr::memory_resource
+{
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        if (alignment > alignof(std::max_align_t))
+            return ::operator new(bytes, std::align_val_t(alignment));
+
+        const auto idx = size_class(bytes);
+        if (idx >= size_classes)
+            return ::operator new(bytes);
+
+        if (auto c = get_cache(); c && c->buckets[idx].count > 0u)
+        {
+            auto & b = c->buckets[idx];
+            return b.blocks[--b.count];
+        }
+        return ::operator new(class_size(idx));
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        if (alignment > alignof(std::max_align_t))
+            return ::operator delete(p, std::align_val_t(alignment));
+
+        const auto idx = size_class(bytes);
+        if (idx < size_classes)
+            if (auto c = get_cache(); c && c->buckets[idx].count < cache_depth)
+            {
+                auto & b = c->buckets[idx];
+                b.blocks[b.count++] = p;
+                return;
+            }
+
+        ::operator delete(p);
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+}
+
+std::pmr::memory_resource * recycling_resource() noexcept
+{
+    // intentionally never destroyed, handlers might get freed during static destruction.
+    static auto * resource = new recycling_memory_resource();
+    return resource;
+}
+
+}
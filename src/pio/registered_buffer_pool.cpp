@@ -0,0 +1,286 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/registered_buffer_pool.hpp>
+#include <asio/detail/throw_error.hpp>
+#include <asio/error.hpp>
+#include <asio/execution/context.hpp>
+#include <asio/query.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace pio
+{
+
+namespace detail
+{
+
+// process-wide table of live pools, so the file objects can find the registration
+// for a plain mutable_buffer without a service lookup on every operation.
+// The lookups don't lock: every slot is a seqlock holding a copy of the slab range, which is checked before
+// the pool is touched. A buffer inside the slab is only in use while the pool is alive,
+// so a slot that's being written belongs to a pool that can't own the buffer & is skipped.
+struct registered_buffer_registry
+{
+    constexpr static std::size_t max_pools = 16u;
+
+    struct slot_type
+    {
+        // odd while it's being written.
+        std::atomic<std::size_t> version{0u};
+        std::atomic<const unsigned char*> begin{nullptr};
+        std::atomic<const unsigned char*> end{nullptr};
+        std::atomic<asio::execution_context*> context{nullptr};
+        std::atomic<registered_buffer_pool*> pool{nullptr};
+    };
+
+    // serializes add & remove.
+    static std::mutex mutex;
+    static std::array<slot_type, max_pools> slots;
+    // the number of slots that were ever used, so a lookup doesn't scan the whole table.
+    static std::atomic<std::size_t> used;
+    // lets the lookups skip the table when there are no pools at all.
+    static std::atomic<std::size_t> count;
+
+    static void write(slot_type & slot, registered_buffer_pool * pool) noexcept
+    {
+        const auto v = slot.version.load(std::memory_order_relaxed);
+        slot.version.store(v + 1u, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.begin.store(pool ? pool->slab_.get() : nullptr, std::memory_order_relaxed);
+        slot.end.store(pool ? pool->slab_.get() + pool->block_size_ * pool->block_count_ : nullptr,
+                       std::memory_order_relaxed);
+        slot.context.store(pool ? &pool->context_ : nullptr, std::memory_order_relaxed);
+        slot.pool.store(pool, std::memory_order_relaxed);
+        slot.version.store(v + 2u, std::memory_order_release);
+    }
+
+    static void add(registered_buffer_pool * pool) noexcept
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        for (std::size_t i = 0u; i < max_pools; i++)
+            if (slots[i].pool.load(std::memory_order_relaxed) == nullptr)
+            {
+                write(slots[i], pool);
+                if (used.load(std::memory_order_relaxed) <= i)
+                    used.store(i + 1u, std::memory_order_release);
+                count.fetch_add(1u, std::memory_order_release);
+                return;
+            }
+        // table full: the pool works, but its buffers use the regular operations.
+    }
+
+    static void remove(registered_buffer_pool * pool) noexcept
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        for (auto & slot : slots)
+            if (slot.pool.load(std::memory_order_relaxed) == pool)
+            {
+                write(slot, nullptr);
+                count.fetch_sub(1u, std::memory_order_release);
+                return;
+            }
+    }
+
+    static std::optional<asio::mutable_registered_buffer> find(const asio::any_io_executor & exec,
+                                                               const void * data, std::size_t size)
+    {
+        if (count.load(std::memory_order_acquire) == 0u || size == 0u)
+            return std::nullopt;
+
+        auto & ctx = asio::query(exec, asio::execution::context);
+        const auto p = static_cast<const unsigned char*>(data);
+        const auto n = used.load(std::memory_order_acquire);
+        for (std::size_t i = 0u; i < n; i++)
+        {
+            auto & slot = slots[i];
+            const auto v = slot.version.load(std::memory_order_acquire);
+            if (v % 2u != 0u)
+                continue;
+            const auto begin   = slot.begin.load(std::memory_order_relaxed);
+            const auto end     = slot.end.load(std::memory_order_relaxed);
+            const auto context = slot.context.load(std::memory_order_relaxed);
+            const auto pool    = slot.pool.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.version.load(std::memory_order_relaxed) != v)
+                continue;
+
+            if (pool && context == &ctx && p >= begin && p < end
+                && size <= static_cast<std::size_t>(end - p))
+                return pool->find(data, size);
+        }
+        return std::nullopt;
+    }
+};
+
+std::mutex registered_buffer_registry::mutex;
+std::array<registered_buffer_registry::slot_type, registered_buffer_registry::max_pools>
+    registered_buffer_registry::slots{};
+std::atomic<std::size_t> registered_buffer_registry::used{0u};
+std::atomic<std::size_t> registered_buffer_registry::count{0u};
+
+std::optional<asio::mutable_registered_buffer> find_registered_buffer(const asio::any_io_executor & exec,
+                                                                      const mutable_buffer & buffer)
+{
+    return registered_buffer_registry::find(exec, buffer.data(), buffer.size());
+}
+
+std::optional<asio::const_registered_buffer> find_registered_buffer(const asio::any_io_executor & exec,
+                                                                    const const_buffer & buffer)
+{
+    if (auto r = registered_buffer_registry::find(exec, buffer.data(), buffer.size()))
+        return asio::const_registered_buffer(*r);
+    return std::nullopt;
+}
+
+}
+
+constexpr static std::size_t slab_alignment = 4096u;
+// io_uring rejects larger fixed buffers.
+constexpr static std::size_t max_registration_size = std::size_t(1u) << 30u;
+
+// rounds the block size up & checks that the slab can be allocated & registered.
+static std::size_t checked_block_size(std::size_t block_size, std::size_t block_count)
+{
+    if (block_size == 0u || block_count == 0u || block_size > max_registration_size)
+        asio::detail::throw_error(asio::error::invalid_argument, "registered_buffer_pool");
+
+    block_size = (block_size + slab_alignment - 1u) / slab_alignment * slab_alignment;
+    if (block_count > std::numeric_limits<std::size_t>::max() / block_size)
+        asio::detail::throw_error(asio::error::invalid_argument, "registered_buffer_pool");
+    return block_size;
+}
+
+// the slab is registered in chunks of whole blocks up to the maximum size,
+// one buffer per block would run into the UIO_MAXIOV limit of the kernel.
+static std::vector<mutable_buffer> make_registration(unsigned char * slab, std::size_t block_size,
+                                                     std::size_t block_count, std::size_t registration_blocks)
+{
+    std::vector<mutable_buffer> chunks;
+    chunks.reserve((block_count + registration_blocks - 1u) / registration_blocks);
+    for (std::size_t i = 0u; i < block_count; i += registration_blocks)
+        chunks.emplace_back(slab + i * block_size, std::min(registration_blocks, block_count - i) * block_size);
+    return chunks;
+}
+
+void registered_buffer_pool::slab_deleter::operator()(unsigned char * p) const noexcept
+{
+    ::operator delete(p, std::align_val_t{slab_alignment});
+}
+
+registered_buffer_pool::registered_buffer_pool(const executor_type & exec, std::size_t block_size, std::size_t block_count)
+    : executor_(exec),
+      context_(asio::query(exec, asio::execution::context)),
+      block_size_(checked_block_size(block_size, block_count)),
+      block_count_(block_count),
+      registration_blocks_(max_registration_size / block_size_),
+      slab_(static_cast<unsigned char*>(::operator new(block_size_ * block_count_, std::align_val_t{slab_alignment}))),
+      registration_(asio::register_buffers(context_, make_registration(slab_.get(), block_size_, block_count_, registration_blocks_)))
+{
+    // hand out the low blocks first
+    free_.reserve(block_count_);
+    for (std::size_t i = block_count_; i > 0u; i--)
+        free_.push_back(i - 1u);
+
+    detail::registered_buffer_registry::add(this);
+}
+
+registered_buffer_pool::~registered_buffer_pool()
+{
+    assert(available() == block_count_);
+    detail::registered_buffer_registry::remove(this);
+}
+
+std::size_t registered_buffer_pool::available() const
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    return free_.size();
+}
+
+registered_buffer registered_buffer_pool::allocate()
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (free_.empty())
+        return registered_buffer{};
+
+    const auto idx = free_.back();
+    free_.pop_back();
+    return registered_buffer{this, idx, mutable_buffer(slab_.get() + idx * block_size_, block_size_)};
+}
+
+void registered_buffer_pool::deallocate_(std::size_t index) noexcept
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    // can't throw, the capacity is reserved for all blocks
+    free_.push_back(index);
+}
+
+bool registered_buffer_pool::owns(const void * data, std::size_t size) const noexcept
+{
+    const auto begin = reinterpret_cast<std::uintptr_t>(slab_.get());
+    const auto p     = reinterpret_cast<std::uintptr_t>(data);
+    return p >= begin && p - begin <= block_size_ * block_count_ && size <= block_size_ * block_count_ - (p - begin);
+}
+
+std::optional<asio::mutable_registered_buffer> registered_buffer_pool::find(const void * data, std::size_t size) const
+{
+    if (!owns(data, size))
+        return std::nullopt;
+
+    const auto offset = static_cast<std::size_t>(static_cast<const unsigned char*>(data) - slab_.get());
+    const auto chunk = registration_blocks_ * block_size_;
+    const auto idx = offset / chunk;
+    // straddles two registrations
+    if (offset - idx * chunk + size > chunk)
+        return std::nullopt;
+    return asio::buffer(registration_[idx] + (offset - idx * chunk), size);
+}
+
+registered_buffer::registered_buffer(registered_buffer && lhs) noexcept
+    : pool_(std::exchange(lhs.pool_, nullptr)), index_(lhs.index_), buffer_(std::exchange(lhs.buffer_, mutable_buffer{}))
+{
+}
+
+registered_buffer& registered_buffer::operator=(registered_buffer && lhs) noexcept
+{
+    if (this != &lhs)
+    {
+        release();
+        pool_   = std::exchange(lhs.pool_, nullptr);
+        index_  = lhs.index_;
+        buffer_ = std::exchange(lhs.buffer_, mutable_buffer{});
+    }
+    return *this;
+}
+
+registered_buffer::~registered_buffer()
+{
+    release();
+}
+
+void registered_buffer::release() noexcept
+{
+    if (pool_)
+        std::exchange(pool_, nullptr)->deallocate_(index_);
+    buffer_ = mutable_buffer{};
+}
+
+asio::mutable_registered_buffer registered_buffer::registered() const
+{
+    assert(pool_);
+    const auto rb = pool_->registration_blocks_;
+    return asio::buffer(pool_->registration_[index_ / rb] + (index_ % rb) * pool_->block_size_, pool_->block_size_);
+}
+
+}
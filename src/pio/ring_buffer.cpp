@@ -0,0 +1,128 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/ring_buffer.hpp>
+
+#if !defined(ASIO_WINDOWS)
+
+#include <asio/detail/throw_error.hpp>
+
+#include <cerrno>
+#include <cstdio>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace pio
+{
+
+namespace
+{
+
+std::error_code last_error()
+{
+    return std::error_code(errno, std::system_category());
+}
+
+// an anonymous shared memory object, that's only reachable through the returned descriptor.
+int make_shared_memory(std::error_code & ec)
+{
+#if defined(__linux__)
+    int fd = ::memfd_create("pio::ring_buffer", MFD_CLOEXEC);
+#elif defined(SHM_ANON)
+    int fd = ::shm_open(SHM_ANON, O_RDWR | O_CLOEXEC, 0600);
+#else
+    int fd = -1;
+    for (unsigned attempt = 0u; fd == -1 && attempt < 16u; attempt++)
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "/pio-ring-%ld-%u-%p", static_cast<long>(::getpid()), attempt,
+                      static_cast<void*>(&name));
+        fd = ::shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd != -1)
+            ::shm_unlink(name);
+        else if (errno != EEXIST)
+            break;
+    }
+#endif
+    if (fd == -1)
+        ec = last_error();
+    return fd;
+}
+
+}
+
+ring_buffer::ring_buffer(std::size_t capacity)
+{
+    const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    capacity = (std::max)(capacity, std::size_t(1u));
+    capacity = (capacity + page_size - 1u) / page_size * page_size;
+
+    std::error_code ec;
+    const int fd = make_shared_memory(ec);
+    if (fd == -1)
+        asio::detail::throw_error(ec, "ring_buffer");
+
+    // reserve the address space for both halves first, so nothing else can get mapped in between.
+    void * base = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(capacity)) != 0)
+        ec = last_error();
+    else if ((base = ::mmap(nullptr, 2u * capacity, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) == MAP_FAILED)
+        ec = last_error();
+    else
+    {
+        auto lower = static_cast<unsigned char*>(base);
+        if (::mmap(lower,            capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED
+         || ::mmap(lower + capacity, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+        {
+            ec = last_error();
+            ::munmap(base, 2u * capacity);
+        }
+    }
+
+    // the mappings keep the memory alive.
+    ::close(fd);
+    if (ec)
+        asio::detail::throw_error(ec, "ring_buffer");
+
+    base_ = static_cast<unsigned char*>(base);
+    capacity_ = capacity;
+}
+
+ring_buffer::~ring_buffer()
+{
+    if (base_)
+        ::munmap(base_, 2u * capacity_);
+}
+
+ring_buffer::ring_buffer(ring_buffer && lhs) noexcept
+    : base_(std::exchange(lhs.base_, nullptr)),
+      capacity_(std::exchange(lhs.capacity_, 0u)),
+      head_(std::exchange(lhs.head_, 0u)),
+      size_(std::exchange(lhs.size_, 0u))
+{
+}
+
+ring_buffer& ring_buffer::operator=(ring_buffer && lhs) noexcept
+{
+    if (this != &lhs)
+    {
+        if (base_)
+            ::munmap(base_, 2u * capacity_);
+        base_     = std::exchange(lhs.base_, nullptr);
+        capacity_ = std::exchange(lhs.capacity_, 0u);
+        head_     = std::exchange(lhs.head_, 0u);
+        size_     = std::exchange(lhs.size_, 0u);
+    }
+    return *this;
+}
+
+}
+
+#endif
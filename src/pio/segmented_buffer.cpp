@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/segmented_buffer.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace pio
+{
+
+segmented_buffer::segmented_buffer(std::size_t segment_size, std::size_t max_size, std::pmr::memory_resource * resource)
+    : segment_size_((std::max)(segment_size, std::size_t(1u))), max_size_(max_size), resource_(resource)
+{
+}
+
+segmented_buffer::~segmented_buffer()
+{
+    clear();
+    shrink_to_fit();
+}
+
+std::size_t segmented_buffer::capacity() const noexcept
+{
+    return (segments_.size() + free_.size()) * segment_size_ - head_;
+}
+
+auto segmented_buffer::data() const -> const_buffers_type
+{
+    readable_.clear();
+    auto pos = head_;
+    auto remaining = size_;
+    for (auto itr = segments_.begin(); remaining > 0u; itr++, pos = 0u)
+    {
+        const auto n = (std::min)(segment_size_ - pos, remaining);
+        readable_.emplace_back(*itr + pos, n);
+        remaining -= n;
+    }
+    return readable_;
+}
+
+unsigned char * segmented_buffer::allocate_segment_()
+{
+    if (!free_.empty())
+    {
+        auto seg = free_.back();
+        free_.pop_back();
+        return seg;
+    }
+    return static_cast<unsigned char*>(resource_->allocate(segment_size_, alignof(std::max_align_t)));
+}
+
+auto segmented_buffer::prepare(std::size_t n) -> mutable_buffers_type
+{
+    if (n > max_size_ - size_)
+        throw std::length_error("pio::segmented_buffer too long");
+
+    const auto end = head_ + size_ + n;
+    while (segments_.size() * segment_size_ < end)
+        segments_.push_back(allocate_segment_());
+
+    writable_.clear();
+    auto index = (head_ + size_) / segment_size_;
+    auto pos   = (head_ + size_) % segment_size_;
+    for (auto remaining = n; remaining > 0u; index++, pos = 0u)
+    {
+        const auto chunk = (std::min)(segment_size_ - pos, remaining);
+        writable_.emplace_back(segments_[index] + pos, chunk);
+        remaining -= chunk;
+    }
+    prepared_ = n;
+    return writable_;
+}
+
+void segmented_buffer::commit(std::size_t n)
+{
+    size_ += (std::min)(n, prepared_);
+    prepared_ = 0u;
+}
+
+void segmented_buffer::consume(std::size_t n)
+{
+    n = (std::min)(n, size_);
+    size_ -= n;
+    head_ += n;
+    prepared_ = 0u;
+
+    // the data doesn't move, the segments read completely are recycled.
+    while (head_ >= segment_size_ && !segments_.empty())
+    {
+        free_.push_back(segments_.front());
+        segments_.pop_front();
+        head_ -= segment_size_;
+    }
+
+    if (size_ == 0u)
+    {
+        free_.insert(free_.end(), segments_.begin(), segments_.end());
+        segments_.clear();
+        head_ = 0u;
+    }
+}
+
+void segmented_buffer::clear()
+{
+    consume(size_);
+}
+
+void segmented_buffer::shrink_to_fit()
+{
+    for (auto seg : free_)
+        resource_->deallocate(seg, segment_size_, alignof(std::max_align_t));
+    free_.clear();
+    free_.shrink_to_fit();
+}
+
+}
@@ -6,6 +6,7 @@
 //
 
 #include <pio/serial_port.hpp>
+#include "detail/leased_read.hpp"
 
 namespace pio
 {
@@ -14,22 +15,46 @@ serial_port::serial_port(const executor_type& ex, const std::string& device) : i
 serial_port::serial_port(const executor_type& ex, const native_handle_type& native_serial_port) : impl_(ex, native_serial_port) {}
 
 serial_port::serial_port(serial_port&& other) = default;
-serial_port& serial_port::operator=(serial_port&& other) = default;
-serial_port::~serial_port() = default;
+serial_port& serial_port::operator=(serial_port&& other)
+{
+    reset_waiter_();
+    impl_ = std::move(other.impl_);
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+    waiter_ = std::move(other.waiter_);
+#endif
+    return *this;
+}
+serial_port::~serial_port() {reset_waiter_();}
 
 auto serial_port::get_executor() noexcept -> executor_type  { return impl_.get_executor();}
 
-void serial_port::open(const std::string& device) { return impl_.open(device); }
-ASIO_SYNC_OP_VOID serial_port::open(const std::string& device, asio::error_code& ec) {return impl_.open(device, ec);}
-void serial_port::assign(const native_handle_type& native_serial_port) {return impl_.assign(native_serial_port);}
-ASIO_SYNC_OP_VOID serial_port::assign(const native_handle_type& native_serial_port, asio::error_code& ec) {return impl_.assign(native_serial_port, ec);}
+// the duplicate used for readiness waits follows the lifetime of the port's descriptor
+void serial_port::reset_waiter_()
+{
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+    detail::reset_waiter(waiter_);
+#endif
+}
+
+void serial_port::cancel_waiter_()
+{
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+    if (waiter_)
+        waiter_->cancel();
+#endif
+}
+
+void serial_port::open(const std::string& device) { reset_waiter_(); return impl_.open(device); }
+ASIO_SYNC_OP_VOID serial_port::open(const std::string& device, asio::error_code& ec) {reset_waiter_(); return impl_.open(device, ec);}
+void serial_port::assign(const native_handle_type& native_serial_port) {reset_waiter_(); return impl_.assign(native_serial_port);}
+ASIO_SYNC_OP_VOID serial_port::assign(const native_handle_type& native_serial_port, asio::error_code& ec) {reset_waiter_(); return impl_.assign(native_serial_port, ec);}
 
 bool serial_port::is_open() const { return impl_.is_open(); }
-void              serial_port::close()                     { return impl_.close(); }
-ASIO_SYNC_OP_VOID serial_port::close(asio::error_code& ec) { return impl_.close(ec); }
+void              serial_port::close()                     { reset_waiter_(); return impl_.close(); }
+ASIO_SYNC_OP_VOID serial_port::close(asio::error_code& ec) { reset_waiter_(); return impl_.close(ec); }
 auto serial_port::native_handle() -> native_handle_type { return impl_.native_handle(); }
-void              serial_port::cancel()                     { return impl_.cancel(); }
-ASIO_SYNC_OP_VOID serial_port::cancel(asio::error_code& ec) { return impl_.cancel(ec); }
+void              serial_port::cancel()                     { cancel_waiter_(); return impl_.cancel(); }
+ASIO_SYNC_OP_VOID serial_port::cancel(asio::error_code& ec) { cancel_waiter_(); return impl_.cancel(ec); }
 void              serial_port::send_break()                     { return impl_.send_break(); }
 ASIO_SYNC_OP_VOID serial_port::send_break(asio::error_code& ec) { return impl_.send_break(ec); }
 
@@ -62,6 +87,10 @@ std::size_t serial_port::write_some(const const_buffer& buffers) {return impl_.w
 std::size_t serial_port::write_some(const const_buffer& buffers, asio::error_code& ec) {return impl_.write_some(buffers, ec);}
 std::size_t serial_port::read_some(const mutable_buffer& buffers) {return impl_.read_some(buffers);}
 std::size_t serial_port::read_some(const mutable_buffer& buffers, asio::error_code& ec) {return impl_.read_some(buffers, ec);}
+std::size_t serial_port::write_some(std::span<const const_buffer> buffers) {return impl_.write_some(buffers);}
+std::size_t serial_port::write_some(std::span<const const_buffer> buffers, asio::error_code& ec) {return impl_.write_some(buffers, ec);}
+std::size_t serial_port::read_some(std::span<const mutable_buffer> buffers) {return impl_.read_some(buffers);}
+std::size_t serial_port::read_some(std::span<const mutable_buffer> buffers, asio::error_code& ec) {return impl_.read_some(buffers, ec);}
 
 void serial_port::async_read_some_impl(const asio::mutable_buffer &buffer, handler_type<void(std::error_code, std::size_t)> && h)
 {
@@ -71,5 +100,19 @@ void serial_port::async_write_some_impl(asio::const_buffer buffer, handler_type<
 {
     return impl_.async_write_some(buffer, std::move(h));
 }
+void serial_port::async_read_some_impl(std::span<const asio::mutable_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h)
+{
+    return impl_.async_read_some(buffers, std::move(h));
+}
+void serial_port::async_write_some_impl(std::span<const asio::const_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h)
+{
+    return impl_.async_write_some(buffers, std::move(h));
+}
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+void serial_port::async_read_some_impl(buffer_pool & pool, handler_type<void(std::error_code, leased_buffer)> && h)
+{
+    return detail::async_ready_read(waiter_, impl_.get_executor(), impl_.native_handle(), pool, std::move(h));
+}
+#endif
 
 }
\ No newline at end of file
@@ -0,0 +1,62 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/shared_buffer.hpp>
+
+#include <cstring>
+#include <new>
+
+namespace pio
+{
+
+namespace
+{
+
+constexpr std::size_t block_alignment = alignof(std::max_align_t);
+// the data starts aligned, right after the header.
+constexpr std::size_t header_size =
+        (sizeof(detail::shared_buffer_block) + block_alignment - 1u) / block_alignment * block_alignment;
+
+}
+
+shared_buffer::shared_buffer(const_buffer content, threading t, std::pmr::memory_resource * resource)
+{
+    auto mem = resource->allocate(header_size + content.size(), block_alignment);
+    block_ = ::new (mem) detail::shared_buffer_block{1u, t == threading::multi, content.size(), resource};
+    auto data = static_cast<unsigned char*>(mem) + header_size;
+    if (content.size() > 0u)
+        std::memcpy(data, content.data(), content.size());
+    data_ = data;
+    size_ = content.size();
+}
+
+std::size_t shared_buffer::use_count() const noexcept
+{
+    if (block_ == nullptr)
+        return 0u;
+    if (block_->atomic)
+        return std::atomic_ref<std::size_t>(block_->refs).load(std::memory_order_relaxed);
+    return block_->refs;
+}
+
+void shared_buffer::release_block_(detail::shared_buffer_block * block) noexcept
+{
+    if (block->atomic)
+    {
+        if (std::atomic_ref<std::size_t>(block->refs).fetch_sub(1u, std::memory_order_acq_rel) != 1u)
+            return;
+    }
+    else if (--block->refs != 0u)
+        return;
+
+    auto resource = block->resource;
+    const auto size = block->size;
+    block->~shared_buffer_block();
+    resource->deallocate(block, header_size + size, block_alignment);
+}
+
+}
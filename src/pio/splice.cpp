@@ -0,0 +1,220 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/splice.hpp>
+#include "detail/handler_state.hpp"
+
+#if defined(__linux__)
+
+#include <asio/error.hpp>
+#include <asio/posix/stream_descriptor.hpp>
+
+#include <cerrno>
+#include <memory>
+#include <optional>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+namespace pio::detail
+{
+
+namespace
+{
+
+using transfer_handler = handler_type<void(std::error_code, std::size_t)>;
+
+ssize_t splice_step(bool tee, int source, int sink, std::size_t n, unsigned int flags)
+{
+    return tee ? ::tee(source, sink, n, flags)
+               : ::splice(source, nullptr, sink, nullptr, n, flags | SPLICE_F_MOVE);
+}
+
+// after a splice failed with EAGAIN, find out which of the descriptors isn't ready.
+pollfd blocked_side(int source, int sink)
+{
+    pollfd fds[2] = {{source, POLLIN, 0}, {sink, POLLOUT, 0}};
+    ::poll(fds, 2, 0);
+    if (fds[0].revents != 0 && fds[1].revents == 0)
+        return {sink, POLLOUT, 0};
+    return {source, POLLIN, 0};
+}
+
+// the sync version, waits with poll if the descriptors are non-blocking.
+std::size_t sync_transfer(bool tee, int source, int sink, std::size_t n, std::error_code & ec)
+{
+    ec.clear();
+    std::size_t transferred = 0u;
+    while (transferred < n)
+    {
+        const auto res = splice_step(tee, source, sink, n - transferred, 0u);
+        if (res > 0)
+        {
+            transferred += static_cast<std::size_t>(res);
+            if (tee)
+                break;
+        }
+        else if (res == 0)
+        {
+            ec = asio::error::eof;
+            break;
+        }
+        else if (errno == EAGAIN)
+        {
+            // only wait for the blocked side, the other one being ready would wake the poll right away.
+            auto fd = blocked_side(source, sink);
+            ::poll(&fd, 1, -1);
+        }
+        else if (errno != EINTR)
+        {
+            ec.assign(errno, std::system_category());
+            break;
+        }
+    }
+    return transferred;
+}
+
+// The waiting descriptors live in the state, so they don't move while a wait is pending.
+struct splice_state : handler_state<void(std::error_code, std::size_t)>
+{
+    splice_state(bool tee, const asio::any_io_executor & exec, int source, int sink, std::size_t n, transfer_handler && h)
+        : handler_state(std::move(h)), tee(tee), source(source), sink(sink), remaining(n), executor(exec)
+    {
+    }
+
+    bool tee;
+    int source, sink;
+    std::size_t remaining, transferred = 0u;
+    asio::any_io_executor executor;
+    // duplicates of the descriptors, created on the first wait, since the originals are registered by their owners.
+    std::optional<asio::posix::stream_descriptor> source_waiter, sink_waiter;
+};
+
+using splice_ptr = handler_state_ptr<splice_state>;
+
+void run(splice_ptr st, bool initiating);
+
+// the handler of the readiness waits, forwarding the associated properties of the final handler.
+struct splice_wait_op
+{
+    splice_ptr state;
+
+    using executor_type = asio::any_io_executor;
+    executor_type get_executor() const {return state->handler.get_executor();}
+
+    using allocator_type = std::pmr::polymorphic_allocator<void>;
+    allocator_type get_allocator() const {return state->allocator;}
+
+    using cancellation_slot_type = asio::cancellation_slot;
+    cancellation_slot_type get_cancellation_slot() const {return state->handler.get_cancellation_slot();}
+
+    void operator()(std::error_code ec);
+};
+
+void complete(splice_ptr st, std::error_code ec, bool initiating)
+{
+    auto h = std::move(st->handler);
+    const auto n = st->transferred;
+    st.reset();
+    if (initiating) // must not complete from within the initiating function
+        post_completion(std::move(h), ec, n);
+    else
+        h(ec, n);
+}
+
+asio::posix::stream_descriptor * get_waiter(std::optional<asio::posix::stream_descriptor> & waiter,
+                                            const asio::any_io_executor & exec, int fd, std::error_code & ec)
+{
+    if (!waiter)
+    {
+        const int dp = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+        if (dp < 0)
+        {
+            ec.assign(errno, std::system_category());
+            return nullptr;
+        }
+        waiter.emplace(exec, dp);
+    }
+    return &*waiter;
+}
+
+void run(splice_ptr st, bool initiating)
+{
+    while (true)
+    {
+        const auto res = splice_step(st->tee, st->source, st->sink, st->remaining, SPLICE_F_NONBLOCK);
+        if (res > 0)
+        {
+            st->transferred += static_cast<std::size_t>(res);
+            st->remaining   -= static_cast<std::size_t>(res);
+            if (st->tee || st->remaining == 0u)
+                return complete(std::move(st), {}, initiating);
+            continue;
+        }
+        else if (res == 0)
+            return complete(std::move(st), asio::error::eof, initiating);
+        else if (errno == EINTR)
+            continue;
+        else if (errno != EAGAIN)
+            return complete(std::move(st), std::error_code(errno, std::system_category()), initiating);
+
+        const bool sink_blocked = blocked_side(st->source, st->sink).fd == st->sink;
+
+        std::error_code ec;
+        auto & waiter = sink_blocked ? st->sink_waiter : st->source_waiter;
+        auto w = get_waiter(waiter, st->executor, sink_blocked ? st->sink : st->source, ec);
+        if (!w)
+            return complete(std::move(st), ec, initiating);
+
+        return w->async_wait(sink_blocked ? asio::posix::descriptor_base::wait_write
+                                          : asio::posix::descriptor_base::wait_read,
+                             splice_wait_op{std::move(st)});
+    }
+}
+
+void splice_wait_op::operator()(std::error_code ec)
+{
+    if (ec)
+        complete(std::move(state), ec, false);
+    else
+        run(std::move(state), false);
+}
+
+void start(bool tee, const asio::any_io_executor & exec, int source, int sink, std::size_t n, transfer_handler && h)
+{
+    splice_ptr st{new_handler_state<splice_state>(std::move(h), tee, exec, source, sink, n)};
+    if (n == 0u)
+        return complete(std::move(st), {}, true);
+    run(std::move(st), true);
+}
+
+}
+
+std::size_t splice_impl(int source, int sink, std::size_t n, std::error_code & ec)
+{
+    return sync_transfer(false, source, sink, n, ec);
+}
+
+std::size_t tee_impl(int source, int sink, std::size_t n, std::error_code & ec)
+{
+    return sync_transfer(true, source, sink, n, ec);
+}
+
+void async_splice_impl(const asio::any_io_executor & exec, int source, int sink, std::size_t n, transfer_handler && h)
+{
+    start(false, exec, source, sink, n, std::move(h));
+}
+
+void async_tee_impl(const asio::any_io_executor & exec, int source, int sink, std::size_t n, transfer_handler && h)
+{
+    start(true, exec, source, sink, n, std::move(h));
+}
+
+}
+
+#endif
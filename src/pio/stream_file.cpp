@@ -6,6 +6,7 @@
 //
 
 #include <pio/stream_file.hpp>
+#include <pio/registered_buffer_pool.hpp>
 
 namespace pio
 {
@@ -36,8 +37,26 @@ std::size_t stream_file::write_some(const const_buffer & buffers) {return impl_.
 std::size_t stream_file::write_some(const const_buffer & buffers, asio::error_code& ec) {return impl_.write_some(buffers, ec);}
 std::size_t stream_file::read_some(const mutable_buffer & buffers) {return impl_.read_some(buffers);}
 std::size_t stream_file::read_some(const mutable_buffer & buffers, asio::error_code& ec) {return impl_.read_some(buffers, ec);}
-void stream_file::async_read_some_impl(const asio::mutable_buffer &buffer, handler_type<void(std::error_code, std::size_t)> && h) {return impl_.async_read_some(buffer, std::move(h));}
-void stream_file::async_write_some_impl(asio::const_buffer buffer, handler_type<void(std::error_code, std::size_t)> && h) {return impl_.async_write_some(buffer, std::move(h));}
+std::size_t stream_file::write_some(std::span<const const_buffer> buffers) {return impl_.write_some(buffers);}
+std::size_t stream_file::write_some(std::span<const const_buffer> buffers, asio::error_code& ec) {return impl_.write_some(buffers, ec);}
+std::size_t stream_file::read_some(std::span<const mutable_buffer> buffers) {return impl_.read_some(buffers);}
+std::size_t stream_file::read_some(std::span<const mutable_buffer> buffers, asio::error_code& ec) {return impl_.read_some(buffers, ec);}
+
+// buffers from a registered_buffer_pool use READ_FIXED / WRITE_FIXED
+void stream_file::async_read_some_impl(const asio::mutable_buffer &buffer, handler_type<void(std::error_code, std::size_t)> && h)
+{
+    if (auto rb = detail::find_registered_buffer(impl_.get_executor(), buffer))
+        return impl_.async_read_some(*rb, std::move(h));
+    return impl_.async_read_some(buffer, std::move(h));
+}
+void stream_file::async_write_some_impl(asio::const_buffer buffer, handler_type<void(std::error_code, std::size_t)> && h)
+{
+    if (auto rb = detail::find_registered_buffer(impl_.get_executor(), buffer))
+        return impl_.async_write_some(*rb, std::move(h));
+    return impl_.async_write_some(buffer, std::move(h));
+}
+void stream_file::async_read_some_impl(std::span<const asio::mutable_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h) {return impl_.async_read_some(buffers, std::move(h));}
+void stream_file::async_write_some_impl(std::span<const asio::const_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h) {return impl_.async_write_some(buffers, std::move(h));}
 
 auto stream_file::get_executor() -> executor_type {return impl_.get_executor();}
 
@@ -26,7 +26,10 @@ writable_pipe::~writable_pipe()= default;
 
 std::size_t writable_pipe::write_some(const const_buffer & buffers) {return impl_.write_some(buffers);}
 std::size_t writable_pipe::write_some(const const_buffer & buffers, asio::error_code& ec) {return impl_.write_some(buffers, ec);}
+std::size_t writable_pipe::write_some(std::span<const const_buffer> buffers) {return impl_.write_some(buffers);}
+std::size_t writable_pipe::write_some(std::span<const const_buffer> buffers, asio::error_code& ec) {return impl_.write_some(buffers, ec);}
 void writable_pipe::async_write_some_impl(asio::const_buffer buffer, handler_type<void(std::error_code, std::size_t)> && h) {return impl_.async_write_some(buffer, std::move(h));}
+void writable_pipe::async_write_some_impl(std::span<const asio::const_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h) {return impl_.async_write_some(buffers, std::move(h));}
 
 auto writable_pipe::get_executor() -> executor_type {return impl_.get_executor();}
 
@@ -7,6 +7,7 @@
 
 #include <asio/write.hpp>
 #include <pio/write.hpp>
+#include "detail/transfer_op.hpp"
 
 namespace pio
 {
@@ -15,6 +16,10 @@ std::size_t write(concepts::sync_write_stream& s, const asio::const_buffer& buff
 std::size_t write(concepts::sync_write_stream& s, const asio::const_buffer& buffers, asio::error_code& ec)                                               {return asio::write(s, buffers, ec);}
 std::size_t write(concepts::sync_write_stream& s, const asio::const_buffer& buffers, completion_condition_t completion_condition)                        {return asio::write(s, buffers, std::move(completion_condition));}
 std::size_t write(concepts::sync_write_stream& s, const asio::const_buffer& buffers, completion_condition_t completion_condition, asio::error_code& ec)  {return asio::write(s, buffers, std::move(completion_condition), ec);}
+std::size_t write(concepts::sync_write_stream& s, std::span<const asio::const_buffer> buffers)                                                                      {return asio::write(s, buffers);}
+std::size_t write(concepts::sync_write_stream& s, std::span<const asio::const_buffer> buffers, asio::error_code& ec)                                                {return asio::write(s, buffers, ec);}
+std::size_t write(concepts::sync_write_stream& s, std::span<const asio::const_buffer> buffers, completion_condition_t completion_condition)                         {return asio::write(s, buffers, std::move(completion_condition));}
+std::size_t write(concepts::sync_write_stream& s, std::span<const asio::const_buffer> buffers, completion_condition_t completion_condition, asio::error_code& ec)   {return asio::write(s, buffers, std::move(completion_condition), ec);}
 std::size_t write(concepts::sync_write_stream& s, dynamic_buffer buffers)                                                                                {return asio::write(s, std::move(buffers));}
 std::size_t write(concepts::sync_write_stream& s, dynamic_buffer buffers, asio::error_code& ec)                                                          {return asio::write(s, std::move(buffers), ec);}
 std::size_t write(concepts::sync_write_stream& s, dynamic_buffer buffers, completion_condition_t completion_condition)                                   {return asio::write(s, std::move(buffers), std::move(completion_condition));}
@@ -23,16 +28,56 @@ std::size_t write(concepts::sync_write_stream& s, asio::streambuf & buffers)
 std::size_t write(concepts::sync_write_stream& s, asio::streambuf & buffers, asio::error_code& ec)                                                       {return asio::write(s, buffers, ec);}
 std::size_t write(concepts::sync_write_stream& s, asio::streambuf & buffers, completion_condition_t completion_condition)                                {return asio::write(s, buffers, std::move(completion_condition));}
 std::size_t write(concepts::sync_write_stream& s, asio::streambuf & buffers, completion_condition_t completion_condition, asio::error_code& ec)          {return asio::write(s, buffers, std::move(completion_condition), ec);}
+std::size_t write(concepts::sync_write_stream& s, segmented_buffer & buffers)                                                                            {return write(s, buffers, transfer_all());}
+std::size_t write(concepts::sync_write_stream& s, segmented_buffer & buffers, asio::error_code& ec)                                                      {return write(s, buffers, transfer_all(), ec);}
+
+std::size_t write(concepts::sync_write_stream& s, segmented_buffer & buffers, completion_condition_t completion_condition)
+{
+    asio::error_code ec;
+    auto n = write(s, buffers, std::move(completion_condition), ec);
+    asio::detail::throw_error(ec, "write");
+    return n;
+}
+
+std::size_t write(concepts::sync_write_stream& s, segmented_buffer & buffers, completion_condition_t completion_condition, asio::error_code& ec)
+{
+    ec.clear();
+    std::size_t total = 0u;
+    std::array<const_buffer, 64u> gathered;
+    auto max_size = (std::min)(completion_condition(ec, total), buffers.size());
+    while (max_size > 0u)
+    {
+        std::size_t count = 0u;
+        for (const auto & b : buffers.data())
+        {
+            if (count == gathered.size() || max_size == 0u)
+                break;
+            gathered[count] = asio::buffer(b, max_size);
+            max_size -= gathered[count++].size();
+        }
+        const auto transferred = s.write_some(std::span<const const_buffer>(gathered.data(), count), ec);
+        buffers.consume(transferred);
+        total += transferred;
+        max_size = (std::min)(completion_condition(ec, total), buffers.size());
+    }
+    return total;
+}
 
 namespace detail
 {
-void async_write_impl(concepts::async_write_stream& s, const asio::const_buffer& buffers,                                              handler_type<void(asio::error_code, std::size_t)> && h) {asio::async_write(s, buffers,                                  std::move(h));}
-void async_write_impl(concepts::async_write_stream& s, const asio::const_buffer& buffers, completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h) {asio::async_write(s, buffers, std::move(completion_condition), std::move(h));}
-void async_write_impl(concepts::async_write_stream& s, pio::dynamic_buffer buffers,                                                    handler_type<void(asio::error_code, std::size_t)> && h) {asio::async_write(s, std::move(buffers),                                  std::move(h));}
-void async_write_impl(concepts::async_write_stream& s, pio::dynamic_buffer buffers,       completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h) {asio::async_write(s, std::move(buffers), std::move(completion_condition), std::move(h));}
-void async_write_impl(concepts::async_write_stream& s, asio::streambuf &buffers,                                                       handler_type<void(asio::error_code, std::size_t)> && h) {asio::async_write(s, buffers,                                  std::move(h));}
-void async_write_impl(concepts::async_write_stream& s, asio::streambuf &buffers,          completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h) {asio::async_write(s, buffers, std::move(completion_condition), std::move(h));}
+void async_write_impl(concepts::async_write_stream& s, const asio::const_buffer& buffers,                                              handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(buffer_step<write_some_op, const_buffer>{{s}, buffers},                                                  transfer_all(),            std::move(h));}
+void async_write_impl(concepts::async_write_stream& s, const asio::const_buffer& buffers, completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(buffer_step<write_some_op, const_buffer>{{s}, buffers},                                                  std::move(completion_condition), std::move(h));}
+void async_write_impl(concepts::async_write_stream& s, std::span<const asio::const_buffer> buffers,                                              handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(buffer_sequence_step<write_some_op, const_buffer>{{s}, buffers},              transfer_all(),            std::move(h));}
+void async_write_impl(concepts::async_write_stream& s, std::span<const asio::const_buffer> buffers, completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(buffer_sequence_step<write_some_op, const_buffer>{{s}, buffers},              std::move(completion_condition), std::move(h));}
+void async_write_impl(concepts::async_write_stream& s, pio::dynamic_buffer buffers,                                                    handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(write_dynamic_step<write_some_op, pio::dynamic_buffer>{{{s}, buffers.data(0u, buffers.size())}, std::move(buffers)}, transfer_all(),            std::move(h));}
+void async_write_impl(concepts::async_write_stream& s, pio::dynamic_buffer buffers,       completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(write_dynamic_step<write_some_op, pio::dynamic_buffer>{{{s}, buffers.data(0u, buffers.size())}, std::move(buffers)}, std::move(completion_condition), std::move(h));}
+void async_write_impl(concepts::async_write_stream& s, asio::streambuf &buffers,                                                       handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(write_dynamic_step<write_some_op, asio::streambuf&>{{{s}, buffers.data()}, buffers},                     transfer_all(),            std::move(h));}
+void async_write_impl(concepts::async_write_stream& s, asio::streambuf &buffers,          completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(write_dynamic_step<write_some_op, asio::streambuf&>{{{s}, buffers.data()}, buffers},                     std::move(completion_condition), std::move(h));}
+void async_write_impl(concepts::async_write_stream& s, segmented_buffer &buffers,                                                      handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(write_segmented_step<write_some_op>{{s}, buffers},                                                    transfer_all(),            std::move(h));}
+void async_write_impl(concepts::async_write_stream& s, segmented_buffer &buffers,         completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(write_segmented_step<write_some_op>{{s}, buffers},                                                    std::move(completion_condition), std::move(h));}
+void async_write_impl(concepts::async_write_stream& s, shared_buffer buffer,                                                           handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(shared_buffer_step<write_some_op>{{s}, std::move(buffer)},                                           transfer_all(),            std::move(h));}
+void async_write_impl(concepts::async_write_stream& s, shared_buffer buffer,              completion_condition_t completion_condition, handler_type<void(asio::error_code, std::size_t)> && h) {start_transfer(shared_buffer_step<write_some_op>{{s}, std::move(buffer)},                                           std::move(completion_condition), std::move(h));}
 
 }
 
-}
\ No newline at end of file
+}
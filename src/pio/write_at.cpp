@@ -7,6 +7,7 @@
 
 #include <asio/write_at.hpp>
 #include <pio/write_at.hpp>
+#include "detail/transfer_op.hpp"
 
 namespace pio
 {
@@ -39,6 +40,33 @@ std::size_t write_at(concepts::sync_random_access_write_device& d,
     return asio::write_at(d, offset, buffers, std::move(completion_condition), ec);
 }
 
+std::size_t write_at(concepts::sync_random_access_write_device& d,
+                     uint64_t offset, std::span<const const_buffer> buffers)
+{
+    return asio::write_at(d, offset, buffers);
+}
+
+std::size_t write_at(concepts::sync_random_access_write_device& d,
+                     uint64_t offset, std::span<const const_buffer> buffers,
+                     asio::error_code& ec)
+{
+    return asio::write_at(d, offset, buffers, ec);
+}
+
+std::size_t write_at(concepts::sync_random_access_write_device& d,
+                     uint64_t offset, std::span<const const_buffer> buffers,
+                     completion_condition_t completion_condition)
+{
+    return asio::write_at(d, offset, buffers, std::move(completion_condition));
+}
+
+std::size_t write_at(concepts::sync_random_access_write_device& d,
+                     uint64_t offset, std::span<const const_buffer> buffers,
+                     completion_condition_t completion_condition, asio::error_code& ec)
+{
+    return asio::write_at(d, offset, buffers, std::move(completion_condition), ec);
+}
+
 std::size_t write_at(concepts::sync_random_access_write_device& d,
                      uint64_t offset, asio::streambuf& b)
 {
@@ -71,15 +99,37 @@ void async_write_at_impl(
         concepts::async_random_access_write_device& d, std::uint64_t offset,
         const const_buffer & buffers, handler_type<void(asio::error_code, std::size_t)> && h)
 {
-    asio::async_write_at(d, offset, buffers, std::move(h));
+    start_transfer(buffer_step<write_some_at_op, const_buffer>{{d, offset}, buffers}, transfer_all(), std::move(h));
+}
+
+void async_write_at_impl(
+        concepts::async_random_access_write_device& d, std::uint64_t offset,
+        const const_buffer & buffers, completion_condition_t completion_condition,
+        handler_type<void(asio::error_code, std::size_t)> && h)
+{
+    start_transfer(buffer_step<write_some_at_op, const_buffer>{{d, offset}, buffers}, std::move(completion_condition), std::move(h));
 }
 
+void async_write_at_impl(
+        concepts::async_random_access_write_device& d, std::uint64_t offset,
+        std::span<const const_buffer> buffers, handler_type<void(asio::error_code, std::size_t)> && h)
+{
+    start_transfer(buffer_sequence_step<write_some_at_op, const_buffer>{{d, offset}, buffers}, transfer_all(), std::move(h));
+}
+
+void async_write_at_impl(
+        concepts::async_random_access_write_device& d, std::uint64_t offset,
+        std::span<const const_buffer> buffers, completion_condition_t completion_condition,
+        handler_type<void(asio::error_code, std::size_t)> && h)
+{
+    start_transfer(buffer_sequence_step<write_some_at_op, const_buffer>{{d, offset}, buffers}, std::move(completion_condition), std::move(h));
+}
 
 void async_write_at_impl(
         concepts::async_random_access_write_device& d, std::uint64_t offset,
         asio::streambuf& b, handler_type<void(asio::error_code, std::size_t)> && h)
 {
-    asio::async_write_at(d, offset, b, std::move(h));
+    start_transfer(write_dynamic_step<write_some_at_op, asio::streambuf&>{{{d, offset}, b.data()}, b}, transfer_all(), std::move(h));
 }
 
 void async_write_at_impl(
@@ -87,10 +137,24 @@ void async_write_at_impl(
         asio::streambuf& b, completion_condition_t completion_condition,
         handler_type<void(asio::error_code, std::size_t)> && h)
 {
-    asio::async_write_at(d, offset, b, std::move(completion_condition), std::move(h));
+    start_transfer(write_dynamic_step<write_some_at_op, asio::streambuf&>{{{d, offset}, b.data()}, b}, std::move(completion_condition), std::move(h));
+}
+
+void async_write_at_impl(
+        concepts::async_random_access_write_device& d, std::uint64_t offset,
+        shared_buffer buffer, handler_type<void(asio::error_code, std::size_t)> && h)
+{
+    start_transfer(shared_buffer_step<write_some_at_op>{{d, offset}, std::move(buffer)}, transfer_all(), std::move(h));
+}
 
+void async_write_at_impl(
+        concepts::async_random_access_write_device& d, std::uint64_t offset,
+        shared_buffer buffer, completion_condition_t completion_condition,
+        handler_type<void(asio::error_code, std::size_t)> && h)
+{
+    start_transfer(shared_buffer_step<write_some_at_op>{{d, offset}, std::move(buffer)}, std::move(completion_condition), std::move(h));
 }
 
 }
 
-}
\ No newline at end of file
+}
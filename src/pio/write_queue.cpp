@@ -0,0 +1,163 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <pio/write_queue.hpp>
+#include <pio/write.hpp>
+#include "detail/handler_state.hpp"
+#include "detail/mpsc_queue.hpp"
+
+#include <asio/post.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory_resource>
+#include <vector>
+
+namespace pio
+{
+
+namespace detail
+{
+
+using write_handler_t = handler_type<void(std::error_code, std::size_t)>;
+
+// A queued write, allocated with the handler's allocator.
+struct write_queue_node : mpsc_node, handler_state<void(std::error_code, std::size_t)>
+{
+    write_queue_node(std::span<const const_buffer> buffers, write_handler_t && h)
+        : handler_state(std::move(h)), more(allocator.resource())
+    {
+        if (buffers.size() == 1u)
+            single = buffers.front();
+        else
+            more.assign(buffers.begin(), buffers.end());
+        size = asio::buffer_size(buffers);
+    }
+
+    std::span<const const_buffer> buffers() const
+    {
+        if (more.empty())
+            return std::span<const const_buffer>(&single, 1u);
+        return more;
+    }
+
+    const_buffer single;
+    std::pmr::vector<const_buffer> more;
+    std::size_t size;
+};
+
+struct write_queue_state
+{
+    write_queue_state(concepts::async_write_stream & stream, std::size_t max_gather)
+        : stream(stream), max_gather(std::max<std::size_t>(max_gather, 1u))
+    {
+    }
+
+    concepts::async_write_stream & stream;
+    const std::size_t max_gather;
+
+    mpsc_queue<write_queue_node> queue;
+    // the writes pushed, but not completed. the producer that increments it from zero starts the consumer.
+    std::atomic<std::size_t> pending{0u};
+
+    // consumer only
+    std::vector<write_queue_node*> batch;
+    std::vector<const_buffer> gathered;
+};
+
+namespace
+{
+
+void drain(write_queue_state & st);
+
+void complete(write_queue_node * n, std::error_code ec, std::size_t written)
+{
+    auto h = std::move(n->handler);
+    delete_handler_state(n);
+
+    post_completion(std::move(h), ec, written);
+}
+
+struct write_done_op
+{
+    write_queue_state * st;
+
+    void operator()(std::error_code ec, std::size_t n)
+    {
+        const auto taken = st->batch.size();
+        // hand out the written bytes in order, the ones after an error get nothing.
+        for (auto node : st->batch)
+        {
+            const auto written = std::min(n, node->size);
+            n -= written;
+            complete(node, written == node->size ? std::error_code{} : ec, written);
+        }
+        st->batch.clear();
+
+        if (st->pending.fetch_sub(taken, std::memory_order_acq_rel) > taken)
+            drain(*st);
+    }
+};
+
+void drain(write_queue_state & st)
+{
+    assert(st.batch.empty());
+    st.gathered.clear();
+
+    while (st.gathered.size() < st.max_gather)
+    {
+        auto node = st.queue.pop();
+        if (!node)
+            break;
+        st.batch.push_back(node);
+        const auto bufs = node->buffers();
+        st.gathered.insert(st.gathered.end(), bufs.begin(), bufs.end());
+    }
+
+    if (st.batch.empty())
+    {
+        // a producer is in the middle of a push, try again once it's done.
+        auto exec = st.stream.get_executor();
+        return asio::post(exec, [&st] {drain(st);});
+    }
+
+    pio::async_write(st.stream, std::span<const const_buffer>(st.gathered), write_done_op{&st});
+}
+
+}
+
+}
+
+write_queue::write_queue(concepts::async_write_stream & stream, std::size_t max_gather)
+    : state_(std::make_unique<detail::write_queue_state>(stream, max_gather))
+{
+}
+
+write_queue::~write_queue()
+{
+    assert(state_->pending.load() == 0u);
+}
+
+auto write_queue::get_executor() -> executor_type
+{
+    return state_->stream.get_executor();
+}
+
+void write_queue::async_write_impl(std::span<const const_buffer> buffers, handler_type<void(std::error_code, std::size_t)> && h)
+{
+    auto node = detail::new_handler_state<detail::write_queue_node>(std::move(h), buffers);
+    state_->queue.push(node);
+
+    if (state_->pending.fetch_add(1u, std::memory_order_acq_rel) == 0u)
+    {
+        auto & st = *state_;
+        asio::post(st.stream.get_executor(), [&st] {detail::drain(st);});
+    }
+}
+
+}
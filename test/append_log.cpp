@@ -0,0 +1,65 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+
+#include <pio.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+TEST_CASE("append_log")
+{
+    asio::io_context ctx;
+    const auto path = (std::filesystem::current_path() / "pio_append_log_test").string();
+
+    pio::random_access_file f{ctx.get_executor(), path,
+                              pio::random_access_file::read_write | pio::random_access_file::create | pio::random_access_file::truncate};
+    pio::append_log log{f};
+
+    constexpr std::size_t records = 100u;
+    std::vector<std::string> data;
+    for (std::size_t i = 0u; i < records; i++)
+        data.push_back("record-" + std::to_string(i) + ";");
+
+    std::size_t done = 0u;
+    std::uint64_t expected = 0u;
+    for (auto & d : data)
+    {
+        log.async_append(asio::buffer(d),
+                         [&, offset = expected](std::error_code ec, std::uint64_t off)
+                         {
+                             CHECK(!ec);
+                             CHECK(off == offset);
+                             // everything before this record is durable, too.
+                             CHECK(log.durable_size() >= off + d.size());
+                             done++;
+                         });
+        expected += d.size();
+    }
+    CHECK(log.size() == expected);
+
+    ctx.run();
+    CHECK(done == records);
+    CHECK(log.durable_size() == expected);
+    // the appends are grouped into fewer syncs.
+    CHECK(log.syncs() >= 1u);
+    CHECK(log.syncs() < records);
+
+    std::string content(expected, '\0');
+    CHECK(pio::read_at(f, 0u, asio::buffer(content)) == expected);
+    std::string joined;
+    for (auto & d : data)
+        joined += d;
+    CHECK(content == joined);
+
+    f.close();
+    std::filesystem::remove(path);
+}
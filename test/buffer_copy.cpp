@@ -0,0 +1,82 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+
+#include <pio.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+
+std::vector<unsigned char> pattern(std::size_t n)
+{
+    std::vector<unsigned char> res(n);
+    for (std::size_t i = 0u; i < n; i++)
+        res[i] = static_cast<unsigned char>(i * 7u + 3u);
+    return res;
+}
+
+}
+
+TEST_CASE("buffer_copy")
+{
+    // small, rep movsb & non-temporal sizes, with a misaligned target.
+    for (std::size_t n : {0u, 100u, 4000u, 3u * 1024u * 1024u})
+    {
+        CAPTURE(n);
+        const auto source = pattern(n);
+        std::vector<unsigned char> target(n + 1u);
+
+        CHECK(pio::buffer_copy(pio::mutable_buffer(target.data() + 1u, n), asio::buffer(source)) == n);
+        CHECK(std::equal(source.begin(), source.end(), target.begin() + 1));
+
+        std::vector<pio::const_buffer> sources;
+        for (std::size_t pos = 0u; pos < n; pos += 777u)
+            sources.push_back(asio::buffer(source.data() + pos, (std::min)(std::size_t(777u), n - pos)));
+        std::vector<pio::mutable_buffer> targets;
+        for (std::size_t pos = 0u; pos < n; pos += 5000u)
+            targets.push_back(asio::buffer(target.data() + pos, (std::min)(std::size_t(5000u), n - pos)));
+
+        CHECK(pio::buffer_copy(targets, sources) == n);
+        CHECK(std::equal(source.begin(), source.end(), target.begin()));
+
+        std::vector<unsigned char> gathered(n / 2u);
+        CHECK(pio::buffer_copy(asio::buffer(gathered), sources) == gathered.size());
+        CHECK(std::equal(gathered.begin(), gathered.end(), source.begin()));
+    }
+
+    SUBCASE("segmented_buffer")
+    {
+        const auto source = pattern(10000u);
+        pio::segmented_buffer seg{4096u};
+        seg.commit(pio::buffer_copy(seg.prepare(source.size()), asio::buffer(source)));
+        CHECK(seg.size() == source.size());
+
+        std::vector<unsigned char> target(source.size());
+        CHECK(pio::buffer_copy(asio::buffer(target), seg.data()) == source.size());
+        CHECK(target == source);
+    }
+
+#if !defined(ASIO_WINDOWS)
+    SUBCASE("ring_buffer")
+    {
+        pio::ring_buffer ring{4096u};
+        const auto source = pattern(ring.capacity() / 2u);
+        // wrap the writable region around the end.
+        ring.commit(ring.capacity() - 8u);
+        ring.consume(ring.capacity() - 8u);
+
+        ring.commit(pio::buffer_copy(ring.prepare(source.size()), asio::buffer(source)));
+        std::vector<unsigned char> target(source.size());
+        CHECK(pio::buffer_copy(asio::buffer(target), ring.data()) == source.size());
+        CHECK(target == source);
+    }
+#endif
+}
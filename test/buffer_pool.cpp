@@ -0,0 +1,104 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+
+#include <pio.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <string_view>
+
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+#include <fcntl.h>
+#endif
+
+TEST_CASE("buffer_pool")
+{
+    pio::buffer_pool pool{256u, 2u};
+    CHECK(pool.available() == 2u);
+
+    auto b1 = pool.try_acquire();
+    auto b2 = pool.try_acquire();
+    REQUIRE(b1);
+    REQUIRE(b2);
+    CHECK(b1.capacity() == 256u);
+    CHECK(b1.empty());
+    CHECK(!pool.try_acquire());
+
+    b1.release();
+    CHECK(pool.available() == 1u);
+    b2 = pool.try_acquire();
+    CHECK(pool.available() == 1u);
+}
+
+TEST_CASE("buffer_pool leased pipe read")
+{
+    asio::io_context ctx;
+    pio::readable_pipe r{ctx};
+    pio::writable_pipe w{ctx};
+    pio::connect_pipe(r, w);
+
+    pio::buffer_pool pool{4096u, 1u};
+    pio::leased_buffer result;
+    bool done = false;
+    r.async_read_some(pool,
+                      [&](std::error_code ec, pio::leased_buffer b)
+                      {
+                          CHECK(!ec);
+                          result = std::move(b);
+                          done = true;
+                      });
+
+    // nothing to read, so no block is leased.
+    ctx.poll();
+    CHECK(!done);
+    CHECK(pool.available() == 1u);
+
+    pio::write(w, asio::buffer("Test\n", 5));
+    ctx.run();
+
+    REQUIRE(done);
+    CHECK(pool.available() == 0u);
+    CHECK(std::string_view(static_cast<const char*>(result.data().data()), result.size()) == "Test\n");
+    result.release();
+    CHECK(pool.available() == 1u);
+}
+
+#if defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR)
+
+TEST_CASE("buffer_pool leased pipe read after move")
+{
+    asio::io_context ctx;
+    pio::readable_pipe r{ctx};
+    pio::writable_pipe w{ctx};
+    pio::connect_pipe(r, w);
+
+    pio::buffer_pool pool{4096u, 1u};
+    pio::leased_buffer result;
+    bool done = false;
+    r.async_read_some(pool,
+                      [&](std::error_code ec, pio::leased_buffer b)
+                      {
+                          CHECK(!ec);
+                          result = std::move(b);
+                          done = true;
+                      });
+    ctx.poll();
+
+    // the read in flight doesn't refer to the moved-from pipe.
+    pio::readable_pipe moved{std::move(r)};
+    pio::write(w, asio::buffer("Test\n", 5));
+    ctx.run();
+
+    REQUIRE(done);
+    CHECK(result.size() == 5u);
+    // the pipe is still blocking, the waiting duplicate didn't set O_NONBLOCK.
+    CHECK(!(::fcntl(moved.native_handle(), F_GETFL) & O_NONBLOCK));
+}
+
+#endif
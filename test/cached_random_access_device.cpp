@@ -0,0 +1,86 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+
+#include <pio.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+TEST_CASE("cached_random_access_device")
+{
+    asio::io_context ctx;
+    const auto path = (std::filesystem::temp_directory_path() / "pio_cached_random_access_device").string();
+
+    std::string data;
+    for (int i = 0; i < 1000; i++)
+        data += std::to_string(i);
+
+    pio::random_access_file f{ctx.get_executor(), path, pio::random_access_file::read_write | pio::random_access_file::create | pio::random_access_file::truncate};
+    pio::write_at(f, 0u, asio::buffer(data));
+
+    pio::cached_random_access_device::options opts;
+    opts.block_size = 64u;
+    opts.capacity = 64u * 8u;
+    opts.shards = 2u;
+
+    SUBCASE("clock") {opts.policy = pio::cached_random_access_device::eviction::clock;}
+    SUBCASE("s3_fifo") {opts.policy = pio::cached_random_access_device::eviction::s3_fifo;}
+    // clamped to the 8 blocks, otherwise every shard would hold a block.
+    SUBCASE("more shards than blocks") {opts.shards = 32u;}
+
+    pio::cached_random_access_device c{f, opts};
+
+    // concurrent misses on one block read it once.
+    char a[10], b[10];
+    c.async_read_some_at(3u, asio::buffer(a), [](std::error_code ec, std::size_t n) {CHECK(!ec); CHECK(n == 10u);});
+    c.async_read_some_at(20u, asio::buffer(b), [](std::error_code ec, std::size_t n) {CHECK(!ec); CHECK(n == 10u);});
+    ctx.run();
+    CHECK(std::string_view(a, 10u) == data.substr(3u, 10u));
+    CHECK(std::string_view(b, 10u) == data.substr(20u, 10u));
+    auto st = c.stats();
+    CHECK(st.misses == 1u);
+    CHECK(st.coalesced == 1u);
+    CHECK(st.hits == 0u);
+
+    // reads are short at block boundaries, read_at fills the whole buffer.
+    c.async_read_some_at(60u, asio::buffer(a), [](std::error_code ec, std::size_t n) {CHECK(!ec); CHECK(n == 4u);});
+    ctx.restart();
+    ctx.run();
+    CHECK(c.stats().hits == 1u);
+
+    std::string result(data.size(), '\0');
+    std::size_t read = 0u;
+    pio::async_read_at(c, 0u, asio::buffer(result), [&](std::error_code ec, std::size_t n) {CHECK(!ec); read = n;});
+    ctx.restart();
+    ctx.run();
+    CHECK(read == data.size());
+    CHECK(result == data);
+
+    // bounded to 8 blocks, the file has more.
+    st = c.stats();
+    CHECK(st.size <= opts.capacity);
+    CHECK(st.evictions > 0u);
+
+    std::error_code error;
+    c.async_read_some_at(data.size(), asio::buffer(a), [&](std::error_code ec, std::size_t) {error = ec;});
+    ctx.restart();
+    ctx.run();
+    CHECK(error == asio::error::eof);
+
+    c.invalidate();
+    CHECK(c.stats().size == 0u);
+    c.reset_stats();
+    CHECK(c.stats().misses == 0u);
+
+    f.close();
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+
+#include <pio.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <string_view>
+
+TEST_CASE("coalescing_write_stream")
+{
+    asio::io_context ctx;
+    pio::readable_pipe r{ctx};
+    pio::writable_pipe w{ctx};
+    pio::connect_pipe(r, w);
+
+    pio::coalescing_write_stream::options opts;
+    opts.capacity = 16u;
+    opts.delay = {};
+
+    SUBCASE("on_enqueue")
+    {
+        pio::coalescing_write_stream s{w, opts};
+        std::size_t written = 0u;
+        for (int i = 0; i < 5; i++)
+            pio::async_write(s, asio::buffer("abc", 3), [&](std::error_code ec, std::size_t n) {CHECK(!ec); written += n;});
+        ctx.run();
+        CHECK(written == 15u);
+        CHECK(s.buffered() == 15u);
+
+        bool flushed = false;
+        s.async_flush([&](std::error_code ec) {CHECK(!ec); flushed = true;});
+        ctx.restart();
+        ctx.run();
+        CHECK(flushed);
+        CHECK(s.buffered() == 0u);
+
+        char buf[15];
+        CHECK(pio::read(r, asio::buffer(buf)) == 15u);
+        CHECK(std::string_view(buf, 15) == "abcabcabcabcabc");
+    }
+
+    SUBCASE("on_flush")
+    {
+        opts.complete = pio::coalescing_write_stream::completion::on_flush;
+        pio::coalescing_write_stream s{w, opts};
+        std::size_t written = 0u;
+        pio::async_write(s, asio::buffer("0123456789", 10), [&](std::error_code ec, std::size_t n) {CHECK(!ec); written += n;});
+        ctx.run();
+        CHECK(written == 0u);
+
+        // fills the buffer, which starts the flush
+        pio::async_write(s, asio::buffer("ABCDEF", 6), [&](std::error_code ec, std::size_t n) {CHECK(!ec); written += n;});
+        ctx.restart();
+        ctx.run();
+        CHECK(written == 16u);
+
+        char buf[16];
+        CHECK(pio::read(r, asio::buffer(buf)) == 16u);
+        CHECK(std::string_view(buf, 16) == "0123456789ABCDEF");
+    }
+}
+
+TEST_CASE("coalescing_write_stream destroyed with pending writes")
+{
+    asio::io_context ctx;
+    pio::readable_pipe r{ctx};
+    pio::writable_pipe w{ctx};
+    pio::connect_pipe(r, w);
+
+    pio::coalescing_write_stream::options opts;
+    opts.capacity = 16u;
+    opts.delay = {};
+    opts.complete = pio::coalescing_write_stream::completion::on_flush;
+
+    std::error_code flushed_ec, buffered_ec, flush_ec;
+    int called = 0;
+    {
+        pio::coalescing_write_stream s{w, opts};
+        // as large as the buffer, so it is written right away
+        pio::async_write(s, asio::buffer("0123456789ABCDEF", 16), [&](std::error_code ec, std::size_t) {flushed_ec = ec; called++;});
+        // goes into the second buffer, which isn't flushed
+        pio::async_write(s, asio::buffer("abc", 3), [&](std::error_code ec, std::size_t) {buffered_ec = ec; called++;});
+        s.async_flush([&](std::error_code ec) {flush_ec = ec; called++;});
+    }
+    ctx.run();
+    CHECK(called == 3);
+    CHECK(flushed_ec == asio::error::operation_aborted);
+    CHECK(buffered_ec == asio::error::operation_aborted);
+    CHECK(flush_ec == asio::error::operation_aborted);
+}
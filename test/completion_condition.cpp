@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "pio/completion_condition.hpp"
+
+#include "doctest.h"
+
+#include <array>
+#include <memory>
+#include <string>
+
+TEST_CASE("completion_condition")
+{
+    const std::error_code ok{};
+    const std::error_code err = std::make_error_code(std::errc::broken_pipe);
+    constexpr auto max = pio::completion_condition::default_max_transfer_size;
+
+    SUBCASE("transfer_all")
+    {
+        pio::completion_condition cc = pio::transfer_all();
+        CHECK(cc(ok, 0u) == max);
+        CHECK(cc(ok, 1000u) == max);
+        CHECK(cc(err, 0u) == 0u);
+
+        pio::completion_condition from_asio = asio::transfer_all();
+        CHECK(from_asio(ok, 0u) == max);
+    }
+
+    SUBCASE("transfer_at_least")
+    {
+        auto cc = pio::transfer_at_least(10u);
+        CHECK(cc(ok, 0u) == max);
+        CHECK(cc(ok, 10u) == 0u);
+        CHECK(cc(err, 5u) == 0u);
+    }
+
+    SUBCASE("transfer_exactly")
+    {
+        auto cc = pio::transfer_exactly(10u);
+        CHECK(cc(ok, 0u) == 10u);
+        CHECK(cc(ok, 4u) == 6u);
+        CHECK(cc(ok, 10u) == 0u);
+
+        auto big = pio::transfer_exactly(10 * max);
+        CHECK(big(ok, 0u) == max);
+    }
+
+    SUBCASE("custom")
+    {
+        std::size_t calls = 0u;
+        pio::completion_condition cc = [&calls](const std::error_code & ec, std::size_t n) -> std::size_t
+        {
+            calls++;
+            return n < 3u ? 1u : 0u;
+        };
+        auto cpy = cc;
+        CHECK(cpy(ok, 0u) == 1u);
+        CHECK(cc(ok, 3u) == 0u);
+        CHECK(calls == 2u);
+
+        std::array<std::size_t, 8> table{1u, 2u, 3u};
+        pio::completion_condition large = [table](const std::error_code &, std::size_t n) { return n < table.size() ? table[n] : 0u; };
+        auto moved = std::move(large);
+        auto copied = moved;
+        CHECK(moved(ok, 1u) == 2u);
+        CHECK(copied(ok, 2u) == 3u);
+        CHECK(large(ok, 0u) == max); // moved-from is transfer_all
+    }
+
+    SUBCASE("custom non-trivial")
+    {
+        auto limit = std::make_shared<std::size_t>(4u);
+        const std::string name = "a name that is too long for the small string optimization";
+        {
+            pio::completion_condition cc = [limit, name](const std::error_code &, std::size_t n) -> std::size_t
+            {
+                return n < *limit ? name.size() : 0u;
+            };
+            CHECK(limit.use_count() == 2);
+
+            auto copied = cc;
+            CHECK(limit.use_count() == 3);
+            auto moved = std::move(cc);
+            CHECK(limit.use_count() == 3);
+            CHECK(cc(ok, 0u) == max); // moved-from is transfer_all
+
+            pio::completion_condition assigned;
+            assigned = std::move(copied);
+            CHECK(assigned(ok, 0u) == name.size());
+            CHECK(moved(ok, 4u) == 0u);
+        }
+        CHECK(limit.use_count() == 1);
+    }
+}
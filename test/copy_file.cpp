@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+#include "counting_allocator.hpp"
+
+#include <pio.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+TEST_CASE("copy_file")
+{
+    asio::io_context ctx;
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto src_path = (dir / "pio_copy_file_src").string(),
+               dst_path = (dir / "pio_copy_file_dst").string();
+
+    std::string data;
+    for (int i = 0; i < 10000; i++)
+        data += std::to_string(i);
+
+    pio::random_access_file src{ctx.get_executor(), src_path, pio::random_access_file::read_write | pio::random_access_file::create | pio::random_access_file::truncate};
+    pio::random_access_file dst{ctx.get_executor(), dst_path, pio::random_access_file::read_write | pio::random_access_file::create | pio::random_access_file::truncate};
+    CHECK(pio::write_at(src, 0u, asio::buffer(data)) == data.size());
+
+    std::uint64_t copied = 0u, last_progress = 0u;
+    pio::copy_file_options opts;
+    opts.progress = [&](std::uint64_t n) {CHECK(n > last_progress); last_progress = n;};
+
+    SUBCASE("kernel")
+    {
+        opts.kernel_chunk_size = 4096u;
+    }
+
+    SUBCASE("user space")
+    {
+        // the fallback is also used across filesystems, this forces it through tiny chunks.
+        opts.reflink = false;
+        opts.kernel_chunk_size = 0u;
+        opts.chunk_size = 1000u;
+        opts.queue_depth = 3u;
+    }
+
+    // the state & the lanes are allocated with the handler's allocator.
+    std::size_t live = 0u;
+    pio::async_copy_file(src, dst, 10u, 20u, data.size() - 10u, std::move(opts),
+                         with_counting_allocator(live, [&](std::error_code ec, std::uint64_t n) {CHECK(!ec); copied = n;}));
+    CHECK(live > 0u);
+    ctx.run();
+    CHECK(live == 0u);
+    CHECK(copied == data.size() - 10u);
+    CHECK(last_progress == copied);
+
+    std::vector<char> result(copied);
+    CHECK(pio::read_at(dst, 20u, asio::buffer(result)) == copied);
+    CHECK(std::string(result.begin(), result.end()) == data.substr(10u));
+
+    // the source is shorter than requested
+    copied = 0u;
+    std::error_code error;
+    ctx.restart();
+    pio::async_copy_file(src, dst, data.size() - 5u, 0u, 100u,
+                         [&](std::error_code ec, std::uint64_t n) {error = ec; copied = n;});
+    ctx.run();
+    CHECK(error == asio::error::eof);
+    CHECK(copied == 5u);
+
+    src.close();
+    dst.close();
+    std::filesystem::remove(src_path);
+    std::filesystem::remove(dst_path);
+}
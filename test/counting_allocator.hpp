@@ -0,0 +1,64 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef COUNTING_ALLOCATOR_HPP
+#define COUNTING_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// an allocator that counts the allocations it owns, to check that composed operations use & release it.
+template<typename T>
+struct counting_allocator
+{
+    using value_type = T;
+    std::size_t * live;
+
+    explicit counting_allocator(std::size_t * live) : live(live) {}
+    template<typename U>
+    counting_allocator(const counting_allocator<U> & lhs) : live(lhs.live) {}
+
+    T * allocate(std::size_t n)
+    {
+        ++*live;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T * p, std::size_t n)
+    {
+        --*live;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template<typename U>
+    bool operator==(const counting_allocator<U> & lhs) const {return live == lhs.live;}
+};
+
+// a handler with a custom associated allocator, like one wrapped with asio::bind_allocator.
+template<typename Handler>
+struct counting_handler
+{
+    Handler handler;
+    std::size_t * live;
+
+    using allocator_type = counting_allocator<void>;
+    allocator_type get_allocator() const noexcept {return allocator_type{live};}
+
+    template<typename ... Args>
+    void operator()(Args && ... args)
+    {
+        handler(std::forward<Args>(args)...);
+    }
+};
+
+template<typename Handler>
+counting_handler<std::decay_t<Handler>> with_counting_allocator(std::size_t & live, Handler && handler)
+{
+    return {std::forward<Handler>(handler), &live};
+}
+
+#endif //COUNTING_ALLOCATOR_HPP
@@ -0,0 +1,132 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+
+#include <pio.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+TEST_CASE("io_alignment")
+{
+    pio::io_alignment buffered;
+    CHECK(!buffered.required());
+    CHECK(buffered.check(3u, reinterpret_cast<const void*>(0x1001), 7u));
+
+    pio::io_alignment direct{512u, 4096u};
+    CHECK(direct.required());
+    CHECK( direct.check(8192u, reinterpret_cast<const void*>(0x200), 4096u));
+    CHECK(!direct.check(8192u, reinterpret_cast<const void*>(0x201), 4096u));
+    CHECK(!direct.check(100u,  reinterpret_cast<const void*>(0x200), 4096u));
+    CHECK(!direct.check(8192u, reinterpret_cast<const void*>(0x200), 100u));
+
+    std::vector<unsigned char, pio::aligned_allocator<unsigned char>> buf(8192u, pio::aligned_allocator<unsigned char>(4096u));
+    CHECK(reinterpret_cast<std::uintptr_t>(buf.data()) % 4096u == 0u);
+
+    const pio::const_buffer bufs[2] = {pio::const_buffer(buf.data(), 4096u), pio::const_buffer(buf.data() + 4096u, 4096u)};
+    CHECK(direct.check(0u, bufs));
+    const pio::const_buffer bad[2] = {pio::const_buffer(buf.data(), 4096u), pio::const_buffer(buf.data() + 4096u, 10u)};
+    CHECK(!direct.check(0u, bad));
+
+    pio::buffer_pool pool{1000u, 4u, 4096u};
+    CHECK(pool.block_size() == 4096u);
+    auto lb = pool.try_acquire();
+    CHECK(reinterpret_cast<std::uintptr_t>(lb.prepare().data()) % 4096u == 0u);
+}
+
+#if defined(__linux__)
+
+TEST_CASE("random_access_file direct")
+{
+    asio::io_context ctx;
+    const auto path = (std::filesystem::current_path() / "pio_direct_io_test").string();
+
+    // not every filesystem supports O_DIRECT, e.g. older tmpfs.
+    std::error_code ec;
+    pio::random_access_file f{ctx.get_executor()};
+    try
+    {
+        f = pio::random_access_file{ctx.get_executor(), path,
+                                    pio::random_access_file::read_write | pio::random_access_file::create | pio::random_access_file::truncate,
+                                    pio::direct_io};
+    }
+    catch (std::system_error &)
+    {
+        std::filesystem::remove(path);
+        return;
+    }
+
+    const auto al = f.alignment();
+    CHECK(al.required());
+
+    pio::buffer_pool pool{al.offset, 1u, al.memory};
+    auto lb = pool.try_acquire();
+    const auto mb = lb.prepare();
+
+    CHECK(f.write_some_at(0u, mb) == mb.size());
+    f.write_some_at(1u, mb, ec);
+    CHECK(ec == asio::error::invalid_argument);
+
+    std::error_code aec;
+    f.async_read_some_at(0u, pio::mutable_buffer(static_cast<char*>(mb.data()) + 1, mb.size() - 1u),
+                         [&](std::error_code e, std::size_t) {aec = e;});
+    ctx.run();
+    CHECK(aec == asio::error::invalid_argument);
+
+    lb.release();
+    f.close();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("random_access_file direct unaligned size")
+{
+    asio::io_context ctx;
+    const auto path = (std::filesystem::current_path() / "pio_direct_io_unaligned_test").string();
+    const std::string data(5000u, 'x');
+    std::ofstream{path, std::ios::binary} << data;
+
+    pio::random_access_file f{ctx.get_executor()};
+    try
+    {
+        f = pio::random_access_file{ctx.get_executor(), path, pio::random_access_file::read_only, pio::direct_io};
+    }
+    catch (std::system_error &)
+    {
+        std::filesystem::remove(path);
+        return;
+    }
+
+    const auto al = f.alignment();
+    pio::buffer_pool pool{2u * al.offset + data.size(), 1u, al.memory};
+    auto lb = pool.try_acquire();
+    // a whole number of blocks, larger than the file.
+    const auto mb = pio::mutable_buffer(lb.prepare().data(), (data.size() + al.offset) / al.offset * al.offset);
+
+    std::error_code ec;
+    CHECK(pio::read_at(f, 0u, mb, ec) == data.size());
+    CHECK(ec == asio::error::eof);
+
+    std::error_code aec;
+    std::size_t an = 0u;
+    pio::async_read_at(f, 0u, mb, [&](std::error_code e, std::size_t n) {aec = e; an = n;});
+    ctx.run();
+    CHECK(aec == asio::error::eof);
+    CHECK(an == data.size());
+    CHECK(std::string(static_cast<char*>(mb.data()), an) == data);
+
+    lb.release();
+    f.close();
+    std::filesystem::remove(path);
+}
+
+#endif
@@ -0,0 +1,84 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+
+#include <pio.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <array>
+#include <string>
+#include <string_view>
+
+namespace
+{
+
+// a user-defined dynamic buffer over a fixed array.
+struct array_buffer
+{
+    std::array<char, 16> * storage;
+    std::size_t * used;
+
+    using const_buffers_type = pio::const_buffer;
+    using mutable_buffers_type = pio::mutable_buffer;
+
+    std::size_t size() const noexcept {return *used;}
+    std::size_t max_size() const noexcept {return storage->size();}
+    std::size_t capacity() const noexcept {return storage->size();}
+
+    mutable_buffers_type data(std::size_t pos, std::size_t n) noexcept {return asio::buffer(asio::buffer(*storage, *used) + pos, n);}
+    const_buffers_type data(std::size_t pos, std::size_t n) const noexcept {return asio::buffer(asio::buffer(*storage, *used) + pos, n);}
+
+    void grow(std::size_t n) {*used += n;}
+    void shrink(std::size_t n) {*used -= n;}
+    void consume(std::size_t n) {*used -= n;}
+};
+
+}
+
+TEST_CASE("dynamic_buffer")
+{
+    asio::io_context ctx;
+    pio::readable_pipe r{ctx};
+    pio::writable_pipe w{ctx};
+    pio::connect_pipe(r, w);
+
+    SUBCASE("string")
+    {
+        static_assert(pio::detail::dynamic_buffer_stores_inline<decltype(asio::dynamic_buffer(std::declval<std::string&>()))>);
+
+        std::string s;
+        pio::dynamic_buffer db{s};
+        auto copy = db;
+        copy.grow(3u);
+        // copies refer to the same string
+        CHECK(db.size() == 3u);
+        CHECK(s.size() == 3u);
+
+        pio::dynamic_buffer moved{std::move(copy)};
+        moved.shrink(3u);
+        CHECK(s.empty());
+
+        CHECK(pio::write(w, asio::buffer("hello", 5)) == 5u);
+        CHECK(pio::read(r, pio::dynamic_buffer(s, std::size_t(5u))) == 5u);
+        CHECK(s == "hello");
+    }
+
+    SUBCASE("custom")
+    {
+        std::array<char, 16> storage;
+        std::size_t used = 0u;
+        pio::dynamic_buffer db{array_buffer{&storage, &used}};
+        static_assert(pio::detail::dynamic_buffer_stores_inline<array_buffer>);
+
+        CHECK(pio::write(w, asio::buffer("0123456789abcdef", 16)) == 16u);
+        CHECK(pio::read(r, db) == 16u);
+        CHECK(used == 16u);
+        CHECK(std::string_view(storage.data(), used) == "0123456789abcdef");
+    }
+}
@@ -0,0 +1,49 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+
+#include <pio.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <filesystem>
+
+TEST_CASE("async_sync")
+{
+    asio::io_context ctx;
+    const auto path = (std::filesystem::current_path() / "pio_file_sync_test").string();
+
+    pio::random_access_file f{ctx.get_executor(), path,
+                              pio::random_access_file::read_write | pio::random_access_file::create | pio::random_access_file::truncate};
+    CHECK(f.write_some_at(0u, asio::buffer("0123456789", 10)) == 10u);
+
+    // used through the concept, like a log would.
+    pio::concepts::async_syncable_device & dev = f;
+    int done = 0;
+    dev.async_sync([&](std::error_code ec) {CHECK(!ec); done++;});
+    dev.async_data_sync([&](std::error_code ec) {CHECK(!ec); done++;});
+    dev.async_sync_range(0u, 10u, [&](std::error_code ec) {CHECK(!ec); done++;});
+    ctx.run();
+    CHECK(done == 3);
+
+    f.close();
+    std::error_code ec;
+    f.async_sync([&](std::error_code e) {ec = e;});
+    ctx.restart();
+    ctx.run();
+    CHECK(ec == asio::error::bad_descriptor);
+
+    pio::stream_file s{ctx.get_executor(), path, pio::stream_file::write_only};
+    s.async_data_sync([&](std::error_code e) {ec = e;});
+    ctx.restart();
+    ctx.run();
+    CHECK(!ec);
+
+    s.close();
+    std::filesystem::remove(path);
+}
@@ -8,6 +8,7 @@
 #include "pio/handler.hpp"
 
 #include "doctest.h"
+#include "counting_allocator.hpp"
 
 #include <asio.hpp>
 
@@ -26,3 +27,62 @@ TEST_CASE("handler_type")
 
     CHECK(called);
 }
+
+TEST_CASE("handler_type small buffer")
+{
+    asio::io_context ctx;
+    int called = 0;
+    auto small = [&](std::error_code, std::size_t n) {called += static_cast<int>(n);};
+    struct large_t
+    {
+        int & called;
+        char padding[PIO_HANDLER_BUFFER_SIZE];
+        void operator()(std::error_code, std::size_t n) {called += static_cast<int>(n);}
+    };
+
+    CHECK(pio::read_handler::stores_inline<decltype(small)>);
+    CHECK(!pio::read_handler::stores_inline<large_t>);
+
+    pio::read_handler hs{small, ctx.get_executor()};
+    pio::read_handler hl{large_t{called}, ctx.get_executor()};
+
+    auto hs2 = std::move(hs);
+    auto hl2 = std::move(hl);
+    CHECK(!hs);
+    CHECK(!hl);
+    CHECK(hs2);
+    CHECK(hl2);
+
+    hs2(std::error_code{}, 1u);
+    hl2(std::error_code{}, 2u);
+    CHECK(!hs2);
+    CHECK(!hl2);
+    CHECK(called == 3);
+}
+
+TEST_CASE("handler_type allocator after move")
+{
+    asio::io_context ctx;
+    std::size_t live = 0u;
+    bool called = false;
+    auto bound = with_counting_allocator(live, [&](std::error_code) {called = true;});
+    CHECK(pio::wait_handler::stores_inline<decltype(bound)>);
+
+    pio::wait_handler h{std::move(bound), ctx.get_executor()};
+    const auto alloc = h.get_handler_allocator();
+    // the resource returned by get_allocator would move with the handler here.
+    auto moved = std::move(h);
+
+    const pio::handler_allocator copy{alloc};
+    for (auto resource : {alloc.resource(), copy.resource()})
+    {
+        std::pmr::polymorphic_allocator<int> pa{resource};
+        auto p = pa.allocate(4u);
+        CHECK(live == 1u);
+        pa.deallocate(p, 4u);
+        CHECK(live == 0u);
+    }
+
+    moved(std::error_code{});
+    CHECK(called);
+}
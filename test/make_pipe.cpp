@@ -15,6 +15,9 @@
 #include <asio/read.hpp>
 #include <asio/read_until.hpp>
 
+#include <array>
+#include <span>
+
 TEST_CASE("make_pipe")
 {
     asio::io_context ctx;
@@ -31,3 +34,27 @@ TEST_CASE("make_pipe")
 
     CHECK(res == "Test\n");
 }
+
+TEST_CASE("make_pipe vectored")
+{
+    asio::io_context ctx;
+    pio::readable_pipe r{ctx};
+    pio::writable_pipe w{ctx};
+    pio::connect_pipe(r, w);
+
+    const std::array<asio::const_buffer, 3> out{
+        asio::buffer("Head", 4), asio::const_buffer(), asio::buffer("Payload\n", 8)};
+
+    char head[4], body[8];
+    const std::array<asio::mutable_buffer, 2> in{asio::buffer(head), asio::buffer(body)};
+
+    std::size_t written = 0u, read = 0u;
+    pio::async_write(w, std::span(out), [&](asio::error_code ec, std::size_t n) {CHECK(!ec); written = n;});
+    pio::async_read (r, std::span(in),  [&](asio::error_code ec, std::size_t n) {CHECK(!ec); read = n;});
+    ctx.run();
+
+    CHECK(written == 12u);
+    CHECK(read    == 12u);
+    CHECK(std::string_view(head, 4) == "Head");
+    CHECK(std::string_view(body, 8) == "Payload\n");
+}
@@ -0,0 +1,61 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+
+#include <pio.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <filesystem>
+#include <string_view>
+
+#if !defined(ASIO_WINDOWS)
+
+TEST_CASE("mapped_file")
+{
+    asio::io_context ctx;
+    const auto path = (std::filesystem::temp_directory_path() / "pio_mapped_file").string();
+
+    pio::random_access_file f{ctx.get_executor(), path, pio::random_access_file::read_write | pio::random_access_file::create | pio::random_access_file::truncate};
+    pio::write_at(f, 0u, asio::buffer("HelloWorld", 10));
+
+    pio::mapped_file mf{ctx.get_executor(), path};
+    CHECK(mf.size() == 10u);
+    CHECK(std::string_view(static_cast<const char*>(mf.view(5u, 100u).data()), mf.view(5u, 100u).size()) == "World");
+    mf.advise(pio::mapped_file::advice::random);
+
+    // through the same interface as the file
+    pio::concepts::sync_random_access_read_device & sync = mf;
+    char buf[10];
+    CHECK(pio::read_at(sync, 0u, asio::buffer(buf, 5)) == 5u);
+    CHECK(std::string_view(buf, 5) == "Hello");
+
+    std::error_code ec;
+    CHECK(sync.read_some_at(10u, asio::buffer(buf), ec) == 0u);
+    CHECK(ec == asio::error::eof);
+
+    pio::concepts::async_random_access_read_device & async = mf;
+    std::size_t read = 0u;
+    async.async_read_some_at(2u, asio::buffer(buf), [&](std::error_code ec, std::size_t n) {CHECK(!ec); read = n;});
+    CHECK(read == 0u);
+    ctx.run();
+    CHECK(read == 8u);
+    CHECK(std::string_view(buf, 8) == "lloWorld");
+
+    // grow the file
+    pio::write_at(f, 10u, asio::buffer("!", 1));
+    CHECK(mf.size() == 10u);
+    CHECK(mf.remap() == 11u);
+    CHECK(mf.view(10u, 1u).size() == 1u);
+
+    mf.close();
+    f.close();
+    std::filesystem::remove(path);
+}
+
+#endif
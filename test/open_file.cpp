@@ -0,0 +1,71 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+
+#include <pio.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <filesystem>
+
+#if !defined(ASIO_WINDOWS)
+
+TEST_CASE("async_open")
+{
+    asio::io_context ctx;
+    const auto path = (std::filesystem::current_path() / "pio_open_file_test").string();
+
+    std::error_code ec;
+    pio::random_access_file f{ctx.get_executor()};
+    pio::async_open_random_access_file(ctx.get_executor(), path,
+                                       pio::random_access_file::read_write | pio::random_access_file::create | pio::random_access_file::truncate,
+                                       [&](std::error_code e, pio::random_access_file res) {ec = e; f = std::move(res);});
+    ctx.run();
+    REQUIRE(!ec);
+    REQUIRE(f.is_open());
+    CHECK(f.write_some_at(0u, asio::buffer("0123456789", 10)) == 10u);
+
+    pio::file_status st;
+    pio::async_stat(f, [&](std::error_code e, pio::file_status res) {ec = e; st = res;});
+    ctx.restart();
+    ctx.run();
+    CHECK(!ec);
+    CHECK(st.type == std::filesystem::file_type::regular);
+    CHECK(st.size == 10u);
+
+    pio::async_close(f, [&](std::error_code e) {ec = e;});
+    CHECK(!f.is_open());
+    ctx.restart();
+    ctx.run();
+    CHECK(!ec);
+
+    pio::stream_file s{ctx.get_executor()};
+    pio::async_open_stream_file(ctx.get_executor(), path, pio::stream_file::read_only,
+                                [&](std::error_code e, pio::stream_file res) {ec = e; s = std::move(res);});
+    ctx.restart();
+    ctx.run();
+    REQUIRE(!ec);
+    char buf[10];
+    CHECK(pio::read(s, asio::buffer(buf)) == 10u);
+    s.close();
+
+    std::filesystem::remove(path);
+
+    pio::async_stat(ctx.get_executor(), path, [&](std::error_code e, pio::file_status) {ec = e;});
+    ctx.restart();
+    ctx.run();
+    CHECK(ec == std::errc::no_such_file_or_directory);
+
+    pio::async_open_stream_file(ctx.get_executor(), path, pio::stream_file::read_only,
+                                [&](std::error_code e, pio::stream_file res) {ec = e; CHECK(!res.is_open());});
+    ctx.restart();
+    ctx.run();
+    CHECK(ec == std::errc::no_such_file_or_directory);
+}
+
+#endif
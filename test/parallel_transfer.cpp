@@ -0,0 +1,77 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+#include "counting_allocator.hpp"
+
+#include <pio.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <filesystem>
+#include <string>
+
+TEST_CASE("parallel_transfer")
+{
+    asio::io_context ctx;
+    const auto path = (std::filesystem::temp_directory_path() / "pio_parallel_transfer").string();
+
+    std::string data;
+    for (int i = 0; i < 10000; i++)
+        data += std::to_string(i);
+
+    pio::random_access_file f{ctx.get_executor(), path, pio::random_access_file::read_write | pio::random_access_file::create | pio::random_access_file::truncate};
+
+    pio::parallel_transfer_options opts;
+    opts.chunk_size = 1000u;
+    opts.depth = 4u;
+
+    std::size_t written = 0u;
+    pio::async_parallel_write_at(f, 0u, asio::buffer(data), opts,
+                                 [&](std::error_code ec, std::size_t n) {CHECK(!ec); written = n;});
+    ctx.run();
+    CHECK(written == data.size());
+
+    std::string result(data.size(), '\0');
+    std::size_t read = 0u;
+    pio::async_parallel_read_at(f, 0u, asio::buffer(result), opts,
+                                [&](std::error_code ec, std::size_t n) {CHECK(!ec); read = n;});
+    ctx.restart();
+    ctx.run();
+    CHECK(read == data.size());
+    CHECK(result == data);
+
+    // the device ends in the middle of the third chunk.
+    std::string longer(data.size() + 2500u, '\0');
+    std::error_code error;
+    pio::async_parallel_read_at(f, data.size() - 2500u, asio::buffer(longer), opts,
+                                [&](std::error_code ec, std::size_t n) {error = ec; read = n;});
+    ctx.restart();
+    ctx.run();
+    CHECK(error == asio::error::eof);
+    CHECK(read == 2500u);
+    CHECK(longer.substr(0u, 2500u) == data.substr(data.size() - 2500u));
+
+    // the state & the chunks are allocated with the handler's allocator & released before it's invoked.
+    std::size_t live = 0u;
+    read = 0u;
+    pio::async_parallel_read_at(f, 0u, asio::buffer(result), opts,
+                                with_counting_allocator(live, [&](std::error_code ec, std::size_t n)
+                                {
+                                    CHECK(!ec);
+                                    CHECK(live == 0u);
+                                    read = n;
+                                }));
+    CHECK(live > 0u);
+    ctx.restart();
+    ctx.run();
+    CHECK(read == data.size());
+    CHECK(live == 0u);
+
+    f.close();
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+
+#include <pio.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <filesystem>
+#include <string>
+
+TEST_CASE("prefetching_read_stream")
+{
+    asio::io_context ctx;
+    const auto path = (std::filesystem::temp_directory_path() / "pio_prefetching_read_stream").string();
+
+    std::string data;
+    for (int i = 0; i < 1000; i++)
+        data += std::to_string(i);
+
+    pio::random_access_file f{ctx.get_executor(), path, pio::random_access_file::read_write | pio::random_access_file::create | pio::random_access_file::truncate};
+    pio::write_at(f, 0u, asio::buffer(data));
+
+    pio::prefetching_read_stream::options opts;
+    opts.block_size = 64u;
+    opts.min_depth = 1u;
+    opts.max_depth = 8u;
+    pio::prefetching_read_stream s{f, 10u, opts};
+    CHECK(s.depth() == 1u);
+
+    std::string result(data.size() - 10u, '\0');
+    std::size_t read = 0u;
+    pio::async_read(s, asio::buffer(result), [&](std::error_code ec, std::size_t n) {CHECK(!ec); read = n;});
+    ctx.run();
+    CHECK(read == result.size());
+    CHECK(result == data.substr(10u));
+    CHECK(s.position() == data.size());
+    CHECK(s.depth() >= 1u);
+    CHECK(s.depth() <= 8u);
+
+    std::error_code error;
+    char c;
+    s.async_read_some(asio::buffer(&c, 1u), [&](std::error_code ec, std::size_t) {error = ec;});
+    ctx.restart();
+    ctx.run();
+    CHECK(error == asio::error::eof);
+
+    f.close();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("prefetching_read_stream destroyed with a pending read")
+{
+    asio::io_context ctx;
+    const auto path = (std::filesystem::temp_directory_path() / "pio_prefetching_read_stream_destroy").string();
+    const std::string data(256u, 'x');
+
+    pio::random_access_file f{ctx.get_executor(), path, pio::random_access_file::read_write | pio::random_access_file::create | pio::random_access_file::truncate};
+    pio::write_at(f, 0u, asio::buffer(data));
+
+    std::error_code error;
+    bool called = false;
+    char c;
+    {
+        pio::prefetching_read_stream s{f};
+        // nothing is fetched before the context runs, so the read is pending.
+        s.async_read_some(asio::buffer(&c, 1u), [&](std::error_code ec, std::size_t) {error = ec; called = true;});
+    }
+    ctx.run();
+    CHECK(called);
+    CHECK(error == asio::error::operation_aborted);
+
+    f.close();
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,33 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "pio/recycling_allocator.hpp"
+
+#include "doctest.h"
+
+#include <thread>
+
+TEST_CASE("recycling_allocator")
+{
+    pio::recycling_allocator<char> alloc;
+
+    auto p = alloc.allocate(100u);
+    alloc.deallocate(p, 100u);
+
+    // same size class, same thread -> same block
+    auto q = alloc.allocate(128u);
+    CHECK(p == q);
+
+    // freeing on another thread is fine, it goes into that thread's cache.
+    std::thread([&]{ alloc.deallocate(q, 128u); }).join();
+
+    auto large = alloc.allocate(1024u * 1024u);
+    alloc.deallocate(large, 1024u * 1024u);
+
+    CHECK(pio::recycling_resource()->is_equal(*pio::recycling_resource()));
+    CHECK(alloc == pio::recycling_allocator<int>{});
+}
@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+
+#include <pio/registered_buffer_pool.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <cstring>
+#include <limits>
+#include <system_error>
+#include <vector>
+
+TEST_CASE("registered_buffer_pool")
+{
+    asio::io_context ctx;
+    pio::registered_buffer_pool pool{ctx, 5000u, 4u};
+
+    CHECK(pool.block_size() == 8192u);
+    CHECK(pool.block_count() == 4u);
+
+    std::vector<pio::registered_buffer> leased;
+    for (std::size_t i = 0u; i < 4u; i++)
+    {
+        auto b = pool.allocate();
+        REQUIRE(b);
+        CHECK(b.size() == 8192u);
+        CHECK(pool.owns(b.data(), b.size()));
+        leased.push_back(std::move(b));
+    }
+    CHECK(pool.available() == 0u);
+    CHECK(!pool.allocate());
+
+    auto p = static_cast<char*>(leased.front().data());
+    // inside one block
+    CHECK(pool.find(p + 100, 4096u));
+    CHECK(pio::detail::find_registered_buffer(ctx.get_executor(), pio::mutable_buffer(p + 100, 4096u)));
+    // the slab is one registered buffer, so straddling two blocks is fine.
+    CHECK(pool.find(p + 8000, 4096u));
+    auto last = static_cast<char*>(leased.back().data());
+    CHECK(!pool.find(last + 8000, 4096u));
+
+    char other[64];
+    CHECK(!pool.owns(other, sizeof(other)));
+    CHECK(!pio::detail::find_registered_buffer(ctx.get_executor(), pio::mutable_buffer(other, sizeof(other))));
+
+    asio::io_context ctx2;
+    CHECK(!pio::detail::find_registered_buffer(ctx2.get_executor(), pio::mutable_buffer(p, 16u)));
+
+    leased.front().release();
+    CHECK(pool.available() == 1u);
+    leased.clear();
+    CHECK(pool.available() == 4u);
+}
+
+TEST_CASE("registered_buffer_pool more blocks than UIO_MAXIOV")
+{
+    asio::io_context ctx;
+    pio::registered_buffer_pool pool{ctx, 4096u, 2048u};
+
+    std::vector<pio::registered_buffer> leased;
+    for (std::size_t i = 0u; i < pool.block_count(); i++)
+        leased.push_back(pool.allocate());
+    REQUIRE(leased.back());
+
+    auto r = leased.back().registered();
+    CHECK(r.data() == leased.back().data());
+    CHECK(r.size() == 4096u);
+    CHECK(pio::detail::find_registered_buffer(ctx.get_executor(), leased.back().buffer()));
+}
+
+TEST_CASE("registered_buffer_pool invalid sizes")
+{
+    asio::io_context ctx;
+    CHECK_THROWS_AS(pio::registered_buffer_pool(ctx, 4096u, 0u), std::system_error);
+    CHECK_THROWS_AS(pio::registered_buffer_pool(ctx, 0u, 4u), std::system_error);
+    CHECK_THROWS_AS(pio::registered_buffer_pool(ctx, (std::size_t(1u) << 30u) + 1u, 1u), std::system_error);
+    CHECK_THROWS_AS(pio::registered_buffer_pool(ctx, 4096u, std::numeric_limits<std::size_t>::max() / 2048u),
+                    std::system_error);
+}
@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+
+#include <pio.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if !defined(ASIO_WINDOWS)
+
+namespace
+{
+
+std::string_view view(pio::const_buffer cb)
+{
+    return std::string_view(static_cast<const char*>(cb.data()), cb.size());
+}
+
+}
+
+TEST_CASE("ring_buffer")
+{
+    pio::ring_buffer ring{100u};
+    const auto cap = ring.capacity();
+    CHECK(cap >= 100u);
+    CHECK(ring.max_size() == cap);
+
+    SUBCASE("wrap around")
+    {
+        // move the head close to the end.
+        ring.commit(ring.prepare(cap - 4u).size());
+        ring.consume(cap - 6u);
+        CHECK(ring.size() == 2u);
+
+        auto prepared = ring.prepare(8u);
+        std::memcpy(prepared.data(), "01234567", 8u);
+        ring.commit(8u);
+        CHECK(ring.size() == 10u);
+        // the bytes past the end show up at the beginning of the ring.
+        CHECK(view(ring.data()).substr(2u) == "01234567");
+        CHECK(view(ring.data(4u, 4u)) == "2345");
+
+        ring.consume(6u);
+        CHECK(view(ring.data()) == "4567");
+        CHECK_THROWS_AS(ring.prepare(cap), std::length_error);
+
+        ring.clear();
+        CHECK(ring.size() == 0u);
+        CHECK(ring.data().size() == 0u);
+    }
+
+    SUBCASE("move")
+    {
+        ring.commit(ring.prepare(3u).size());
+        pio::ring_buffer moved{std::move(ring)};
+        CHECK(moved.size() == 3u);
+        CHECK(moved.capacity() == cap);
+        CHECK(ring.capacity() == 0u);
+    }
+
+    SUBCASE("pipe")
+    {
+        asio::io_context ctx;
+        pio::readable_pipe r{ctx};
+        pio::writable_pipe w{ctx};
+        pio::connect_pipe(r, w);
+
+        ring.commit(ring.prepare(cap - 2u).size());
+        ring.consume(cap - 2u);
+
+        CHECK(pio::write(w, asio::buffer("hello world", 11)) == 11u);
+        CHECK(pio::read(r, ring, asio::transfer_exactly(5u)) == 5u);
+        CHECK(view(ring.data()) == "hello");
+
+        std::size_t read = 0u;
+        pio::async_read(r, ring, asio::transfer_exactly(6u),
+                        [&](std::error_code ec, std::size_t n)
+                        {
+                            CHECK(!ec);
+                            read = n;
+                        });
+        ctx.run();
+        CHECK(read == 6u);
+        CHECK(view(ring.data()) == "hello world");
+    }
+}
+
+#endif
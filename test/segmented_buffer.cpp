@@ -0,0 +1,93 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+
+#include <pio.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <string>
+
+namespace
+{
+
+std::string to_string(const pio::segmented_buffer & buf)
+{
+    std::string res(buf.size(), '\0');
+    asio::buffer_copy(asio::buffer(res), buf.data());
+    return res;
+}
+
+}
+
+TEST_CASE("segmented_buffer")
+{
+    pio::segmented_buffer buf{8u};
+
+    SUBCASE("prepare & consume")
+    {
+        auto prepared = buf.prepare(20u);
+        CHECK(prepared.size() == 3u);
+        CHECK(asio::buffer_size(prepared) == 20u);
+        CHECK(buf.capacity() == 24u);
+
+        CHECK(asio::buffer_copy(prepared, asio::buffer("0123456789abcdefghij", 20)) == 20u);
+        buf.commit(20u);
+        CHECK(buf.size() == 20u);
+        CHECK(buf.data().size() == 3u);
+        CHECK(to_string(buf) == "0123456789abcdefghij");
+
+        buf.consume(10u);
+        CHECK(buf.data().size() == 2u);
+        CHECK(to_string(buf) == "abcdefghij");
+        CHECK(buf.capacity() == 22u);
+
+        // the consumed segment gets reused
+        buf.prepare(8u);
+        CHECK(buf.capacity() == 22u);
+
+        buf.consume(10u);
+        CHECK(buf.size() == 0u);
+        CHECK(buf.data().empty());
+        buf.shrink_to_fit();
+        CHECK(buf.capacity() == 0u);
+    }
+
+    SUBCASE("max_size")
+    {
+        pio::segmented_buffer limited{8u, 10u};
+        CHECK_THROWS_AS(limited.prepare(11u), std::length_error);
+        CHECK(asio::buffer_size(limited.prepare(10u)) == 10u);
+    }
+
+    SUBCASE("pipe")
+    {
+        asio::io_context ctx;
+        pio::readable_pipe r{ctx};
+        pio::writable_pipe w{ctx};
+        pio::connect_pipe(r, w);
+
+        CHECK(pio::write(w, asio::buffer("0123456789abcdefghij", 20)) == 20u);
+        CHECK(pio::read(r, buf, asio::transfer_exactly(20u)) == 20u);
+        CHECK(to_string(buf) == "0123456789abcdefghij");
+
+        CHECK(pio::write(w, buf) == 20u);
+        CHECK(buf.size() == 0u);
+
+        std::size_t read = 0u;
+        pio::async_read(r, buf, asio::transfer_exactly(20u),
+                        [&](std::error_code ec, std::size_t n)
+                        {
+                            CHECK(!ec);
+                            read = n;
+                        });
+        ctx.run();
+        CHECK(read == 20u);
+        CHECK(to_string(buf) == "0123456789abcdefghij");
+    }
+}
@@ -0,0 +1,93 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+
+#include <pio.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <array>
+#include <string>
+#include <string_view>
+
+namespace
+{
+
+std::string_view view(pio::const_buffer cb)
+{
+    return std::string_view(static_cast<const char*>(cb.data()), cb.size());
+}
+
+}
+
+TEST_CASE("shared_buffer")
+{
+    pio::shared_buffer empty;
+    CHECK(empty.empty());
+    CHECK(empty.use_count() == 0u);
+
+    for (auto t : {pio::shared_buffer::threading::single, pio::shared_buffer::threading::multi})
+    {
+        std::string source = "hello world";
+        pio::shared_buffer buf{asio::buffer(source), t};
+        source.assign(source.size(), 'x');
+        CHECK(view(buf) == "hello world");
+        CHECK(buf.use_count() == 1u);
+
+        {
+            auto world = buf.slice(6u);
+            auto hell = buf.slice(0u, 4u);
+            CHECK(view(world) == "world");
+            CHECK(view(hell) == "hell");
+            CHECK(buf.use_count() == 3u);
+
+            auto moved = std::move(world);
+            CHECK(buf.use_count() == 3u);
+            CHECK(world.use_count() == 0u);
+
+            moved += 2u;
+            CHECK(view(moved) == "rld");
+            CHECK(view(buf.slice(20u)).empty());
+        }
+        CHECK(buf.use_count() == 1u);
+    }
+}
+
+TEST_CASE("shared_buffer fan-out")
+{
+    asio::io_context ctx;
+    std::array<pio::readable_pipe, 4> readers{pio::readable_pipe{ctx}, pio::readable_pipe{ctx},
+                                              pio::readable_pipe{ctx}, pio::readable_pipe{ctx}};
+    std::array<pio::writable_pipe, 4> writers{pio::writable_pipe{ctx}, pio::writable_pipe{ctx},
+                                              pio::writable_pipe{ctx}, pio::writable_pipe{ctx}};
+    for (std::size_t i = 0u; i < readers.size(); i++)
+        pio::connect_pipe(readers[i], writers[i]);
+
+    std::size_t written = 0u;
+    {
+        pio::shared_buffer payload{asio::buffer("payload", 7), pio::shared_buffer::threading::single};
+        for (auto & w : writers)
+            pio::async_write(w, payload,
+                             [&](std::error_code ec, std::size_t n)
+                             {
+                                 CHECK(!ec);
+                                 written += n;
+                             });
+        // the writes hold the payload alive.
+        CHECK(payload.use_count() == writers.size() + 1u);
+    }
+    ctx.run();
+    CHECK(written == 7u * writers.size());
+
+    for (auto & r : readers)
+    {
+        std::array<char, 7> data;
+        CHECK(pio::read(r, asio::buffer(data)) == 7u);
+        CHECK(std::string_view(data.data(), data.size()) == "payload");
+    }
+}
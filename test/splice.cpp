@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+#include "counting_allocator.hpp"
+
+#include <pio.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <string_view>
+
+#if defined(__linux__)
+
+TEST_CASE("splice")
+{
+    asio::io_context ctx;
+    pio::readable_pipe r1{ctx}, r2{ctx};
+    pio::writable_pipe w1{ctx}, w2{ctx};
+    pio::connect_pipe(r1, w1);
+    pio::connect_pipe(r2, w2);
+
+    std::size_t spliced = 0u;
+    // starts waiting, since there's nothing in the source yet
+    pio::async_splice(r1, w2, 10u, [&](std::error_code ec, std::size_t n) {CHECK(!ec); spliced = n;});
+    ctx.poll();
+    CHECK(spliced == 0u);
+
+    pio::write(w1, asio::buffer("Hello", 5));
+    pio::write(w1, asio::buffer("World", 5));
+    ctx.run();
+    CHECK(spliced == 10u);
+
+    char buf[10];
+    CHECK(pio::read(r2, asio::buffer(buf)) == 10u);
+    CHECK(std::string_view(buf, 10) == "HelloWorld");
+
+    // the state is allocated with the handler's allocator, that survives the handler moving into it.
+    std::size_t live = 0u;
+    spliced = 0u;
+    pio::async_splice(r1, w2, 5u, with_counting_allocator(live, [&](std::error_code ec, std::size_t n)
+                                                          {
+                                                              CHECK(!ec);
+                                                              CHECK(live == 0u);
+                                                              spliced = n;
+                                                          }));
+    ctx.restart();
+    ctx.poll();
+    CHECK(live > 0u);
+    pio::write(w1, asio::buffer("Again", 5));
+    ctx.run();
+    CHECK(spliced == 5u);
+    CHECK(live == 0u);
+}
+
+TEST_CASE("tee")
+{
+    asio::io_context ctx;
+    pio::readable_pipe r1{ctx}, r2{ctx};
+    pio::writable_pipe w1{ctx}, w2{ctx};
+    pio::connect_pipe(r1, w1);
+    pio::connect_pipe(r2, w2);
+
+    pio::write(w1, asio::buffer("Data", 4));
+
+    std::size_t duplicated = 0u;
+    pio::async_tee(r1, w2, 64u, [&](std::error_code ec, std::size_t n) {CHECK(!ec); duplicated = n;});
+    ctx.run();
+    CHECK(duplicated == 4u);
+
+    // the source still holds the data
+    char a[4], b[4];
+    CHECK(pio::read(r1, asio::buffer(a)) == 4u);
+    CHECK(pio::read(r2, asio::buffer(b)) == 4u);
+    CHECK(std::string_view(a, 4) == "Data");
+    CHECK(std::string_view(b, 4) == "Data");
+}
+
+#endif
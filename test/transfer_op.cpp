@@ -0,0 +1,125 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+
+#include <pio/read.hpp>
+#include <pio/read_at.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <cstring>
+#include <optional>
+#include <vector>
+
+namespace
+{
+
+template<typename T>
+struct counting_allocator
+{
+    using value_type = T;
+    std::size_t * count;
+
+    counting_allocator(std::size_t * count) : count(count) {}
+    template<typename U>
+    counting_allocator(const counting_allocator<U> & other) : count(other.count) {}
+
+    T* allocate(std::size_t n)
+    {
+        ++*count;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, std::size_t n) { std::allocator<T>().deallocate(p, n); }
+
+    template<typename U>
+    bool operator==(const counting_allocator<U> & other) const {return count == other.count;}
+    template<typename U>
+    bool operator!=(const counting_allocator<U> & other) const {return count != other.count;}
+};
+
+struct counting_handler
+{
+    std::size_t * allocations;
+    std::optional<std::size_t> * result;
+
+    using allocator_type = counting_allocator<void>;
+    allocator_type get_allocator() const {return allocator_type{allocations};}
+
+    void operator()(std::error_code ec, std::size_t n)
+    {
+        CHECK(!ec);
+        *result = n;
+    }
+};
+
+// completes every intermediate operation with at most 4 KiB, driven manually by the test
+struct chunked_device final
+    : pio::concepts::implements<pio::concepts::async_read_stream, pio::concepts::async_random_access_read_device>
+{
+    asio::any_io_executor executor;
+    asio::mutable_buffer buffer;
+    std::optional<pio::read_handler> pending;
+    std::size_t operations = 0u;
+
+    chunked_device(asio::any_io_executor executor) : executor(std::move(executor)) {}
+    executor_type get_executor() override {return executor;}
+
+    void async_read_some_impl(const asio::mutable_buffer & b, pio::read_handler && h) override
+    {
+        buffer = b;
+        pending.emplace(std::move(h));
+    }
+
+    void async_read_some_at_impl(std::uint64_t, asio::mutable_buffer b, pio::read_handler && h) override
+    {
+        buffer = b;
+        pending.emplace(std::move(h));
+    }
+
+    void run()
+    {
+        while (pending)
+        {
+            auto h = std::move(*pending);
+            pending.reset();
+            const auto n = (std::min)(buffer.size(), std::size_t(4096u));
+            std::memset(buffer.data(), 'x', n);
+            operations++;
+            h(std::error_code{}, n);
+        }
+    }
+};
+
+}
+
+TEST_CASE("composed operations allocate once")
+{
+    asio::io_context ctx;
+    chunked_device dev{ctx.get_executor()};
+    std::vector<char> data(1024u * 1024u);
+
+    std::size_t allocations = 0u;
+    std::optional<std::size_t> result;
+
+    SUBCASE("async_read")
+    {
+        pio::async_read(dev, asio::buffer(data), counting_handler{&allocations, &result});
+    }
+
+    SUBCASE("async_read_at")
+    {
+        pio::async_read_at(dev, 0u, asio::buffer(data), counting_handler{&allocations, &result});
+    }
+
+    dev.run();
+
+    REQUIRE(result);
+    CHECK(*result == data.size());
+    CHECK(dev.operations == data.size() / 4096u);
+    CHECK(allocations == 1u);
+}
@@ -0,0 +1,73 @@
+//
+// Copyright (c) 2022 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "doctest.h"
+#include "counting_allocator.hpp"
+
+#include <pio.hpp>
+
+#include <asio/io_context.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+TEST_CASE("write_queue")
+{
+    asio::io_context ctx;
+    pio::readable_pipe r{ctx};
+    pio::writable_pipe w{ctx};
+    pio::connect_pipe(r, w);
+
+    SUBCASE("in order")
+    {
+        pio::write_queue q{w, 2u};
+        std::vector<std::size_t> written;
+        const pio::const_buffer parts[2] = {asio::buffer("de", 2), asio::buffer("fg", 2)};
+        q.async_write(asio::buffer("abc", 3), [&](std::error_code ec, std::size_t n) {CHECK(!ec); written.push_back(n);});
+        // the node & its copy of the buffers are allocated with the handler's allocator.
+        std::size_t live = 0u;
+        q.async_write(parts, with_counting_allocator(live, [&](std::error_code ec, std::size_t n) {CHECK(!ec); written.push_back(n);}));
+        CHECK(live > 0u);
+        q.async_write(asio::buffer("h", 1), [&](std::error_code ec, std::size_t n) {CHECK(!ec); written.push_back(n);});
+        ctx.run();
+        CHECK(live == 0u);
+
+        CHECK(written == std::vector<std::size_t>{3u, 4u, 1u});
+        char buf[8];
+        CHECK(pio::read(r, asio::buffer(buf)) == 8u);
+        CHECK(std::string_view(buf, 8) == "abcdefgh");
+    }
+
+    SUBCASE("threads")
+    {
+        pio::write_queue q{w};
+        constexpr int per_thread = 100;
+        std::atomic<int> done{0};
+        std::vector<std::thread> producers;
+        for (char c : std::string_view("abcd"))
+            producers.emplace_back(
+                [&, c]
+                {
+                    for (int i = 0; i < per_thread; i++)
+                        q.async_write(asio::buffer(&"abcd"[c - 'a'], 1),
+                                      [&](std::error_code ec, std::size_t n) {CHECK(!ec); CHECK(n == 1u); done++;});
+                });
+        for (auto & t : producers)
+            t.join();
+        ctx.run();
+        CHECK(done == 4 * per_thread);
+
+        std::string res(4 * per_thread, '\0');
+        CHECK(pio::read(r, asio::buffer(res)) == res.size());
+        for (char c : std::string_view("abcd"))
+            CHECK(std::count(res.begin(), res.end(), c) == per_thread);
+    }
+}